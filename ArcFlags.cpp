@@ -0,0 +1,145 @@
+//
+// Created by filip on 9.12.2025.
+//
+
+#include "ArcFlags.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <climits>
+#include <functional>
+#include <thread>
+using namespace std;
+
+// cells of about n / cellCount vertices, each grown by BFS over edges in both directions,
+// a finished component does not close the cell, it continues from the next unassigned vertex
+static vector<uint8_t> partition(const Graph& graph, const Graph& reverse, int cellCount) {
+    int n = graph.getSize();
+    const uint8_t UNASSIGNED = 0xff;
+    vector<uint8_t> cells(n, UNASSIGNED);
+    int cellSize = (n + cellCount - 1) / max(cellCount, 1);
+    vector<int> queue;
+    queue.reserve(n);
+    int cell = 0, filled = 0;
+    size_t head = 0;
+    for (int seed = 0; seed < n; seed++) {
+        if (cells[seed] != UNASSIGNED) continue;
+        queue.clear();
+        head = 0;
+        queue.push_back(seed);
+        cells[seed] = (uint8_t)cell;
+        filled++;
+        while (head < queue.size()) {
+            int u = queue[head++];
+            for (const Graph* side : {&graph, &reverse}) {
+                for (const Edge& edge : side->neighbors(u)) {
+                    if (cells[edge.to] != UNASSIGNED || filled == cellSize) continue;
+                    cells[edge.to] = (uint8_t)cell;
+                    filled++;
+                    queue.push_back(edge.to);
+                }
+            }
+            if (filled == cellSize) break;
+        }
+        if (filled == cellSize && cell + 1 < cellCount) {
+            cell++;
+            filled = 0;
+        }
+    }
+    return cells;
+}
+
+bool ArcFlags::build(const Graph& graph, int requestedCells, int threads) {
+    *this = ArcFlags();
+    if (graph.hasNegativeEdges()) return false;
+    n = graph.getSize();
+    edgeCount = graph.getEdgeCount();
+    version = graph.getVersion();
+    cellCount = max(1, min(MAX_CELLS, min(requestedCells, max(n, 1))));
+    Graph reverse = graph.reversed();
+    cells = partition(graph, reverse, cellCount);
+
+    firstEdge.assign((size_t)n + 1, 0);
+    for (int u = 0; u < n; u++) firstEdge[u + 1] = firstEdge[u] + graph.neighbors(u).size();
+    // cells are processed in parallel and set different bits of the same words
+    vector<atomic<uint64_t>> shared(firstEdge[n]);
+
+    // edges inside a cell lead into it, boundary vertices are entered from another cell
+    vector<vector<int>> boundary(cellCount);
+    for (int u = 0; u < n; u++) {
+        int index = 0;
+        for (const Edge& edge : graph.neighbors(u)) {
+            if (cells[u] == cells[edge.to]) shared[firstEdge[u] + index] |= 1ULL << cells[u];
+            index++;
+        }
+        for (const Edge& edge : reverse.neighbors(u)) {
+            if (cells[edge.to] != cells[u]) {
+                boundary[cells[u]].push_back(u);
+                break;
+            }
+        }
+    }
+    for (const auto& vertices : boundary) boundaryVertices += (long long)vertices.size();
+
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    threads = min(threads, cellCount);
+    vector<vector<int>> distances(threads, vector<int>(n, INT_MAX));
+    vector<vector<int>> settledLists(threads);
+    vector<vector<pair<int,int>>> heaps(threads);
+    {
+        ThreadPool pool(threads, cellCount);
+        for (int cell = 0; cell < cellCount; cell++) {
+            pool.submit([&, cell](int worker) {
+                uint64_t bit = 1ULL << cell;
+                vector<int>& dist = distances[worker];
+                vector<int>& settled = settledLists[worker];
+                auto& heap = heaps[worker];
+                for (int root : boundary[cell]) {
+                    // backward Dijkstra: dist[u] = d(u, root)
+                    dist[root] = 0;
+                    heap.push_back({0, root});
+                    while (!heap.empty()) {
+                        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                        auto [distance, u] = heap.back();
+                        heap.pop_back();
+                        if (distance > dist[u]) continue;
+                        settled.push_back(u);
+                        for (const Edge& edge : reverse.neighbors(u)) {
+                            int candidate = distance + edge.weight;
+                            if (candidate < dist[edge.to]) {
+                                dist[edge.to] = candidate;
+                                heap.push_back({candidate, edge.to});
+                                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                            }
+                        }
+                    }
+                    // every tight edge is on a shortest path to root (all of them, ties included)
+                    for (int u : settled) {
+                        int index = 0;
+                        for (const Edge& edge : graph.neighbors(u)) {
+                            if (dist[edge.to] != INT_MAX && (long long)dist[edge.to] + edge.weight == dist[u]) {
+                                atomic<uint64_t>& word = shared[firstEdge[u] + index];
+                                if (!(word.load(memory_order_relaxed) & bit)) word.fetch_or(bit, memory_order_relaxed);
+                            }
+                            index++;
+                        }
+                    }
+                    for (int u : settled) dist[u] = INT_MAX;
+                    settled.clear();
+                }
+            });
+        }
+        pool.wait();
+    }
+    flags.resize(shared.size());
+    for (size_t e = 0; e < shared.size(); e++) flags[e] = shared[e].load();
+    return true;
+}
+
+double ArcFlags::averageFlags() const {
+    if (flags.empty()) return 0;
+    long long bits = 0;
+    for (uint64_t word : flags) bits += (long long)bitset<64>(word).count();
+    return (double)bits / flags.size();
+}
@@ -0,0 +1,62 @@
+//
+// Created by filip on 9.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_ARCFLAGS_H
+#define PCC_SEMESTRALKA_ARCFLAGS_H
+#pragma once
+#include "Graph.h"
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+// arc flags - goal directed pruning for point-to-point Dijkstra (Dijkstra::query with flags)
+// 1. the vertices are split into at most 64 cells of about the same size, every cell grows by BFS
+//    over edges in both directions from the smallest unassigned vertex, so cells are connected regions
+// 2. edge (u, v) gets the bit of cell C if it lies on some shortest path into C:
+//    every boundary vertex b of C (a vertex of C entered by an edge from outside) runs a backward
+//    Dijkstra, every tight edge (d(u) = w + d(v)) of it gets the bit; edges inside C always have it
+// a query to a vertex of cell C relaxes only edges with the bit of C, the search stays in a narrow
+// corridor towards the target instead of a ball around the start, distances are exact
+// preprocessing is one backward search per boundary vertex (cells run in parallel), the flags
+// are valid only for the graph they were built for (same adjacency order), any change needs a rebuild,
+// until then matches() is false and Dijkstra::query falls back to the plain search
+class ArcFlags {
+private:
+    int n = 0;
+    long long edgeCount = 0;
+    uint64_t version = 0; // Graph::getVersion() at build time
+    int cellCount = 0;
+    vector<uint8_t> cells;      // cell of every vertex
+    vector<uint64_t> firstEdge; // flags of the edges of u = flags[firstEdge[u] ..], in Graph::neighbors order
+    vector<uint64_t> flags;     // bit c = edge is on a shortest path into cell c
+    long long boundaryVertices = 0;
+public:
+    static constexpr int MAX_CELLS = 64;
+
+    ArcFlags() = default;
+
+    // partition into cellCount cells (1 .. 64) and compute the flags with threads workers (0 = all cores)
+    // returns false (and no flags) for a graph with negative edges
+    bool build(const Graph& graph, int cellCount = 32, int threads = 0);
+
+    // true if the flags were built for this graph (or a copy of it) and no edge changed since
+    bool matches(const Graph& graph) const {
+        return cellCount > 0 && graph.getSize() == n && graph.getEdgeCount() == edgeCount &&
+               graph.getVersion() == version;
+    }
+
+    int cellOf(int vertex) const { return cells[vertex]; }
+    // flags of the index-th edge in graph.neighbors(u)
+    uint64_t edgeFlags(int u, int index) const { return flags[firstEdge[u] + index]; }
+
+    int getCellCount() const { return cellCount; }
+    long long getBoundaryVertices() const { return boundaryVertices; }
+    // average number of cells an edge is flagged for
+    double averageFlags() const;
+    size_t memoryBytes() const {
+        return cells.capacity() + (firstEdge.capacity() + flags.capacity()) * sizeof(uint64_t);
+    }
+};
+
+#endif //PCC_SEMESTRALKA_ARCFLAGS_H
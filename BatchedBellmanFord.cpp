@@ -0,0 +1,154 @@
+//
+// Created by filip on 14.11.2025.
+//
+
+#include "BatchedBellmanFord.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+using namespace std;
+
+#if defined(__GNUC__)
+// widest integer SIMD register the target has, lanes of one vertex are W ints in K / W registers
+#if defined(__AVX512F__)
+static const int W = 16;
+#elif defined(__AVX2__)
+static const int W = 8;
+#else
+static const int W = 4; // SSE2 / NEON
+#endif
+typedef int Vec __attribute__((vector_size(W * sizeof(int))));
+typedef unsigned UnsignedVec __attribute__((vector_size(W * sizeof(int))));
+
+// one batch of K sources, dist[v * K + lane]
+template <int K>
+static void relaxBatch(const Graph& graph, vector<int>& dist, vector<char>& cycle, SearchStats& counters) {
+    static_assert(K % W == 0 || W % K == 0, "lanes must be a multiple of the SIMD width");
+    const int CHUNKS = K >= W ? K / W : 1;
+    const auto& adjList = graph.getAdjList();
+    int n = graph.getSize();
+    Vec infinity, zero;
+    for (int l = 0; l < W; l++) {
+        infinity[l] = INT_MAX;
+        zero[l] = 0;
+    }
+
+    // K < W (8 lanes on AVX-512) uses only the first K ints of a register
+    int padded = CHUNKS * W;
+    vector<int> work((size_t)n * padded, INT_MAX);
+    for (int v = 0; v < n; v++) copy(&dist[(size_t)v * K], &dist[(size_t)v * K] + K, &work[(size_t)v * padded]);
+
+    Vec changed[CHUNKS];
+    Vec improvements[CHUNKS]; // per lane count of successful relaxations
+    for (int c = 0; c < CHUNKS; c++) changed[c] = improvements[c] = zero;
+
+    for (int pass = 0; pass < n; pass++) {
+        for (int c = 0; c < CHUNKS; c++) changed[c] = zero;
+        for (int u = 0; u < n; u++) {
+            const int* du = &work[(size_t)u * padded];
+            if (all_of(du, du + K, [](int d) { return d == INT_MAX; })) continue;
+            counters.verticesSettled++;
+
+            Vec from[CHUNKS], reached[CHUNKS];
+            for (int c = 0; c < CHUNKS; c++) {
+                memcpy(&from[c], du + c * W, sizeof(Vec));
+                reached[c] = from[c] != infinity; // -1 where lane has a distance
+            }
+            for (const Edge& edge : adjList[u]) {
+                counters.edgesRelaxed++;
+                int* dv = &work[(size_t)edge.to * padded];
+                for (int c = 0; c < CHUNKS; c++) {
+                    Vec to;
+                    memcpy(&to, dv + c * W, sizeof(Vec));
+                    // add in unsigned arithmetic (no signed overflow for INT_MAX lanes),
+                    // unreachable lanes must stay INT_MAX, so their candidate is masked to infinity
+                    Vec sum = (Vec)((UnsignedVec)from[c] + (unsigned)edge.weight);
+                    Vec candidate = (sum & reached[c]) | (infinity & ~reached[c]);
+                    Vec better = candidate < to;
+                    Vec result = (candidate & better) | (to & ~better);
+                    memcpy(dv + c * W, &result, sizeof(Vec));
+                    changed[c] |= better;
+                    improvements[c] -= better;
+                }
+            }
+        }
+        bool anyChanged = false;
+        for (int c = 0; c < CHUNKS; c++)
+            for (int l = 0; l < W; l++) anyChanged |= changed[c][l] != 0;
+        if (!anyChanged) break;
+    }
+    for (int l = 0; l < K; l++) {
+        // lanes still improving after V passes have a negative cycle
+        cycle[l] = changed[l / W][l % W] != 0;
+        counters.successfulRelaxations += improvements[l / W][l % W];
+    }
+    for (int v = 0; v < n; v++) copy(&work[(size_t)v * padded], &work[(size_t)v * padded] + K, &dist[(size_t)v * K]);
+}
+#else
+// portable variant, same algorithm lane by lane
+template <int K>
+static void relaxBatch(const Graph& graph, vector<int>& dist, vector<char>& cycle, SearchStats& counters) {
+    const auto& adjList = graph.getAdjList();
+    int n = graph.getSize();
+    char changed[K] = {};
+    for (int pass = 0; pass < n; pass++) {
+        fill(changed, changed + K, 0);
+        for (int u = 0; u < n; u++) {
+            const int* du = &dist[(size_t)u * K];
+            if (all_of(du, du + K, [](int d) { return d == INT_MAX; })) continue;
+            counters.verticesSettled++;
+            for (const Edge& edge : adjList[u]) {
+                counters.edgesRelaxed++;
+                int* dv = &dist[(size_t)edge.to * K];
+                for (int l = 0; l < K; l++) {
+                    if (du[l] != INT_MAX && du[l] + edge.weight < dv[l]) {
+                        dv[l] = du[l] + edge.weight;
+                        changed[l] = 1;
+                        counters.successfulRelaxations++;
+                    }
+                }
+            }
+        }
+        if (none_of(changed, changed + K, [](char c) { return c != 0; })) return;
+    }
+    for (int l = 0; l < K; l++) cycle[l] = changed[l];
+}
+#endif
+
+// run all batches with K lanes
+template <int K>
+static vector<string> runLanes(const Graph& graph, const vector<int>& sources, vector<vector<int>>& distances,
+                               SearchStats& counters) {
+    int n = graph.getSize();
+    vector<string> statuses(sources.size());
+    distances.assign(sources.size(), vector<int>());
+    vector<int> dist((size_t)n * K);
+    vector<char> cycle(K);
+
+    for (size_t first = 0; first < sources.size(); first += K) {
+        int batch = static_cast<int>(min<size_t>(K, sources.size() - first));
+        fill(dist.begin(), dist.end(), INT_MAX);
+        fill(cycle.begin(), cycle.end(), 0);
+        // unused lanes of the last batch stay unreachable and cost nothing extra
+        for (int l = 0; l < batch; l++) dist[(size_t)sources[first + l] * K + l] = 0;
+
+        relaxBatch<K>(graph, dist, cycle, counters);
+
+        for (int l = 0; l < batch; l++) {
+            vector<int>& lane = distances[first + l];
+            lane.resize(n);
+            for (int v = 0; v < n; v++) lane[v] = dist[(size_t)v * K + l];
+            statuses[first + l] = cycle[l] ? "Negative weight cycle detected" : "OK";
+        }
+    }
+    return statuses;
+}
+
+vector<string> BatchedBellmanFord::run(const Graph& graph, const vector<int>& sources, vector<vector<int>>& distances,
+                                       int lanes, SearchStats* stats) {
+    SearchStats counters;
+    vector<string> statuses = lanes == 16 ? runLanes<16>(graph, sources, distances, counters)
+                                          : runLanes<8>(graph, sources, distances, counters);
+    if (stats) stats->add(counters);
+    return statuses;
+}
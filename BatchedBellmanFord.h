@@ -0,0 +1,29 @@
+//
+// Created by filip on 14.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_BATCHEDBELLMANFORD_H
+#define PCC_SEMESTRALKA_BATCHEDBELLMANFORD_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// Bellman-Ford from many sources at once
+// sources are processed in batches of 8 or 16 "lanes", every vertex stores the distances of all lanes
+// next to each other, so one edge is read once per pass and relaxed for all lanes with one
+// vector min/add (GCC/Clang vector extensions, plain loop elsewhere)
+// results are identical to BellmanFord::run for every single source
+// stats count one relaxed edge per batch, successful relaxations per lane
+class BatchedBellmanFord {
+public:
+    // distances[i] - distances from sources[i] (INT_MAX = unreachable)
+    // returns status per source: "OK" or "Negative weight cycle detected"
+    // lanes - 8 or 16, other values fall back to 8
+    static vector<string> run(const Graph& graph, const vector<int>& sources, vector<vector<int>>& distances,
+                              int lanes = 8, SearchStats* stats = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_BATCHEDBELLMANFORD_H
@@ -10,18 +10,21 @@
 #include <chrono>
 #include "Graph.h"
 #include <iostream>
+#include <deque>
+#include <memory>
 using namespace std;
 
 
 
 //we will relax all edges V-1 times
 //then we will check for negative weight cycles
-pair<string,int> BellmanFord::shortestPath(const Graph& graph, int start, int end) {
-    auto startTime = std::chrono::high_resolution_clock::now(); // start timing
-
-    vector<int> distances(graph.getSize(), INT_MAX);
+// run() for Graph and CompressedGraph, edges come from graph.neighbors(u)
+template <class G>
+static bool relaxAll(const G& graph, int start, vector<int>& distances, vector<int>& parent, SearchStats* stats) {
+    distances.assign(graph.getSize(), INT_MAX);
     distances[start] = 0;
-    vector<int> parent(graph.getSize(), -1);
+    parent.assign(graph.getSize(), -1);
+    SearchStats counters;
 
     //relaxation of all edges V-1 times, where V is number of vertices
     //for each vertex we will check all its neighbors and relax the edges
@@ -29,24 +32,226 @@ pair<string,int> BellmanFord::shortestPath(const Graph& graph, int start, int en
     //else do nothing
     for (int i = 1; i < graph.getSize(); i++) {
         for (int u = 0; u < graph.getSize(); u++) {
-            for (auto edge : graph.getNeighbors(u)) {
-                if (edge.first == -1) continue;
-                if (distances[u] != INT_MAX && distances[edge.first] > distances[u] + edge.second) {
-                    distances[edge.first] = distances[u] + edge.second;
-                    parent[edge.first] = u;
+            if (distances[u] != INT_MAX) counters.verticesSettled++;
+            for (const Edge& edge : graph.neighbors(u)) {
+                counters.edgesRelaxed++;
+                if (distances[u] != INT_MAX && distances[edge.to] > distances[u] + edge.weight) {
+                    distances[edge.to] = distances[u] + edge.weight;
+                    parent[edge.to] = u;
+                    counters.successfulRelaxations++;
                 }
             }
         }
     }
+    if (stats) stats->add(counters);
     //check for negative weight cycles
     for (int u = 0; u < graph.getSize(); u++) {
-        for (auto edge : graph.getNeighbors(u)) {
-            if (edge.first == -1) continue;
-            if (distances[u] != INT_MAX && distances[edge.first] > distances[u] + edge.second) {
-                return {"Negative weight cycle detected", -1};
+        for (const Edge& edge : graph.neighbors(u)) {
+            if (distances[u] != INT_MAX && distances[edge.to] > distances[u] + edge.weight) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool BellmanFord::run(const Graph& graph, int start, vector<int>& distances, vector<int>& parent, SearchStats* stats) {
+    return relaxAll(graph, start, distances, parent, stats);
+}
+
+bool BellmanFord::run(const CompressedGraph& graph, int start, vector<int>& distances, vector<int>& parent,
+                      SearchStats* stats) {
+    return relaxAll(graph, start, distances, parent, stats);
+}
+
+// weight of the cheapest edge u -> v
+static int cheapestEdge(const Graph& graph, int u, int v) {
+    int best = INT_MAX;
+    for (const Edge& edge : graph.getAdjList()[u]) {
+        if (edge.to == v) best = min(best, edge.weight);
+    }
+    return best;
+}
+
+// cycle through v in the parent graph, edges go parent -> child
+static void extractCycle(const Graph& graph, int v, const vector<int>& parent, NegativeCycle& cycle) {
+    cycle.vertices.clear();
+    cycle.weight = 0;
+    int u = v;
+    do {
+        cycle.vertices.push_back(u);
+        u = parent[u];
+    } while (u != v);
+    reverse(cycle.vertices.begin(), cycle.vertices.end());
+    for (size_t i = 0; i < cycle.vertices.size(); i++) {
+        cycle.weight += cheapestEdge(graph, cycle.vertices[i], cycle.vertices[(i + 1) % cycle.vertices.size()]);
+    }
+}
+
+// walk parent pointers from every vertex, returns a vertex on a parent cycle or -1
+// walk[v] = number of the walk that visited v, one pass over all vertices is O(V)
+static int findParentCycle(const vector<int>& parent, vector<int>& walk) {
+    int n = static_cast<int>(parent.size());
+    fill(walk.begin(), walk.end(), -1);
+    for (int s = 0; s < n; s++) {
+        int v = s;
+        while (v != -1 && walk[v] == -1) {
+            walk[v] = s;
+            v = parent[v];
+        }
+        if (v != -1 && walk[v] == s) return v; // came back to the current walk
+    }
+    return -1;
+}
+
+bool BellmanFord::runWithCycle(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                               NegativeCycle& cycle, SearchStats* stats) {
+    const auto& adjList = graph.getAdjList();
+    int n = graph.getSize();
+    SearchStats counters;
+    // long long - on a negative cycle distances keep falling until the cycle is proven
+    vector<long long> dist(n, LLONG_MAX);
+    vector<int> edges(n, 0);     // number of edges of the walk that gave dist[v]
+    vector<char> queued(n, 0);
+    vector<int> walk(n);
+    deque<int> queue;
+    parent.assign(n, -1);
+    cycle = NegativeCycle();
+
+    for (int v = 0; v < n; v++) {
+        if (start >= 0 && v != start) continue;
+        dist[v] = 0;
+        queue.push_back(v);
+        queued[v] = 1;
+    }
+
+    int cycleVertex = -1;
+    long long sinceCheck = 0;
+    while (!queue.empty() && cycleVertex == -1) {
+        int u = queue.front();
+        queue.pop_front();
+        queued[u] = 0;
+        counters.verticesSettled++;
+        for (const Edge& edge : adjList[u]) {
+            counters.edgesRelaxed++;
+            if (dist[u] + edge.weight >= dist[edge.to]) continue;
+            dist[edge.to] = dist[u] + edge.weight;
+            parent[edge.to] = u;
+            edges[edge.to] = edges[u] + 1;
+            counters.successfulRelaxations++;
+            // a walk of n edges repeats a vertex - likely a cycle, check right away
+            if (++sinceCheck >= n || edges[edge.to] >= n) {
+                sinceCheck = 0;
+                cycleVertex = findParentCycle(parent, walk);
+                if (cycleVertex != -1) break;
+            }
+            if (!queued[edge.to]) {
+                queued[edge.to] = 1;
+                queue.push_back(edge.to);
             }
         }
     }
+    if (stats) stats->add(counters);
+
+    if (cycleVertex != -1) {
+        extractCycle(graph, cycleVertex, parent, cycle);
+        return false;
+    }
+    distances.assign(n, INT_MAX);
+    for (int v = 0; v < n; v++) {
+        if (dist[v] != LLONG_MAX) distances[v] = static_cast<int>(dist[v]);
+    }
+    return true;
+}
+
+// query() for Graph and CompressedGraph
+// vertices - only these vertices are scanned (everything reachable from start), nullptr = all vertices
+template <class G>
+static QueryResult passQuery(const G& graph, int start, int end, SearchWorkspace& workspace, SearchStats* stats,
+                             const vector<int>* vertices = nullptr) {
+    QueryResult result;
+    int n = graph.getSize();
+    int scanned = vertices ? (int)vertices->size() : n;
+    SearchStats counters;
+    workspace.reset(n);
+    workspace.update(start, 0, -1);
+
+    // after V-1 passes distances are final, one more changing pass means negative cycle
+    bool changed = true;
+    for (int pass = 0; pass < scanned && changed; pass++) {
+        changed = false;
+        for (int i = 0; i < scanned; i++) {
+            int u = vertices ? (*vertices)[i] : i;
+            int du = workspace.distance(u);
+            if (du == INT_MAX) continue;
+            counters.verticesSettled++;
+            for (const Edge& edge : graph.neighbors(u)) {
+                counters.edgesRelaxed++;
+                if (du + edge.weight < workspace.distance(edge.to)) {
+                    workspace.update(edge.to, du + edge.weight, u);
+                    counters.successfulRelaxations++;
+                    changed = true;
+                }
+            }
+        }
+    }
+    if (stats) stats->add(counters);
+
+    if (changed) {
+        result.status = "Negative weight cycle detected";
+    } else if (end < 0) {
+        result.status = "OK";
+    } else if (workspace.distance(end) == INT_MAX) {
+        result.status = "Unreachable";
+    } else {
+        result.status = "OK";
+        result.distance = workspace.distance(end);
+        result.path = workspace.pathTo(end);
+    }
+    return result;
+}
+
+QueryResult BellmanFord::query(const Graph& graph, int start, int end, SearchWorkspace& workspace, SearchStats* stats) {
+    return passQuery(graph, start, end, workspace, stats);
+}
+
+QueryResult BellmanFord::query(const CompressedGraph& graph, int start, int end, SearchWorkspace& workspace,
+                               SearchStats* stats) {
+    return passQuery(graph, start, end, workspace, stats);
+}
+
+QueryResult BellmanFord::query(const Graph& graph, const ReachabilityIndex& index, int start, int end,
+                               SearchWorkspace& workspace, SearchStats* stats) {
+    if (!index.matches(graph) || start < 0 || start >= graph.getSize()) return passQuery(graph, start, end, workspace, stats);
+    if (end >= 0 && !index.reachable(start, end)) {
+        QueryResult result;
+        result.status = "Unreachable";
+        return result;
+    }
+    vector<int> vertices = index.reachableFrom(start);
+    return passQuery(graph, start, end, workspace, stats, &vertices);
+}
+
+pair<string,int> BellmanFord::shortestPath(const Graph& graph, int start, int end, SearchStats* stats,
+                                           HardwareCounters* counters) {
+    auto startTime = std::chrono::high_resolution_clock::now(); // start timing
+
+    vector<int> distances;
+    vector<int> parent;
+    NegativeCycle cycle;
+    unique_ptr<PerfCounters> perf;
+    if (counters) {
+        perf = make_unique<PerfCounters>();
+        perf->start();
+    }
+    bool noCycle = runWithCycle(graph, start, distances, parent, cycle, stats);
+    if (perf) *counters = perf->stop();
+    if (!noCycle) {
+        cout << "Negative cycle:";
+        for (int v : cycle.vertices) cout << " " << v;
+        cout << " " << cycle.vertices[0] << " (weight " << cycle.weight << ")" << endl;
+        return {"Negative weight cycle detected", -1};
+    }
     auto endTime = std::chrono::high_resolution_clock::now(); // end timing
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
 
@@ -6,12 +6,55 @@
 #define COURSEWORK_BELLMANFORD_H
 #pragma once
 #include "Graph.h"
+#include "CompressedGraph.h"
+#include "PerfCounters.h"
+#include "ReachabilityIndex.h"
+#include "SearchWorkspace.h"
 #include <string>
 using namespace std;
 
+// negative cycle found by BellmanFord::runWithCycle
+struct NegativeCycle {
+    vector<int> vertices; // v0 v1 ... vk, edges v0 -> v1 -> ... -> vk -> v0
+    long long weight = 0; // sum of the (cheapest parallel) edge weights, always < 0
+};
+
 class BellmanFord {
 public:
-    static pair<string,int> shortestPath(const Graph& graph, int start, int end);
+    // search from start, prints path and time (or the negative cycle)
+    // returns status ("OK", "Unreachable", "Negative weight cycle detected") and distance to end
+    // counters get the hardware counters of the search alone, the output is not measured
+    static pair<string,int> shortestPath(const Graph& graph, int start, int end, SearchStats* stats = nullptr,
+                                         HardwareCounters* counters = nullptr);
+
+    // search core without any output - fills distances (INT_MAX = unreachable) and parent
+    // returns false if a negative weight cycle is reachable from start
+    static bool run(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                    SearchStats* stats = nullptr);
+    static bool run(const CompressedGraph& graph, int start, vector<int>& distances, vector<int>& parent,
+                    SearchStats* stats = nullptr);
+
+    // queue based Bellman-Ford (SPFA) that stops at the first negative cycle it can prove
+    // instead of finishing V-1 passes - every V relaxations (and whenever a walk reaches V edges)
+    // the parent graph is walked, any cycle in it is a negative cycle
+    // start = -1 searches the whole graph (every vertex is a source with distance 0)
+    // returns false and fills cycle if a negative cycle is reachable, distances/parent as in run() otherwise
+    static bool runWithCycle(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                             NegativeCycle& cycle, SearchStats* stats = nullptr);
+
+    // thread safe query without any output, buffers come from the caller's workspace
+    // stops early when a whole pass changes nothing (end = -1 returns just the status)
+    static QueryResult query(const Graph& graph, int start, int end, SearchWorkspace& workspace,
+                             SearchStats* stats = nullptr);
+    // run() and query() also take the varint encoded read only graph
+    static QueryResult query(const CompressedGraph& graph, int start, int end, SearchWorkspace& workspace,
+                             SearchStats* stats = nullptr);
+    // same passes over only the vertices reachable from start (index.reachableFrom), at most that many passes;
+    // components come in topological order, so acyclic parts settle in one pass
+    // an end that is not reachable is answered "Unreachable" without any pass (negative cycles are not
+    // looked for then), an index of another graph falls back to the plain query
+    static QueryResult query(const Graph& graph, const ReachabilityIndex& index, int start, int end,
+                             SearchWorkspace& workspace, SearchStats* stats = nullptr);
 };
 
 
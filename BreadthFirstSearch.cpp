@@ -0,0 +1,193 @@
+//
+// Created by filip on 20.11.2025.
+//
+
+#include "BreadthFirstSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <deque>
+#include <iostream>
+#include <memory>
+using namespace std;
+
+bool BreadthFirstSearch::run(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                             SearchStats* stats) {
+    if (!graph.hasUniformWeights()) return false;
+    const auto& adjList = graph.getAdjList();
+    int n = graph.getSize();
+    int weight = graph.getEdgeCount() > 0 ? graph.getMinWeight() : 0;
+    distances.assign(n, INT_MAX);
+    parent.assign(n, -1);
+    SearchStats counters;
+
+    // vertices are settled in the order they were discovered, the vector is the queue
+    vector<int> queue;
+    queue.reserve(n);
+    vector<char> visited(n, 0);
+    distances[start] = 0;
+    visited[start] = 1;
+    queue.push_back(start);
+    for (size_t head = 0; head < queue.size(); head++) {
+        int u = queue[head];
+        counters.verticesSettled++;
+        for (const Edge& edge : adjList[u]) {
+            counters.edgesRelaxed++;
+            if (visited[edge.to]) continue;
+            visited[edge.to] = 1;
+            distances[edge.to] = distances[u] + weight;
+            parent[edge.to] = u;
+            queue.push_back(edge.to);
+            counters.successfulRelaxations++;
+        }
+    }
+    if (stats) stats->add(counters);
+    return true;
+}
+
+bool BreadthFirstSearch::runZeroOne(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                                    SearchStats* stats) {
+    if (!graph.hasZeroOneWeights()) return false;
+    const auto& adjList = graph.getAdjList();
+    int n = graph.getSize();
+    distances.assign(n, INT_MAX);
+    parent.assign(n, -1);
+    SearchStats counters;
+
+    // deque holds at most two distances d and d + 1, so the front always has the smallest one
+    // a vertex may be pushed twice (lazy deletion as in the heap version), it is settled on the first pop
+    deque<int> queue;
+    vector<char> settled(n, 0);
+    distances[start] = 0;
+    queue.push_back(start);
+    while (!queue.empty()) {
+        int u = queue.front();
+        queue.pop_front();
+        if (settled[u]) continue;
+        settled[u] = 1;
+        counters.verticesSettled++;
+        for (const Edge& edge : adjList[u]) {
+            counters.edgesRelaxed++;
+            int candidate = distances[u] + edge.weight;
+            if (candidate >= distances[edge.to]) continue;
+            distances[edge.to] = candidate;
+            parent[edge.to] = u;
+            if (edge.weight == 0) queue.push_front(edge.to);
+            else queue.push_back(edge.to);
+            counters.successfulRelaxations++;
+        }
+    }
+    if (stats) stats->add(counters);
+    return true;
+}
+
+bool BreadthFirstSearch::runDirectionOptimizing(const Graph& graph, const Graph& reverse, int start,
+                                                vector<int>& distances, vector<int>& parent, SearchStats* stats) {
+    if (!graph.hasUniformWeights() || reverse.getSize() != graph.getSize()) return false;
+    const auto& adjList = graph.getAdjList();
+    const auto& inList = reverse.getAdjList();
+    int n = graph.getSize();
+    int weight = graph.getEdgeCount() > 0 ? graph.getMinWeight() : 0;
+    distances.assign(n, INT_MAX);
+    parent.assign(n, -1);
+    SearchStats counters;
+
+    // frontier is kept both as a list (top-down) and as a bitmap (bottom-up)
+    vector<int> frontier = {start}, next;
+    vector<char> inFrontier(n, 0), inNext(n, 0);
+    distances[start] = 0;
+    inFrontier[start] = 1;
+    long long unexploredEdges = graph.getEdgeCount() - (long long)adjList[start].size();
+    int level = 0;
+    bool bottomUp = false;
+
+    while (!frontier.empty()) {
+        long long frontierEdges = 0;
+        for (int u : frontier) frontierEdges += adjList[u].size();
+        // Beamer's heuristic, alpha = 14 and beta = 24
+        if (!bottomUp && frontierEdges > unexploredEdges / 14) bottomUp = true;
+        else if (bottomUp && (long long)frontier.size() < n / 24) bottomUp = false;
+
+        next.clear();
+        level++;
+        if (bottomUp) {
+            for (int v = 0; v < n; v++) {
+                if (distances[v] != INT_MAX) continue;
+                for (const Edge& edge : inList[v]) {
+                    counters.edgesRelaxed++;
+                    if (!inFrontier[edge.to]) continue;
+                    // first parent found is enough, the rest of the incoming edges is skipped
+                    distances[v] = level * weight;
+                    parent[v] = edge.to;
+                    next.push_back(v);
+                    inNext[v] = 1;
+                    counters.successfulRelaxations++;
+                    break;
+                }
+            }
+        } else {
+            for (int u : frontier) {
+                for (const Edge& edge : adjList[u]) {
+                    counters.edgesRelaxed++;
+                    if (distances[edge.to] != INT_MAX) continue;
+                    distances[edge.to] = level * weight;
+                    parent[edge.to] = u;
+                    next.push_back(edge.to);
+                    inNext[edge.to] = 1;
+                    counters.successfulRelaxations++;
+                }
+            }
+        }
+        counters.verticesSettled += frontier.size();
+        for (int u : frontier) inFrontier[u] = 0;
+        for (int v : next) unexploredEdges -= adjList[v].size();
+        swap(frontier, next);
+        swap(inFrontier, inNext);
+    }
+    if (stats) stats->add(counters);
+    return true;
+}
+
+pair<string,int> BreadthFirstSearch::shortestPath(const Graph& graph, int start, int end, const string& engine,
+                                                  SearchStats* stats, HardwareCounters* counters) {
+    auto startTime = chrono::high_resolution_clock::now();
+    vector<int> distances;
+    vector<int> parent;
+    const Graph backward = engine == "bfs-do" ? graph.reversed() : Graph(0);
+    unique_ptr<PerfCounters> perf;
+    if (counters) {
+        perf = make_unique<PerfCounters>();
+        perf->start();
+    }
+    bool fits;
+    if (engine == "bfs-01") fits = runZeroOne(graph, start, distances, parent, stats);
+    else if (engine == "bfs-do") fits = runDirectionOptimizing(graph, backward, start, distances, parent, stats);
+    else fits = run(graph, start, distances, parent, stats);
+    if (perf) *counters = perf->stop();
+    if (!fits) return {"Weights do not fit the engine", -1};
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::microseconds>(endTime - startTime).count();
+
+    if (distances[end] == INT_MAX) return {"Unreachable", -1};
+    vector<int> path;
+    for (int current = end; current != -1; current = parent[current]) path.push_back(current);
+    reverse(path.begin(), path.end());
+    cout << "Path: ";
+    for (auto v : path) {
+        cout << v << " ";
+    }
+    cout << endl;
+    cout << "Shortest distance from " << start << " to " << end << " is: " << distances[end] << endl;
+    cout << "BFS (" << engine << ") execution time: " << duration << " microseconds" << endl;
+    return {"OK", distances[end]};
+}
+
+string BreadthFirstSearch::chooseEngine(const Graph& graph, bool acyclic) {
+    if (graph.hasNegativeEdges()) return acyclic ? "dag" : "bellman";
+    if (graph.hasUniformWeights()) {
+        bool dense = graph.getSize() > 0 && graph.getEdgeCount() >= 8LL * graph.getSize();
+        return dense ? "bfs-do" : "bfs";
+    }
+    if (graph.hasZeroOneWeights()) return "bfs-01";
+    return acyclic ? "dag" : "dijkstra";
+}
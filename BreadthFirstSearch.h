@@ -0,0 +1,47 @@
+//
+// Created by filip on 20.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_BREADTHFIRSTSEARCH_H
+#define PCC_SEMESTRALKA_BREADTHFIRSTSEARCH_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// engines for graphs whose weight profile makes a heap unnecessary
+// - run:                   all weights equal (Graph::hasUniformWeights), FIFO queue, distance = hops * weight
+// - runZeroOne:            weights 0 or 1 (Graph::hasZeroOneWeights), deque - 0-edges to the front, 1-edges to the back
+// - runDirectionOptimizing: uniform weights, level by level; a level switches from top-down (scan edges of
+//                          the frontier) to bottom-up (every unvisited vertex looks for a parent in the frontier)
+//                          once the frontier has more edges than the rest of the graph / 14,
+//                          which pays off on low-diameter graphs where a few levels hold most vertices
+// all fill distances (INT_MAX = unreachable) and parent like Dijkstra::run and return false
+// if the weight profile does not fit the engine
+class BreadthFirstSearch {
+public:
+    static bool run(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                    SearchStats* stats = nullptr);
+
+    static bool runZeroOne(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                           SearchStats* stats = nullptr);
+
+    // reverse = graph.reversed(), bottom-up steps read incoming edges from it
+    static bool runDirectionOptimizing(const Graph& graph, const Graph& reverse, int start, vector<int>& distances,
+                                       vector<int>& parent, SearchStats* stats = nullptr);
+
+    // search from start with engine "bfs", "bfs-01" or "bfs-do", prints path and time
+    // returns status ("OK", "Unreachable", "Weights do not fit the engine") and distance to end
+    // counters get the hardware counters of the search alone, the output is not measured
+    static pair<string,int> shortestPath(const Graph& graph, int start, int end, const string& engine,
+                                         SearchStats* stats = nullptr, HardwareCounters* counters = nullptr);
+
+    // engine for the weight profile of graph: "bfs", "bfs-do" (direction-optimizing), "bfs-01",
+    // "dijkstra", "dag" or "bellman"
+    // bfs-do is chosen for uniform weights with average degree >= 8, dense graphs tend to have a low diameter
+    static string chooseEngine(const Graph& graph, bool acyclic);
+};
+
+#endif //PCC_SEMESTRALKA_BREADTHFIRSTSEARCH_H
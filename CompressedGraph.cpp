@@ -0,0 +1,61 @@
+//
+// Created by filip on 1.12.2025.
+//
+
+#include "CompressedGraph.h"
+#include <algorithm>
+#include <climits>
+using namespace std;
+
+static void writeVarint(vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+CompressedGraph::CompressedGraph(const Graph& graph) : n(graph.getSize()), edgeCount(graph.getEdgeCount()),
+                                                        negativeEdges(graph.hasNegativeEdges()) {
+    if (edgeCount > 0) {
+        minWeight = graph.getMinWeight();
+        uint32_t range = (uint32_t)graph.getMaxWeight() - (uint32_t)minWeight;
+        weightBytes = range <= 0xff ? 1 : range <= 0xffff ? 2 : 4;
+        weightMask = weightBytes == 4 ? 0xffffffffu : (1u << (8 * weightBytes)) - 1;
+    }
+    offsets.resize((size_t)n + 1);
+    // rough guess of 2 bytes per id, exact fit at the end
+    bytes.reserve((size_t)edgeCount * (2 + weightBytes));
+    vector<Edge> sorted;
+    for (int u = 0; u < n; u++) {
+        offsets[u] = bytes.size();
+        const auto& edges = graph.neighbors(u);
+        sorted.assign(edges.begin(), edges.end());
+        sort(sorted.begin(), sorted.end(), [](const Edge& a, const Edge& b) {
+            return a.to != b.to ? a.to < b.to : a.weight < b.weight;
+        });
+        for (size_t i = 0; i < sorted.size(); i++) {
+            if (i == 0) {
+                int delta = sorted[i].to - u;
+                writeVarint(bytes, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31)); // zigzag
+            } else {
+                writeVarint(bytes, (uint32_t)(sorted[i].to - sorted[i - 1].to));
+            }
+            uint32_t stored = (uint32_t)sorted[i].weight - (uint32_t)minWeight;
+            for (int b = 0; b < weightBytes; b++) bytes.push_back((uint8_t)(stored >> (8 * b)));
+        }
+    }
+    offsets[n] = bytes.size();
+    bytes.insert(bytes.end(), 3, 0); // padding, weights are read with a 4 byte load (see Iterator::decode)
+    bytes.shrink_to_fit();
+}
+
+Graph CompressedGraph::decompress() const {
+    vector<int> degrees(n, 0);
+    for (int u = 0; u < n; u++)
+        for (auto it = neighbors(u).begin(); it != neighbors(u).end(); ++it) degrees[u]++;
+    Graph graph(n, degrees);
+    for (int u = 0; u < n; u++)
+        for (const Edge& edge : neighbors(u)) graph.addEdge(u, edge.to, edge.weight);
+    return graph;
+}
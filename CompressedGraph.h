@@ -0,0 +1,118 @@
+//
+// Created by filip on 1.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_COMPRESSEDGRAPH_H
+#define PCC_SEMESTRALKA_COMPRESSEDGRAPH_H
+#pragma once
+#include "Graph.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+using namespace std;
+
+// read only compressed copy of a Graph for graphs that do not fit in memory as vector<vector<Edge>>
+// the edges of vertex u are one byte string bytes[offsets[u] .. offsets[u + 1]):
+// - neighbours are sorted by id, the first is stored as zigzag(to - u), the others as gap to the previous
+//   one, both as byte aligned varint (7 bits per byte, high bit = more bytes follow)
+// - after every id comes its weight - minWeight in 1, 2 or 4 bytes, the narrowest width that fits all weights
+// neighbours(u) decodes on the fly and yields Edge like Graph::neighbors, so the search engines
+// (Dijkstra::query, BellmanFord::run / query) take both graphs through the same loop
+// sorting changes the order of parallel edges, distances stay the same
+class CompressedGraph {
+private:
+    int n = 0;
+    long long edgeCount = 0;
+    bool negativeEdges = false;
+    int minWeight = 0;   // subtracted from every stored weight
+    int weightBytes = 1; // 1, 2 or 4
+    uint32_t weightMask = 0xff;
+    vector<uint64_t> offsets;
+    vector<uint8_t> bytes;
+
+public:
+    class Iterator {
+    private:
+        const uint8_t* position = nullptr; // encoded current edge
+        const uint8_t* next = nullptr;     // encoded edge after the current one
+        const uint8_t* end = nullptr;
+        const CompressedGraph* graph = nullptr;
+        int vertex = 0;
+        Edge edge = {0, 0};
+
+        static uint32_t readVarint(const uint8_t*& p) {
+            uint32_t value = *p++;
+            if (value < 0x80) return value; // most gaps fit in one byte
+            value &= 0x7f;
+            for (int shift = 7;; shift += 7) {
+                uint32_t byte = *p++;
+                value |= (byte & 0x7f) << shift;
+                if (byte < 0x80) return value;
+            }
+        }
+        void decode() {
+            if (position == end) return;
+            const uint8_t* p = position;
+            uint32_t code = readVarint(p);
+            if (position == graph->bytes.data() + graph->offsets[vertex]) {
+                int delta = (int)(code >> 1) ^ -(int)(code & 1); // zigzag
+                edge.to = vertex + delta;
+            } else {
+                edge.to += (int)code;
+            }
+            // one 4 byte load for every width (little endian hosts, the byte string has 3 bytes of padding)
+            uint32_t stored;
+            memcpy(&stored, p, sizeof(stored));
+            stored &= graph->weightMask;
+            edge.weight = (int)((uint32_t)graph->minWeight + stored);
+            next = p + graph->weightBytes;
+        }
+    public:
+        Iterator(const CompressedGraph* graph, int vertex, const uint8_t* position, const uint8_t* end)
+            : position(position), end(end), graph(graph), vertex(vertex) { decode(); }
+        Edge operator*() const { return edge; }
+        Iterator& operator++() {
+            position = next;
+            decode();
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return position != other.position; }
+        bool operator==(const Iterator& other) const { return position == other.position; }
+    };
+
+    // edges of one vertex, for (const Edge& edge : graph.neighbors(u))
+    class Range {
+    private:
+        const CompressedGraph* graph;
+        int vertex;
+    public:
+        Range(const CompressedGraph* graph, int vertex) : graph(graph), vertex(vertex) {}
+        Iterator begin() const {
+            const uint8_t* data = graph->bytes.data();
+            return Iterator(graph, vertex, data + graph->offsets[vertex], data + graph->offsets[vertex + 1]);
+        }
+        Iterator end() const {
+            const uint8_t* data = graph->bytes.data();
+            return Iterator(graph, vertex, data + graph->offsets[vertex + 1], data + graph->offsets[vertex + 1]);
+        }
+        bool empty() const { return graph->offsets[vertex] == graph->offsets[vertex + 1]; }
+    };
+
+    CompressedGraph() = default;
+    explicit CompressedGraph(const Graph& graph);
+
+    Range neighbors(int vertex) const { return Range(this, vertex); }
+
+    int getSize() const { return n; }
+    long long getEdgeCount() const { return edgeCount; }
+    bool hasNegativeEdges() const { return negativeEdges; }
+    int getWeightBytes() const { return weightBytes; }
+
+    // heap memory of the offsets and the byte string
+    size_t memoryBytes() const { return offsets.capacity() * sizeof(uint64_t) + bytes.capacity(); }
+
+    // uncompressed copy (neighbours sorted by id)
+    Graph decompress() const;
+};
+
+#endif //PCC_SEMESTRALKA_COMPRESSEDGRAPH_H
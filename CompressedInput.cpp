@@ -0,0 +1,210 @@
+//
+// Created by filip on 28.11.2025.
+//
+
+#include "CompressedInput.h"
+#include <chrono>
+#include <iostream>
+
+#ifdef PCC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PCC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+string CompressedInput::compression(const string& filename) {
+    ifstream fin(filename, ios::binary);
+    unsigned char magic[4] = {};
+    fin.read(reinterpret_cast<char*>(magic), 4);
+    if (fin.gcount() >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return "gzip";
+    if (fin.gcount() == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) return "zstd";
+    return "";
+}
+
+bool CompressedInput::isSupported(const string& compression) {
+#ifdef PCC_HAVE_ZLIB
+    if (compression == "gzip") return true;
+#endif
+#ifdef PCC_HAVE_ZSTD
+    if (compression == "zstd") return true;
+#endif
+    return false;
+}
+
+CompressedInput::CompressedInput(const string& filename) : file(filename, ios::binary), kind(compression(filename)) {
+    if (!file) { cerr << "Cannot open file " << filename << endl; exit(1); }
+    if (!isSupported(kind)) {
+        cerr << "File " << filename << " is " << (kind.empty() ? "not compressed" : kind + " compressed")
+             << ", but this build can not decompress it" << endl;
+        exit(1);
+    }
+    worker = thread(&CompressedInput::decompress, this);
+}
+
+CompressedInput::~CompressedInput() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+void CompressedInput::decompress() {
+    if (kind == "gzip") decompressGzip();
+    else decompressZstd();
+    lock_guard<mutex> guard(lock);
+    finished = true;
+    changed.notify_all();
+}
+
+bool CompressedInput::push(vector<char>&& block) {
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return stopping || ready.size() < QUEUE_BLOCKS; });
+    if (stopping) return false;
+    ready.push_back(move(block));
+    changed.notify_all();
+    return true;
+}
+
+bool CompressedInput::nextBlock(vector<char>& block) {
+    auto start = chrono::steady_clock::now();
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return finished || !ready.empty(); });
+    waited += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (ready.empty()) {
+        if (!error.empty()) { cerr << error << endl; exit(1); }
+        return false;
+    }
+    block = move(ready.front());
+    ready.pop_front();
+    changed.notify_all();
+    return true;
+}
+
+long long CompressedInput::compressedBytes() {
+    lock_guard<mutex> guard(lock);
+    return compressed;
+}
+
+CompressedInput::int_type CompressedInput::underflow() {
+    while (gptr() == egptr()) {
+        if (!nextBlock(current)) return traits_type::eof();
+        setg(current.data(), current.data(), current.data() + current.size());
+    }
+    return traits_type::to_int_type(*gptr());
+}
+
+void CompressedInput::decompressGzip() {
+#ifdef PCC_HAVE_ZLIB
+    z_stream stream = {};
+    // 15 + 32 - largest window, gzip or zlib header detected automatically
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        lock_guard<mutex> guard(lock);
+        error = "Cannot initialize zlib";
+        return;
+    }
+    vector<unsigned char> input(1 << 18);
+    vector<char> output(BLOCK_SIZE);
+    size_t used = 0;
+    bool endOfFile = false;
+    bool memberEnded = false; // gzip files can be several members in a row (cat a.gz b.gz)
+    while (true) {
+        if (stream.avail_in == 0 && !endOfFile) {
+            file.read(reinterpret_cast<char*>(input.data()), input.size());
+            stream.next_in = input.data();
+            stream.avail_in = (unsigned)file.gcount();
+            endOfFile = file.gcount() == 0;
+            lock_guard<mutex> guard(lock);
+            compressed += file.gcount();
+        }
+        stream.next_out = reinterpret_cast<unsigned char*>(output.data() + used);
+        stream.avail_out = (unsigned)(BLOCK_SIZE - used);
+        int result = inflate(&stream, Z_NO_FLUSH);
+        used = BLOCK_SIZE - stream.avail_out;
+
+        if (result == Z_STREAM_END) {
+            memberEnded = true;
+            inflateReset(&stream);
+        } else if (result == Z_OK) {
+            memberEnded = false;
+        } else if (result == Z_BUF_ERROR && endOfFile && stream.avail_in == 0) {
+            // no input left and nothing more to write
+            if (!memberEnded) {
+                lock_guard<mutex> guard(lock);
+                error = "Unexpected end of gzip data";
+            }
+            break;
+        } else if (result != Z_BUF_ERROR) {
+            lock_guard<mutex> guard(lock);
+            error = string("Corrupt gzip data: ") + (stream.msg ? stream.msg : "unknown error");
+            break;
+        }
+        if (used == BLOCK_SIZE) {
+            if (!push(move(output))) break;
+            output.assign(BLOCK_SIZE, 0);
+            used = 0;
+        }
+    }
+    if (used > 0 && error.empty()) {
+        output.resize(used);
+        push(move(output));
+    }
+    inflateEnd(&stream);
+#endif
+}
+
+void CompressedInput::decompressZstd() {
+#ifdef PCC_HAVE_ZSTD
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    ZSTD_initDStream(stream);
+    vector<char> input(ZSTD_DStreamInSize());
+    vector<char> output(BLOCK_SIZE);
+    ZSTD_inBuffer in = {input.data(), 0, 0};
+    size_t used = 0;
+    size_t lastResult = 0; // 0 once a frame is complete
+    bool endOfFile = false;
+    while (true) {
+        if (in.pos == in.size && !endOfFile) {
+            file.read(input.data(), input.size());
+            in = {input.data(), (size_t)file.gcount(), 0};
+            endOfFile = file.gcount() == 0;
+            lock_guard<mutex> guard(lock);
+            compressed += file.gcount();
+        }
+        ZSTD_outBuffer out = {output.data(), BLOCK_SIZE, used};
+        size_t consumed = in.pos;
+        size_t result = ZSTD_decompressStream(stream, &out, &in);
+        if (ZSTD_isError(result)) {
+            lock_guard<mutex> guard(lock);
+            error = string("Corrupt zstd data: ") + ZSTD_getErrorName(result);
+            break;
+        }
+        // a call without input or output after the end of a frame only returns a size hint for the next one
+        if (in.pos != consumed || out.pos != used) lastResult = result;
+        used = out.pos;
+        // output not full means everything decoded so far was flushed
+        bool drained = endOfFile && in.pos == in.size && used < BLOCK_SIZE;
+        if (used == BLOCK_SIZE) {
+            if (!push(move(output))) break;
+            output.assign(BLOCK_SIZE, 0);
+            used = 0;
+        }
+        if (drained) {
+            if (lastResult != 0) {
+                lock_guard<mutex> guard(lock);
+                error = "Unexpected end of zstd data";
+            }
+            break;
+        }
+    }
+    if (used > 0 && error.empty()) {
+        output.resize(used);
+        push(move(output));
+    }
+    ZSTD_freeDStream(stream);
+#endif
+}
@@ -0,0 +1,69 @@
+//
+// Created by filip on 28.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_COMPRESSEDINPUT_H
+#define PCC_SEMESTRALKA_COMPRESSEDINPUT_H
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// decompressed content of a gzip (.gz) or zstd (.zst) file
+// a background thread decompresses the file into blocks of 1 MiB, the reader takes them in order,
+// so decompression of the next block runs while the previous one is parsed (at most 4 blocks wait)
+// the content is read either block by block (nextBlock) or as a streambuf (istream over it)
+// gzip needs zlib, zstd needs libzstd at build time (PCC_HAVE_ZLIB / PCC_HAVE_ZSTD)
+class CompressedInput : public streambuf {
+private:
+    static const size_t BLOCK_SIZE = 1 << 20;
+    static const size_t QUEUE_BLOCKS = 4;
+
+    ifstream file;
+    string kind;
+    thread worker;
+    mutex lock;
+    condition_variable changed;
+    deque<vector<char>> ready;
+    bool finished = false;  // worker pushed the last block
+    bool stopping = false;  // reader was destroyed before the end
+    string error;
+    long long compressed = 0;
+    double waited = 0;
+    vector<char> current; // block behind the streambuf get area
+
+    void decompress();
+    void decompressGzip();
+    void decompressZstd();
+    // hand a full block to the reader, false if the reader is gone
+    bool push(vector<char>&& block);
+protected:
+    int_type underflow() override;
+public:
+    // exits with an error message if the file can not be opened or its compression is not supported
+    explicit CompressedInput(const string& filename);
+    ~CompressedInput() override;
+    CompressedInput(const CompressedInput&) = delete;
+    CompressedInput& operator=(const CompressedInput&) = delete;
+
+    // "gzip" or "zstd" by the magic bytes of the file, "" for anything else
+    static string compression(const string& filename);
+    // false if the program was built without the library for this compression
+    static bool isSupported(const string& compression);
+
+    // next decompressed block in order, false at the end; exits with an error message on corrupt data
+    bool nextBlock(vector<char>& block);
+
+    // bytes of compressed input read so far
+    long long compressedBytes();
+    // time the reader spent waiting for the decompression thread
+    double waitSeconds() const { return waited; }
+};
+
+#endif //PCC_SEMESTRALKA_COMPRESSEDINPUT_H
@@ -0,0 +1,92 @@
+//
+// Created by filip on 18.11.2025.
+//
+
+#include "DagShortestPath.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <memory>
+using namespace std;
+
+bool DagShortestPath::topologicalOrder(const Graph& graph, vector<int>& order) {
+    const auto& adjList = graph.getAdjList();
+    int n = graph.getSize();
+    vector<int> inDegree(n, 0);
+    for (int u = 0; u < n; u++) {
+        for (const Edge& edge : adjList[u]) inDegree[edge.to]++;
+    }
+
+    // order itself is the queue - vertices are appended when their last incoming edge is removed
+    order.clear();
+    order.reserve(n);
+    for (int v = 0; v < n; v++) {
+        if (inDegree[v] == 0) order.push_back(v);
+    }
+    for (size_t head = 0; head < order.size(); head++) {
+        for (const Edge& edge : adjList[order[head]]) {
+            if (--inDegree[edge.to] == 0) order.push_back(edge.to);
+        }
+    }
+    return (int)order.size() == n;
+}
+
+bool DagShortestPath::run(const Graph& graph, int start, const vector<int>& order, vector<int>& distances,
+                          vector<int>& parent, SearchStats* stats) {
+    int n = graph.getSize();
+    if ((int)order.size() != n) return false;
+    const auto& adjList = graph.getAdjList();
+    distances.assign(n, INT_MAX);
+    parent.assign(n, -1);
+    distances[start] = 0;
+    SearchStats counters;
+
+    // vertices before start in the order can not be reached from it
+    size_t first = find(order.begin(), order.end(), start) - order.begin();
+    for (size_t i = first; i < order.size(); i++) {
+        int u = order[i];
+        if (distances[u] == INT_MAX) continue;
+        counters.verticesSettled++;
+        for (const Edge& edge : adjList[u]) {
+            counters.edgesRelaxed++;
+            if (distances[u] + edge.weight < distances[edge.to]) {
+                distances[edge.to] = distances[u] + edge.weight;
+                parent[edge.to] = u;
+                counters.successfulRelaxations++;
+            }
+        }
+    }
+    if (stats) stats->add(counters);
+    return true;
+}
+
+pair<string,int> DagShortestPath::shortestPath(const Graph& graph, int start, int end, const vector<int>& order,
+                                               SearchStats* stats, HardwareCounters* counters) {
+    auto startTime = chrono::high_resolution_clock::now();
+    vector<int> distances;
+    vector<int> parent;
+    unique_ptr<PerfCounters> perf;
+    if (counters) {
+        perf = make_unique<PerfCounters>();
+        perf->start();
+    }
+    bool acyclic = run(graph, start, order, distances, parent, stats);
+    if (perf) *counters = perf->stop();
+    if (!acyclic) return {"Graph has a cycle", -1};
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::microseconds>(endTime - startTime).count();
+
+    if (distances[end] == INT_MAX) return {"Unreachable", -1};
+    vector<int> path;
+    for (int current = end; current != -1; current = parent[current]) path.push_back(current);
+    reverse(path.begin(), path.end());
+    cout << "Path: ";
+    for (auto v : path) {
+        cout << v << " ";
+    }
+    cout << endl;
+    cout << "Shortest distance from " << start << " to " << end << " is: " << distances[end] << endl;
+    cout << "DAG execution time: " << duration << " microseconds" << endl;
+    return {"OK", distances[end]};
+}
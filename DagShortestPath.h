@@ -0,0 +1,35 @@
+//
+// Created by filip on 18.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_DAGSHORTESTPATH_H
+#define PCC_SEMESTRALKA_DAGSHORTESTPATH_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// shortest paths in a directed acyclic graph in O(V + E), negative weights are allowed
+// vertices are relaxed in topological order, so every vertex is final when its edges are relaxed
+// the order is computed once (Kahn's algorithm) and reused by all searches on the same graph
+class DagShortestPath {
+public:
+    // Kahn's algorithm - fills order with all vertices in topological order
+    // returns false if the graph has a cycle (order then holds only the vertices before it)
+    static bool topologicalOrder(const Graph& graph, vector<int>& order);
+
+    // search core without any output - fills distances (INT_MAX = unreachable) and parent
+    // order must come from topologicalOrder() of the same graph, returns false if it is incomplete
+    static bool run(const Graph& graph, int start, const vector<int>& order, vector<int>& distances,
+                    vector<int>& parent, SearchStats* stats = nullptr);
+
+    // search from start, prints path and time
+    // returns status ("OK", "Unreachable", "Graph has a cycle") and distance to end
+    // counters get the hardware counters of the search alone, the output is not measured
+    static pair<string,int> shortestPath(const Graph& graph, int start, int end, const vector<int>& order,
+                                         SearchStats* stats = nullptr, HardwareCounters* counters = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_DAGSHORTESTPATH_H
@@ -10,6 +10,8 @@
 #include <set>
 #include <algorithm>
 #include <chrono>
+#include <functional>
+#include <memory>
 using namespace std;
 
 
@@ -56,13 +58,12 @@ void exportFinalGraph(const Graph& graph, int start, int end, const vector<int>&
 
 //representing gragh as adjacent list
 //{} means no edge, but we can also use INF to represent no edge
-int Dijkstra::shortestPath(const Graph& graph, int start, int end) {
-    auto startTime = std::chrono::high_resolution_clock::now();
-    vector<int> distances(graph.getSize(), INT_MAX);
+bool Dijkstra::run(const Graph& graph, int start, vector<int>& distances, vector<int>& parent, SearchStats* stats) {
+    distances.assign(graph.getSize(), INT_MAX);
     distances[start] = 0;
 
     //keep track of the path
-    vector<int> parent(graph.getSize(), -1);
+    parent.assign(graph.getSize(), -1);
 
     //simulation of prio queue - track of visited vertices
     vector<bool> visited(graph.getSize(), false);
@@ -70,13 +71,15 @@ int Dijkstra::shortestPath(const Graph& graph, int start, int end) {
 
     //flag for while loop - while not all vertices are visited
     int visitedCount = 0;
-    int routeDistance = 0;
+    SearchStats counters;
+    counters.heapPushes++; // start vertex
 
     //initialize distances from start vertex
     for (auto edge : graph.getNeighbors(currentVertex)) {
         if (edge.first == -1 || edge.second < 0) continue;
         distances[edge.first] = edge.second;
         parent[edge.first] = currentVertex; // set parent for first edges
+        counters.heapPushes++;
     }
 
     //while not all vertices are visited and not all distances are evaluated - run this loop
@@ -98,21 +101,127 @@ int Dijkstra::shortestPath(const Graph& graph, int start, int end) {
 
         visited[currentVertex] = true;
         visitedCount++;
+        counters.heapPops++;
+        counters.verticesSettled++;
         //relaxation of edges
         for (auto edge : graph.getNeighbors(currentVertex)) {
             if (edge.first == -1) continue;
+            counters.edgesRelaxed++;
             if(edge.second < 0) {
-                cerr << "Error: Dijkstra cannot handle negative edge weights!" << endl;
-                return -1;
+                if (stats) stats->add(counters);
+                return false;
             }
             if (distances[edge.first] > distances[currentVertex] + edge.second) {
                 distances[edge.first] = distances[currentVertex] + edge.second;
                 parent[edge.first] = currentVertex;
+                counters.successfulRelaxations++;
+                counters.heapPushes++;
             }
         }
 
     }
 
+    if (stats) stats->add(counters);
+    return true;
+}
+
+// query() for Graph and CompressedGraph, edges come from graph.neighbors(u)
+// allowed(u, index) - false skips the index-th edge of u (arc flags), plain queries pass a constant true
+template <class G, class Allowed>
+static QueryResult searchQuery(const G& graph, int start, int end, SearchWorkspace& workspace, SearchStats* stats,
+                               Allowed allowed) {
+    QueryResult result;
+    if (graph.hasNegativeEdges()) {
+        result.status = "Negative edge weight";
+        return result;
+    }
+
+    auto& heap = workspace.heap;
+    SearchStats counters;
+    workspace.reset(graph.getSize());
+    workspace.update(start, 0, -1);
+    heap.push_back({0, start});
+    counters.heapPushes++;
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        counters.heapPops++;
+        // lazy deletion - older heap entries of already settled vertices are skipped
+        if (workspace.isSettled(u) || distance > workspace.distance(u)) continue;
+        workspace.settle(u);
+        counters.verticesSettled++;
+        if (u == end) break;
+
+        int index = 0;
+        for (const Edge& edge : graph.neighbors(u)) {
+            if (!allowed(u, index++)) continue;
+            counters.edgesRelaxed++;
+            int candidate = distance + edge.weight;
+            if (candidate < workspace.distance(edge.to)) {
+                workspace.update(edge.to, candidate, u);
+                heap.push_back({candidate, edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                counters.successfulRelaxations++;
+                counters.heapPushes++;
+            }
+        }
+    }
+    if (stats) stats->add(counters);
+
+    if (end < 0) {
+        result.status = "OK"; // all distances are in the workspace
+        return result;
+    }
+    if (workspace.distance(end) == INT_MAX) {
+        result.status = "Unreachable";
+        return result;
+    }
+    result.status = "OK";
+    result.distance = workspace.distance(end);
+    result.path = workspace.pathTo(end);
+    return result;
+}
+
+static bool everyEdge(int, int) { return true; }
+
+QueryResult Dijkstra::query(const Graph& graph, int start, int end, SearchWorkspace& workspace, SearchStats* stats) {
+    return searchQuery(graph, start, end, workspace, stats, everyEdge);
+}
+
+QueryResult Dijkstra::query(const CompressedGraph& graph, int start, int end, SearchWorkspace& workspace,
+                            SearchStats* stats) {
+    return searchQuery(graph, start, end, workspace, stats, everyEdge);
+}
+
+QueryResult Dijkstra::query(const Graph& graph, const ArcFlags& flags, int start, int end, SearchWorkspace& workspace,
+                            SearchStats* stats) {
+    // without a target every edge is needed, stale flags would give wrong distances
+    if (end < 0 || end >= graph.getSize() || !flags.matches(graph)) {
+        return searchQuery(graph, start, end, workspace, stats, everyEdge);
+    }
+    uint64_t bit = 1ULL << flags.cellOf(end);
+    return searchQuery(graph, start, end, workspace, stats,
+                       [&flags, bit](int u, int index) { return (flags.edgeFlags(u, index) & bit) != 0; });
+}
+
+int Dijkstra::shortestPath(const Graph& graph, int start, int end, SearchStats* stats, HardwareCounters* counters) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    vector<int> distances;
+    vector<int> parent;
+    unique_ptr<PerfCounters> perf;
+    if (counters) {
+        perf = make_unique<PerfCounters>();
+        perf->start();
+    }
+    bool nonNegative = run(graph, start, distances, parent, stats);
+    if (perf) *counters = perf->stop();
+    if (!nonNegative) {
+        cerr << "Error: Dijkstra cannot handle negative edge weights!" << endl;
+        return -1;
+    }
+
     auto endTime = std::chrono::high_resolution_clock::now(); // end timing
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
 
@@ -5,12 +5,40 @@
 #ifndef COURSEWORK_DIJKSTRA_H
 #define COURSEWORK_DIJKSTRA_H
 #include "Graph.h"
+#include "CompressedGraph.h"
+#include "ArcFlags.h"
+#include "PerfCounters.h"
+#include "SearchWorkspace.h"
 #pragma once
 
 
 class Dijkstra {
 public:
-    static int shortestPath(const Graph& graph, int start, int end);
+    // search from start, prints path and time, exports DOT file
+    // returns distance to end or -1 (unreachable / negative edge)
+    // counters get the hardware counters of the search alone, the output is not measured
+    static int shortestPath(const Graph& graph, int start, int end, SearchStats* stats = nullptr,
+                            HardwareCounters* counters = nullptr);
+
+    // search core without any output - fills distances (INT_MAX = unreachable) and parent
+    // returns false if a negative edge was found
+    static bool run(const Graph& graph, int start, vector<int>& distances, vector<int>& parent,
+                    SearchStats* stats = nullptr);
+
+    // thread safe query - binary heap search that stops once end is settled
+    // end = -1 settles everything, distances are then read from the workspace
+    // no output at all, buffers come from the caller's workspace (one workspace per thread)
+    // graph with any negative edge is rejected with status "Negative edge weight"
+    static QueryResult query(const Graph& graph, int start, int end, SearchWorkspace& workspace,
+                             SearchStats* stats = nullptr);
+    // same search over the varint encoded read only graph
+    static QueryResult query(const CompressedGraph& graph, int start, int end, SearchWorkspace& workspace,
+                             SearchStats* stats = nullptr);
+    // same search that relaxes only edges flagged for the cell of end (flags built for this graph)
+    // end = -1, flags of another graph or of an older version of this one (ArcFlags::matches) fall back
+    // to the plain query
+    static QueryResult query(const Graph& graph, const ArcFlags& flags, int start, int end,
+                             SearchWorkspace& workspace, SearchStats* stats = nullptr);
 };
 
 
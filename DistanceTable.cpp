@@ -0,0 +1,103 @@
+//
+// Created by filip on 12.11.2025.
+//
+
+#include "DistanceTable.h"
+#include "SearchWorkspace.h"
+#include "ThreadPool.h"
+#include "BatchedBellmanFord.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+using namespace std;
+
+// Dijkstra from origin that stops once all marked vertices are settled
+// isTarget - 1 for searched vertices, targetCount - number of distinct marked vertices
+static void searchTargets(const Graph& graph, int origin, const vector<char>& isTarget, int targetCount,
+                          SearchWorkspace& workspace) {
+    const auto& adjList = graph.getAdjList();
+    auto& heap = workspace.heap;
+    workspace.reset(graph.getSize());
+    workspace.update(origin, 0, -1);
+    heap.push_back({0, origin});
+    int remaining = targetCount;
+
+    while (!heap.empty() && remaining > 0) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        if (workspace.isSettled(u) || distance > workspace.distance(u)) continue;
+        workspace.settle(u);
+        if (isTarget[u]) remaining--;
+
+        for (const Edge& edge : adjList[u]) {
+            int candidate = distance + edge.weight;
+            if (candidate < workspace.distance(edge.to)) {
+                workspace.update(edge.to, candidate, u);
+                heap.push_back({candidate, edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+            }
+        }
+    }
+}
+
+bool DistanceTable::compute(const Graph& graph, const vector<int>& sources, const vector<int>& targets,
+                            DistanceMatrix& matrix, int threads) {
+    for (int v : sources) if (v < 0 || v >= graph.getSize()) return false;
+    for (int v : targets) if (v < 0 || v >= graph.getSize()) return false;
+
+    matrix.rows = static_cast<int>(sources.size());
+    matrix.cols = static_cast<int>(targets.size());
+    matrix.values.assign((size_t)matrix.rows * matrix.cols, INT_MAX);
+    if (matrix.rows == 0 || matrix.cols == 0) return true;
+
+    if (graph.hasNegativeEdges()) {
+        // Dijkstra is not usable, all sources go through the batched Bellman-Ford
+        vector<vector<int>> distances;
+        vector<string> statuses = BatchedBellmanFord::run(graph, sources, distances);
+        for (int i = 0; i < matrix.rows; i++) {
+            if (statuses[i] != "OK") return false;
+            for (int j = 0; j < matrix.cols; j++) matrix.values[(size_t)i * matrix.cols + j] = distances[i][targets[j]];
+        }
+        return true;
+    }
+
+    // search from the smaller side, backward searches run on the reversed graph
+    bool forward = sources.size() <= targets.size();
+    Graph reverse(0);
+    if (!forward) reverse = graph.reversed();
+    const Graph& searchGraph = forward ? graph : reverse;
+    const vector<int>& origins = forward ? sources : targets;
+    const vector<int>& destinations = forward ? targets : sources;
+
+    vector<char> isTarget(graph.getSize(), 0);
+    int targetCount = 0;
+    for (int v : destinations) {
+        if (!isTarget[v]) targetCount++;
+        isTarget[v] = 1;
+    }
+
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    threads = min<int>(threads, origins.size());
+    vector<SearchWorkspace> workspaces(threads);
+    atomic<int> next(0);
+    {
+        // every worker takes the next origin until all are done
+        ThreadPool pool(threads, threads);
+        for (int t = 0; t < threads; t++) {
+            pool.submit([&](int worker) {
+                SearchWorkspace& workspace = workspaces[worker];
+                for (int i = next++; i < (int)origins.size(); i = next++) {
+                    searchTargets(searchGraph, origins[i], isTarget, targetCount, workspace);
+                    for (int j = 0; j < (int)destinations.size(); j++) {
+                        int distance = workspace.distance(destinations[j]);
+                        if (forward) matrix.values[(size_t)i * matrix.cols + j] = distance;
+                        else matrix.values[(size_t)j * matrix.cols + i] = distance;
+                    }
+                }
+            });
+        }
+    }
+    return true;
+}
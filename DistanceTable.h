@@ -0,0 +1,36 @@
+//
+// Created by filip on 12.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_DISTANCETABLE_H
+#define PCC_SEMESTRALKA_DISTANCETABLE_H
+#pragma once
+#include "Graph.h"
+#include <climits>
+#include <vector>
+using namespace std;
+
+// dense sources x targets matrix stored row by row, INT_MAX = unreachable
+struct DistanceMatrix {
+    int rows = 0;
+    int cols = 0;
+    vector<int> values;
+
+    int at(int row, int col) const { return values[(size_t)row * cols + col]; }
+};
+
+// many-to-many distances on top of the Dijkstra engine
+// instead of sources x targets point-to-point queries it runs one search per row or per column:
+// - sources <= targets: one forward search per source, stops when all targets are settled
+// - sources >  targets: one backward search per target on the reversed graph
+// searches run in parallel, every thread has its own SearchWorkspace
+// graphs with negative edges use BatchedBellmanFord (8 sources per sweep) instead
+class DistanceTable {
+public:
+    // fill matrix, threads = 0 uses all cores
+    // returns false if a vertex is out of range or a negative cycle is reachable from a source
+    static bool compute(const Graph& graph, const vector<int>& sources, const vector<int>& targets,
+                        DistanceMatrix& matrix, int threads = 0);
+};
+
+#endif //PCC_SEMESTRALKA_DISTANCETABLE_H
@@ -0,0 +1,132 @@
+//
+// Created by filip on 22.11.2025.
+//
+
+#include "DynamicShortestPaths.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+using namespace std;
+
+DynamicShortestPaths::DynamicShortestPaths(Graph& graph, int source, SearchStats* stats)
+    : graph(graph), reverse(graph.reversed()), source(source), dist(graph.getSize(), INT_MAX),
+      parentVertex(graph.getSize(), -1), affected(graph.getSize(), 0), valid(!graph.hasNegativeEdges()) {
+    if (!valid) return;
+    SearchStats counters;
+    dist[source] = 0;
+    heap.push_back({0, source});
+    propagate(counters);
+    if (stats) stats->add(counters);
+}
+
+void DynamicShortestPaths::propagate(SearchStats& counters) {
+    const auto& adjList = graph.getAdjList();
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        counters.heapPops++;
+        if (distance > dist[u]) continue; // stale entry
+        counters.verticesSettled++;
+        for (const Edge& edge : adjList[u]) {
+            counters.edgesRelaxed++;
+            int candidate = distance + edge.weight;
+            if (candidate < dist[edge.to]) {
+                dist[edge.to] = candidate;
+                parentVertex[edge.to] = u;
+                heap.push_back({candidate, edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                counters.successfulRelaxations++;
+                counters.heapPushes++;
+            }
+        }
+    }
+}
+
+void DynamicShortestPaths::decrease(int from, int to, int weight, SearchStats& counters) {
+    if (dist[from] == INT_MAX || dist[from] + weight >= dist[to]) return;
+    dist[to] = dist[from] + weight;
+    parentVertex[to] = from;
+    heap.push_back({dist[to], to});
+    propagate(counters);
+}
+
+void DynamicShortestPaths::increase(int from, int to, SearchStats& counters) {
+    if (parentVertex[to] != from) return; // not a tree edge, no distance depended on it
+
+    // subtree of to - children of x are the out-neighbours whose tree parent is x
+    const auto& adjList = graph.getAdjList();
+    vector<int> subtree = {to};
+    affected[to] = 1;
+    for (size_t i = 0; i < subtree.size(); i++) {
+        for (const Edge& edge : adjList[subtree[i]]) {
+            if (!affected[edge.to] && parentVertex[edge.to] == subtree[i]) {
+                affected[edge.to] = 1;
+                subtree.push_back(edge.to);
+            }
+        }
+    }
+    for (int v : subtree) {
+        dist[v] = INT_MAX;
+        parentVertex[v] = -1;
+    }
+
+    // every vertex of the subtree starts from its best edge coming from outside, distances there are final
+    const auto& inList = reverse.getAdjList();
+    for (int v : subtree) {
+        for (const Edge& edge : inList[v]) {
+            counters.edgesRelaxed++;
+            int u = edge.to;
+            if (affected[u] || dist[u] == INT_MAX) continue;
+            if (dist[u] + edge.weight < dist[v]) {
+                dist[v] = dist[u] + edge.weight;
+                parentVertex[v] = u;
+            }
+        }
+        if (dist[v] != INT_MAX) heap.push_back({dist[v], v});
+    }
+    make_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+    for (int v : subtree) affected[v] = 0;
+    propagate(counters);
+}
+
+bool DynamicShortestPaths::insertEdge(int from, int to, int weight, SearchStats* stats) {
+    int n = graph.getSize();
+    if (!valid || weight < 0 || from < 0 || from >= n || to < 0 || to >= n) return false;
+    graph.addEdge(from, to, weight);
+    reverse.addEdge(to, from, weight);
+    SearchStats counters;
+    decrease(from, to, weight, counters);
+    if (stats) stats->add(counters);
+    return true;
+}
+
+bool DynamicShortestPaths::deleteEdge(int from, int to, SearchStats* stats) {
+    if (!valid || !graph.removeEdge(from, to)) return false;
+    reverse.removeEdge(to, from);
+    SearchStats counters;
+    increase(from, to, counters);
+    if (stats) stats->add(counters);
+    return true;
+}
+
+bool DynamicShortestPaths::changeWeight(int from, int to, int weight, SearchStats* stats) {
+    if (!valid || weight < 0) return false;
+    int old = graph.edgeWeight(from, to);
+    if (old == INT_MAX || !graph.setEdgeWeight(from, to, weight)) return false;
+    reverse.setEdgeWeight(to, from, weight);
+    SearchStats counters;
+    // the edge may have been the tree edge also when another parallel edge is now the cheapest one
+    if (weight < old) decrease(from, to, weight, counters);
+    else if (weight > old) increase(from, to, counters);
+    if (stats) stats->add(counters);
+    return true;
+}
+
+vector<int> DynamicShortestPaths::pathTo(int v) const {
+    vector<int> path;
+    if (v < 0 || v >= (int)dist.size() || dist[v] == INT_MAX) return path;
+    for (int current = v; current != -1; current = parentVertex[current]) path.push_back(current);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
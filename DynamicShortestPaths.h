@@ -0,0 +1,58 @@
+//
+// Created by filip on 22.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_DYNAMICSHORTESTPATHS_H
+#define PCC_SEMESTRALKA_DYNAMICSHORTESTPATHS_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include <utility>
+#include <vector>
+using namespace std;
+
+// shortest path tree of one source kept up to date while the graph changes (Ramalingam-Reps style)
+// all changes go through this class, it applies them to the graph and repairs only what they affect:
+// - cheaper edge u -> v (insert / decrease): if it improves v, Dijkstra continues from v
+//   and touches only the vertices that get closer
+// - dearer edge u -> v (delete / increase): nothing to do unless it was the tree edge of v,
+//   otherwise the subtree of v loses its distances, every vertex in it takes the best incoming
+//   edge from outside the subtree and Dijkstra settles the subtree again
+// non-negative weights only, like Dijkstra; a graph with negative edges is rejected (isValid)
+// the graph must not be changed behind the back of this class
+class DynamicShortestPaths {
+private:
+    Graph& graph;
+    Graph reverse;              // incoming edges, changed together with graph
+    int source;
+    vector<int> dist;           // INT_MAX = unreachable
+    vector<int> parentVertex;   // -1 for source and unreachable vertices
+    vector<pair<int,int>> heap; // (distance, vertex) min-heap reused by all repairs
+    vector<char> affected;      // marks of the current subtree, cleared after every repair
+    bool valid;
+
+    // Dijkstra from the vertices already in heap, only improving relaxations go on
+    void propagate(SearchStats& counters);
+    void decrease(int from, int to, int weight, SearchStats& counters);
+    void increase(int from, int to, SearchStats& counters);
+public:
+    DynamicShortestPaths(Graph& graph, int source, SearchStats* stats = nullptr);
+
+    // false if the graph had negative edges when constructed
+    bool isValid() const { return valid; }
+
+    // graph mutations, return false if the edge does not exist (delete / change),
+    // the weight is negative or the vertices are out of range
+    bool insertEdge(int from, int to, int weight, SearchStats* stats = nullptr);
+    bool deleteEdge(int from, int to, SearchStats* stats = nullptr);
+    bool changeWeight(int from, int to, int weight, SearchStats* stats = nullptr);
+
+    int getSource() const { return source; }
+    int distance(int v) const { return dist[v]; }
+    int parent(int v) const { return parentVertex[v]; }
+    const vector<int>& getDistances() const { return dist; }
+    // source ... v, empty if v is unreachable
+    vector<int> pathTo(int v) const;
+};
+
+#endif //PCC_SEMESTRALKA_DYNAMICSHORTESTPATHS_H
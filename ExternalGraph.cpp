@@ -0,0 +1,139 @@
+//
+// Created by filip on 3.12.2025.
+//
+
+#include "ExternalGraph.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+using namespace std;
+
+template <class T>
+static void writeValue(ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+static bool readValue(ifstream& in, T& value) {
+    return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+bool ExternalGraph::write(const Graph& graph, const string& filename, int partitionVertices) {
+    ofstream out(filename, ios::binary);
+    if (!out) return false;
+    partitionVertices = max(1, partitionVertices);
+    int n = graph.getSize();
+    int partitions = (n + partitionVertices - 1) / partitionVertices;
+    int minWeight = graph.getEdgeCount() > 0 ? graph.getMinWeight() : 0;
+    int maxWeight = graph.getEdgeCount() > 0 ? graph.getMaxWeight() : 0;
+
+    out.write("PCCX", 4);
+    writeValue(out, (int)VERSION);
+    writeValue(out, n);
+    writeValue(out, (long long)graph.getEdgeCount());
+    writeValue(out, partitionVertices);
+    writeValue(out, partitions);
+    writeValue(out, minWeight);
+    writeValue(out, maxWeight);
+    writeValue(out, (int)graph.hasNegativeEdges());
+
+    // index first, partitions follow in vertex order
+    uint64_t position = (uint64_t)out.tellp() + (partitions + 1) * sizeof(uint64_t);
+    for (int p = 0; p <= partitions; p++) {
+        writeValue(out, position);
+        if (p == partitions) break;
+        int first = p * partitionVertices, last = min(n, first + partitionVertices);
+        uint64_t edges = 0;
+        for (int v = first; v < last; v++) edges += graph.neighbors(v).size();
+        if (edges > UINT32_MAX) return false; // offsets inside a partition are 32 bit
+        position += (last - first + 1) * sizeof(uint32_t) + edges * sizeof(Edge);
+    }
+    for (int p = 0; p < partitions; p++) {
+        int first = p * partitionVertices, last = min(n, first + partitionVertices);
+        uint32_t offset = 0;
+        writeValue(out, offset);
+        for (int v = first; v < last; v++) {
+            offset += (uint32_t)graph.neighbors(v).size();
+            writeValue(out, offset);
+        }
+        for (int v = first; v < last; v++) {
+            const auto& edges = graph.neighbors(v);
+            out.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(Edge));
+        }
+    }
+    return (bool)out;
+}
+
+ExternalGraph::ExternalGraph(const string& filename, size_t cacheBytes) : file(filename, ios::binary),
+                                                                           cacheBytes(cacheBytes) {
+    if (!file) {
+        cerr << "Cannot open file " << filename << endl;
+        return;
+    }
+    char magic[4];
+    int version = 0, negative = 0;
+    bool ok = file.read(magic, 4) && string(magic, 4) == "PCCX" && readValue(file, version) && version == VERSION &&
+              readValue(file, n) && readValue(file, edgeCount) && readValue(file, partitionVertices) &&
+              readValue(file, partitionCount) && readValue(file, minWeight) && readValue(file, maxWeight) &&
+              readValue(file, negative) && n >= 0 && edgeCount >= 0 && partitionVertices > 0 &&
+              partitionCount == (int)(((long long)n + partitionVertices - 1) / partitionVertices);
+    if (ok) {
+        negativeEdges = negative != 0;
+        index.resize((size_t)partitionCount + 1);
+        ok = (bool)file.read(reinterpret_cast<char*>(index.data()), index.size() * sizeof(uint64_t));
+        for (int p = 0; ok && p < partitionCount; p++) ok = index[p] <= index[p + 1];
+    }
+    if (!ok) {
+        cerr << "Invalid external graph file " << filename << endl;
+        return;
+    }
+    valid = true;
+}
+
+const ExternalGraph::Partition& ExternalGraph::partition(int p) {
+    auto found = cached.find(p);
+    if (found != cached.end()) {
+        io.cacheHits++;
+        cache.splice(cache.begin(), cache, found->second); // most recently used
+        return found->second->second;
+    }
+
+    Partition loaded;
+    loaded.firstVertex = p * partitionVertices;
+    int count = min(n, loaded.firstVertex + partitionVertices) - loaded.firstVertex;
+    loaded.offsets.resize((size_t)count + 1);
+    file.clear();
+    file.seekg((streamoff)index[p]);
+    file.read(reinterpret_cast<char*>(loaded.offsets.data()), loaded.offsets.size() * sizeof(uint32_t));
+    // the engines index distances by edge.to and edges by the offsets, a corrupt partition must not get to them
+    bool ok = file && loaded.offsets[0] == 0;
+    for (int i = 0; ok && i < count; i++) ok = loaded.offsets[i] <= loaded.offsets[i + 1];
+    ok = ok && loaded.offsets.size() * sizeof(uint32_t) + (uint64_t)loaded.offsets.back() * sizeof(Edge) <=
+                       index[p + 1] - index[p];
+    if (ok) {
+        loaded.edges.resize(loaded.offsets.back());
+        ok = (bool)file.read(reinterpret_cast<char*>(loaded.edges.data()), loaded.edges.size() * sizeof(Edge));
+    }
+    for (size_t e = 0; ok && e < loaded.edges.size(); e++) ok = loaded.edges[e].to >= 0 && loaded.edges[e].to < n;
+    if (!ok) {
+        cerr << "Invalid external graph file, partition " << p << endl;
+        valid = false;
+        broken.firstVertex = loaded.firstVertex;
+        broken.offsets.assign((size_t)count + 1, 0);
+        broken.edges.clear();
+        return broken;
+    }
+    io.bytesRead += (long long)loaded.bytes();
+    io.partitionsRead++;
+
+    // least recently used partitions leave first, the new one always stays
+    while (!cache.empty() && cachedBytes + loaded.bytes() > cacheBytes) {
+        cachedBytes -= cache.back().second.bytes();
+        cached.erase(cache.back().first);
+        cache.pop_back();
+    }
+    cachedBytes += loaded.bytes();
+    cache.emplace_front(p, move(loaded));
+    cached[p] = cache.begin();
+    return cache.front().second;
+}
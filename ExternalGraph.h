@@ -0,0 +1,92 @@
+//
+// Created by filip on 3.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_EXTERNALGRAPH_H
+#define PCC_SEMESTRALKA_EXTERNALGRAPH_H
+#pragma once
+#include "Graph.h"
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+// I/O done by an ExternalGraph since it was opened
+struct ExternalIoStats {
+    long long bytesRead = 0;     // partition data read from the file (header and index not counted)
+    long long partitionsRead = 0;
+    long long cacheHits = 0;     // partition() answered from memory
+};
+
+// adjacency lists on disk for graphs larger than memory (semi-external model: O(V) in memory, O(E) on disk)
+// file layout (all numbers little endian):
+//   "PCCX", version, vertices, edges (int64), vertices per partition, partitions, min / max weight, negative edges
+//   partition index - partitions + 1 file offsets (uint64)
+//   partition p = vertices [p * P, (p + 1) * P): P + 1 edge offsets (uint32) relative to the partition,
+//   then its edges (to, weight) in CSR order
+// partitions are read whole and kept in an LRU cache limited by cacheBytes,
+// engines (ExternalShortestPath) visit vertices partition by partition to read each one as rarely as possible
+class ExternalGraph {
+public:
+    // one partition in memory, edges of vertex v are edges[offsets[v - firstVertex] .. offsets[v - firstVertex + 1])
+    struct Partition {
+        int firstVertex = 0;
+        vector<uint32_t> offsets;
+        vector<Edge> edges;
+
+        size_t bytes() const { return offsets.size() * sizeof(uint32_t) + edges.size() * sizeof(Edge); }
+    };
+private:
+    static const int VERSION = 1;
+
+    ifstream file;
+    bool valid = false;
+    int n = 0;
+    long long edgeCount = 0;
+    int partitionVertices = 1;
+    int partitionCount = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    bool negativeEdges = false;
+    vector<uint64_t> index;
+
+    size_t cacheBytes;
+    size_t cachedBytes = 0;
+    list<pair<int, Partition>> cache; // most recently used first
+    unordered_map<int, list<pair<int, Partition>>::iterator> cached;
+    Partition broken; // returned (without edges) for a partition that failed to read
+    ExternalIoStats io;
+public:
+    // write the layout of graph, P = partitionVertices vertices per partition
+    // returns false if the file can not be written
+    static bool write(const Graph& graph, const string& filename, int partitionVertices = 4096);
+
+    // open a layout written by write(), isOpen() is false (and the reason is on cerr) for a missing or invalid file
+    explicit ExternalGraph(const string& filename, size_t cacheBytes = 64 << 20);
+    ExternalGraph(const ExternalGraph&) = delete;
+    ExternalGraph& operator=(const ExternalGraph&) = delete;
+
+    bool isOpen() const { return valid; }
+    int getSize() const { return n; }
+    long long getEdgeCount() const { return edgeCount; }
+    bool hasNegativeEdges() const { return negativeEdges; }
+    int getMinWeight() const { return minWeight; } // 0 for a graph without edges
+    int getMaxWeight() const { return maxWeight; }
+    int getPartitionCount() const { return partitionCount; }
+    int partitionOf(int vertex) const { return vertex / partitionVertices; }
+    // size of the file without header and index
+    long long dataBytes() const { return partitionCount > 0 ? (long long)(index.back() - index.front()) : 0; }
+
+    // partition p from the cache or the file; the reference is valid until the next call
+    // a truncated or corrupt partition (offsets out of order or past its block, edge to a vertex out of range)
+    // makes isOpen() false and comes back without edges
+    const Partition& partition(int p);
+
+    const ExternalIoStats& ioStats() const { return io; }
+    void resetIoStats() { io = ExternalIoStats(); }
+};
+
+#endif //PCC_SEMESTRALKA_EXTERNALGRAPH_H
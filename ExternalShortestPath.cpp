@@ -0,0 +1,164 @@
+//
+// Created by filip on 3.12.2025.
+//
+
+#include "ExternalShortestPath.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <map>
+#include <memory>
+using namespace std;
+
+bool ExternalShortestPath::dijkstra(ExternalGraph& graph, int start, vector<int>& distances, vector<int>& parent,
+                                    int delta, SearchStats* stats) {
+    int n = graph.getSize();
+    distances.assign(n, INT_MAX);
+    parent.assign(n, -1);
+    if (graph.hasNegativeEdges() || !graph.isOpen()) return false;
+    if (delta <= 0) delta = (int)min<long long>(INT_MAX, max(1LL, 4LL * graph.getMaxWeight()));
+
+    SearchStats counters;
+    map<long long, vector<int>> buckets; // bucket number -> vertices, stale entries are skipped
+    vector<int> scannedDistance(n, INT_MAX); // distance u had when its edges were last relaxed
+    vector<int> round, pending;
+    distances[start] = 0;
+    buckets[0].push_back(start);
+    counters.heapPushes++;
+
+    while (!buckets.empty()) {
+        long long bucket = buckets.begin()->first;
+        // rounds of the same bucket until no vertex falls back into it
+        while (!buckets.empty() && buckets.begin()->first == bucket) {
+            round.swap(buckets.begin()->second);
+            buckets.erase(buckets.begin());
+            counters.heapPops += round.size();
+            // vertex order = partition order, every partition of the round is loaded once
+            sort(round.begin(), round.end());
+            for (size_t i = 0; i < round.size();) {
+                int p = graph.partitionOf(round[i]);
+                pending.clear();
+                for (; i < round.size() && graph.partitionOf(round[i]) == p; i++) pending.push_back(round[i]);
+                const ExternalGraph::Partition& part = graph.partition(p);
+                // improvements inside the loaded partition and the current bucket are scanned right away,
+                // the rest goes to the buckets
+                while (!pending.empty()) {
+                    int u = pending.back();
+                    pending.pop_back();
+                    if (distances[u] / delta != bucket || scannedDistance[u] == distances[u]) continue;
+                    scannedDistance[u] = distances[u];
+                    counters.verticesSettled++;
+                    int local = u - part.firstVertex;
+                    for (uint32_t e = part.offsets[local]; e < part.offsets[local + 1]; e++) {
+                        const Edge& edge = part.edges[e];
+                        counters.edgesRelaxed++;
+                        int candidate = distances[u] + edge.weight;
+                        if (candidate < distances[edge.to]) {
+                            distances[edge.to] = candidate;
+                            parent[edge.to] = u;
+                            if (candidate / delta == bucket && graph.partitionOf(edge.to) == p)
+                                pending.push_back(edge.to);
+                            else
+                                buckets[candidate / delta].push_back(edge.to);
+                            counters.successfulRelaxations++;
+                            counters.heapPushes++;
+                        }
+                    }
+                }
+            }
+            round.clear();
+        }
+    }
+    if (stats) stats->add(counters);
+    return graph.isOpen();
+}
+
+bool ExternalShortestPath::bellmanFord(ExternalGraph& graph, int start, vector<int>& distances,
+                                       vector<int>& parent, SearchStats* stats) {
+    int n = graph.getSize();
+    int partitions = graph.getPartitionCount();
+    distances.assign(n, INT_MAX);
+    parent.assign(n, -1);
+    distances[start] = 0;
+
+    SearchStats counters;
+    // active = distance changed in the previous pass, counted per partition to skip whole partitions
+    vector<char> active(n, 0), next(n, 0);
+    vector<int> activeCount(partitions, 0), nextCount(partitions, 0);
+    active[start] = 1;
+    activeCount[graph.partitionOf(start)] = 1;
+
+    // after V-1 passes distances are final, a change in pass V means a negative cycle
+    bool changed = true;
+    for (int pass = 0; pass < n && changed; pass++) {
+        changed = false;
+        for (int p = 0; p < partitions; p++) {
+            if (activeCount[p] == 0) continue;
+            const ExternalGraph::Partition& part = graph.partition(p);
+            int count = (int)part.offsets.size() - 1;
+            for (int local = 0; local < count; local++) {
+                int u = part.firstVertex + local;
+                if (!active[u]) continue;
+                active[u] = 0;
+                counters.verticesSettled++;
+                for (uint32_t e = part.offsets[local]; e < part.offsets[local + 1]; e++) {
+                    const Edge& edge = part.edges[e];
+                    counters.edgesRelaxed++;
+                    if (distances[u] + edge.weight < distances[edge.to]) {
+                        distances[edge.to] = distances[u] + edge.weight;
+                        parent[edge.to] = u;
+                        counters.successfulRelaxations++;
+                        changed = true;
+                        if (!next[edge.to]) {
+                            next[edge.to] = 1;
+                            nextCount[graph.partitionOf(edge.to)]++;
+                        }
+                    }
+                }
+            }
+            activeCount[p] = 0;
+        }
+        active.swap(next);
+        activeCount.swap(nextCount);
+    }
+    if (stats) stats->add(counters);
+    return !changed && graph.isOpen();
+}
+
+pair<string,int> ExternalShortestPath::shortestPath(ExternalGraph& graph, int start, int end, const string& engine,
+                                                    SearchStats* stats, HardwareCounters* counters) {
+    auto startTime = chrono::high_resolution_clock::now();
+    graph.resetIoStats();
+    vector<int> distances;
+    vector<int> parent;
+    unique_ptr<PerfCounters> perf;
+    if (counters) {
+        perf = make_unique<PerfCounters>();
+        perf->start();
+    }
+    bool finished = engine == "bellman" ? bellmanFord(graph, start, distances, parent, stats)
+                                        : dijkstra(graph, start, distances, parent, 0, stats);
+    if (perf) *counters = perf->stop();
+    if (!graph.isOpen()) return {"Invalid external graph file", -1};
+    if (!finished) return {engine == "bellman" ? "Negative weight cycle detected" : "Negative edge weight", -1};
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::microseconds>(endTime - startTime).count();
+    const ExternalIoStats& io = graph.ioStats();
+    cerr << "Read " << io.bytesRead << " bytes in " << io.partitionsRead << " partitions (" << io.cacheHits
+         << " cache hits), graph data is " << graph.dataBytes() << " bytes\n";
+
+    if (distances[end] == INT_MAX) return {"Unreachable", -1};
+    vector<int> path;
+    for (int current = end; current != -1; current = parent[current]) path.push_back(current);
+    reverse(path.begin(), path.end());
+    cout << "Path: ";
+    for (auto v : path) {
+        cout << v << " ";
+    }
+    cout << endl;
+    cout << "Shortest distance from " << start << " to " << end << " is: " << distances[end] << endl;
+    cout << "External " << (engine == "bellman" ? "Bellman-Ford" : "Dijkstra") << " execution time: " << duration
+         << " microseconds" << endl;
+    return {"OK", distances[end]};
+}
@@ -0,0 +1,45 @@
+//
+// Created by filip on 3.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_EXTERNALSHORTESTPATH_H
+#define PCC_SEMESTRALKA_EXTERNALSHORTESTPATH_H
+#pragma once
+#include "ExternalGraph.h"
+#include "PerfCounters.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// semi-external engines over ExternalGraph - distances and parents are in memory, edges are read from disk
+// partition by partition; both fill distances (INT_MAX = unreachable) and parent with the same contract
+// as Dijkstra::run / BellmanFord::run, bytes read are in graph.ioStats()
+// - dijkstra:    bucketed priority queue (delta-stepping, bucket i = distances [i * delta, (i + 1) * delta));
+//                the whole current bucket is scanned at once sorted by vertex, so each partition is
+//                read at most once per round instead of once per settled vertex; while a partition is
+//                loaded, its vertices improved into the current bucket are scanned right away,
+//                improvements in other partitions wait for the next round of the bucket
+// - bellmanFord: passes over the partitions in file order (sequential reads), partitions without a vertex
+//                whose distance changed in the previous pass are skipped
+class ExternalShortestPath {
+public:
+    // returns false if the graph has a negative edge or a partition of the file is invalid (graph.isOpen())
+    // delta = 0 uses 4 x max weight - wider buckets mean fewer rounds, so fewer partition reads,
+    // but more vertices scanned more than once (on a 300 x 300 grid: 1x max weight reads the graph
+    // 90 times per query with a small cache, 4x 33 times for 3x the CPU time)
+    static bool dijkstra(ExternalGraph& graph, int start, vector<int>& distances, vector<int>& parent,
+                         int delta = 0, SearchStats* stats = nullptr);
+
+    // returns false if a negative weight cycle is reachable from start or a partition is invalid
+    static bool bellmanFord(ExternalGraph& graph, int start, vector<int>& distances, vector<int>& parent,
+                            SearchStats* stats = nullptr);
+
+    // search from start with engine "dijkstra" or "bellman", prints path, time and I/O
+    // returns status ("OK", "Unreachable", "Negative edge weight", "Negative weight cycle detected",
+    // "Invalid external graph file")
+    // and distance to end, counters get the hardware counters of the search alone (output not measured)
+    static pair<string,int> shortestPath(ExternalGraph& graph, int start, int end, const string& engine,
+                                         SearchStats* stats = nullptr, HardwareCounters* counters = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_EXTERNALSHORTESTPATH_H
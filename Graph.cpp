@@ -3,9 +3,124 @@
 //
 
 #include "Graph.h"
+#include <algorithm>
 
 // constructor
-Graph::Graph(const int& n) : n(n), adjList(n) {}
+// without known degrees the lists grow, so they live in a pool that reuses the blocks they leave
+Graph::Graph(const int& n)
+    : storage(make_unique<Storage>(0, nullptr, true)), n(n), negativeEdges(0), edgeCount(0),
+      zeroOneEdges(0), minWeight(INT_MAX), maxWeight(INT_MIN), version(0),
+      topologyVersion(0) {
+    storage->adjList.resize(n);
+}
+
+// arena size = list headers + all edges, the first allocation takes the whole block at once
+Graph::Graph(int n, const vector<int>& degrees)
+    : n(n), negativeEdges(0), edgeCount(0), zeroOneEdges(0), minWeight(INT_MAX), maxWeight(INT_MIN), version(0),
+      topologyVersion(0) {
+    size_t edges = 0;
+    for (int degree : degrees) edges += degree;
+    storage = make_unique<Storage>(n * sizeof(pmr::vector<Edge>) + edges * sizeof(Edge) + 64);
+    storage->adjList.resize(n);
+    for (int v = 0; v < n && v < (int)degrees.size(); v++) storage->adjList[v].reserve(degrees[v]);
+}
+
+Graph::Graph(int n, const vector<long long>& offsets, const vector<Edge>& edges)
+    : n(n), negativeEdges(0), edgeCount(0), zeroOneEdges(0), minWeight(INT_MAX), maxWeight(INT_MIN), version(0),
+      topologyVersion(0) {
+    storage = make_unique<Storage>(n * sizeof(pmr::vector<Edge>) + edges.size() * sizeof(Edge) + 64);
+    storage->adjList.resize(n);
+    for (int v = 0; v < n; v++) {
+        storage->adjList[v].assign(edges.begin() + offsets[v], edges.begin() + offsets[v + 1]);
+    }
+    for (const Edge& edge : edges) countEdge(edge.weight, +1);
+}
+
+Graph::Graph(const Graph& other) : Graph(other, nullptr) {}
+
+// copy goes into a new arena of exactly the needed size
+Graph::Graph(const Graph& other, shared_ptr<PlacedMemory> placement)
+    : n(other.n), negativeEdges(other.negativeEdges), edgeCount(other.edgeCount), zeroOneEdges(other.zeroOneEdges),
+      minWeight(other.minWeight), maxWeight(other.maxWeight), categories(other.categories), version(other.version),
+      topologyVersion(other.topologyVersion) {
+    size_t edges = (size_t)edgeCount;
+    storage = make_unique<Storage>(n * sizeof(pmr::vector<Edge>) + edges * sizeof(Edge) + 64, move(placement));
+    storage->adjList.resize(n);
+    for (int v = 0; v < n; v++) {
+        storage->adjList[v].assign(other.storage->adjList[v].begin(), other.storage->adjList[v].end());
+    }
+}
+
+Graph& Graph::operator=(const Graph& other) {
+    if (this != &other) *this = Graph(other);
+    return *this;
+}
+
+Graph::Graph(Graph&& other) noexcept
+    : n(0), negativeEdges(0), edgeCount(0), zeroOneEdges(0), minWeight(INT_MAX), maxWeight(INT_MIN), version(0),
+      topologyVersion(0) {
+    *this = move(other);
+}
+
+Graph& Graph::operator=(Graph&& other) noexcept {
+    if (this == &other) return *this;
+    storage = move(other.storage);
+    n = other.n;
+    negativeEdges = other.negativeEdges;
+    edgeCount = other.edgeCount;
+    zeroOneEdges = other.zeroOneEdges;
+    minWeight = other.minWeight;
+    maxWeight = other.maxWeight;
+    weightCounts = move(other.weightCounts);
+    categories = move(other.categories);
+    version = other.version;
+    topologyVersion = other.topologyVersion;
+    // without its storage other must not claim any vertex, neighbors() would read through null
+    other.n = 0;
+    other.negativeEdges = 0;
+    other.edgeCount = 0;
+    other.zeroOneEdges = 0;
+    other.minWeight = INT_MAX;
+    other.maxWeight = INT_MIN;
+    other.weightCounts.clear();
+    other.categories.clear();
+    other.version = 0;
+    other.topologyVersion = 0;
+    return *this;
+}
+
+size_t Graph::memoryBytes() const {
+    if (!storage) return 0;
+    size_t bytes = storage->adjList.capacity() * sizeof(pmr::vector<Edge>);
+    for (const auto& edges : storage->adjList) bytes += edges.capacity() * sizeof(Edge);
+    return bytes;
+}
+
+Graph Graph::placed(const PlacementOptions& options, int node) const {
+    return Graph(*this, make_shared<PlacedMemory>(options.hugePages, options.numa, node));
+}
+
+PlacementReport Graph::placementReport() const {
+    if (storage && storage->placement) return storage->placement->report();
+    PlacementReport report;
+    report.bytes = (long long)memoryBytes();
+    return report;
+}
+
+void Graph::setCategories(int vertex, uint64_t mask) {
+    if (vertex < 0 || vertex >= n) return;
+    if (categories.empty()) {
+        if (mask == 0) return;
+        categories.assign(n, 0);
+    }
+    categories[vertex] = mask;
+}
+
+vector<int> Graph::degrees() const {
+    vector<int> result(n);
+    for (int v = 0; v < n; v++) result[v] = static_cast<int>(storage->adjList[v].size());
+    return result;
+}
 
 // method for adding edges to the graph
 // from - starting vertex
@@ -13,8 +128,89 @@ Graph::Graph(const int& n) : n(n), adjList(n) {}
 // weight - weight of the edge
 void Graph::addEdge(int from, int to, int weight) {
     if (from >= 0 && from < n && to >= 0 && to < n) {
-        adjList[from].push_back({to, weight});
+        // a full list reallocates, in the arena its old block would stay allocated
+        if (!storage->pool && storage->adjList[from].size() == storage->adjList[from].capacity()) makeGrowing();
+        storage->adjList[from].push_back({to, weight});
+        countEdge(weight, +1);
+        version++;
+        topologyVersion++;
+    }
+}
+
+void Graph::countEdge(int weight, int sign) {
+    if (weight < 0) negativeEdges += sign;
+    if (weight == 0 || weight == 1) zeroOneEdges += sign;
+    edgeCount += sign;
+    if (sign > 0) {
+        minWeight = min(minWeight, weight);
+        maxWeight = max(maxWeight, weight);
+        if (!weightCounts.empty()) weightCounts[weight]++;
+        return;
+    }
+    if (!weightCounts.empty()) {
+        auto it = weightCounts.find(weight);
+        if (--it->second == 0) weightCounts.erase(it);
+    } else if (weight == minWeight || weight == maxWeight) {
+        // removed edge may have been the only one with this weight, the lists already miss it
+        for (const auto& list : storage->adjList) {
+            for (const Edge& edge : list) weightCounts[edge.weight]++;
+        }
+    } else {
+        return;
+    }
+    minWeight = weightCounts.empty() ? INT_MAX : weightCounts.begin()->first;
+    maxWeight = weightCounts.empty() ? INT_MIN : weightCounts.rbegin()->first;
+}
+
+void Graph::makeGrowing() {
+    auto grown = make_unique<Storage>(0, storage->placement, true);
+    grown->adjList.resize(n);
+    for (int v = 0; v < n; v++) {
+        grown->adjList[v].assign(storage->adjList[v].begin(), storage->adjList[v].end());
+    }
+    storage = move(grown);
+}
+
+// index of the cheapest edge from -> to in adjList[from], -1 if there is none
+static int cheapestEdgeIndex(const pmr::vector<Edge>& list, int to) {
+    int best = -1;
+    for (int i = 0; i < (int)list.size(); i++) {
+        if (list[i].to == to && (best == -1 || list[i].weight < list[best].weight)) best = i;
     }
+    return best;
+}
+
+bool Graph::removeEdge(int from, int to) {
+    if (from < 0 || from >= n) return false;
+    pmr::vector<Edge>& list = storage->adjList[from];
+    int index = cheapestEdgeIndex(list, to);
+    if (index == -1) return false;
+    int weight = list[index].weight;
+    list[index] = list.back();
+    list.pop_back();
+    countEdge(weight, -1);
+    version++;
+    topologyVersion++;
+    return true;
+}
+
+bool Graph::setEdgeWeight(int from, int to, int weight) {
+    if (from < 0 || from >= n) return false;
+    int index = cheapestEdgeIndex(storage->adjList[from], to);
+    if (index == -1) return false;
+    int old = storage->adjList[from][index].weight;
+    // count the new weight first, so a histogram built by countEdge(old, -1) already sees it
+    storage->adjList[from][index].weight = weight;
+    countEdge(weight, +1);
+    countEdge(old, -1);
+    version++;
+    return true;
+}
+
+int Graph::edgeWeight(int from, int to) const {
+    if (from < 0 || from >= n) return INT_MAX;
+    int index = cheapestEdgeIndex(storage->adjList[from], to);
+    return index == -1 ? INT_MAX : storage->adjList[from][index].weight;
 }
 
 // method for getting neighbors of a vertex
@@ -25,7 +221,7 @@ vector<pair<int,int>> Graph::getNeighbors(int vertex) const {
     if (vertex < 0 || vertex >= n) {
         return {{-1,-1}}; // invalid vertex
     }
-    for (auto edge : adjList[vertex]) {
+    for (auto edge : storage->adjList[vertex]) {
         returnValues.push_back({edge.to, edge.weight});
     }
     return returnValues;
@@ -37,6 +233,29 @@ int Graph::getSize() const {
 }
 
 // getter for adjacency list
-const vector<vector<Edge>>& Graph::getAdjList() const {
-    return adjList;
+const AdjacencyList& Graph::getAdjList() const {
+    static const AdjacencyList none; // moved-from graph
+    return storage ? storage->adjList : none;
+}
+
+// true if at least one edge has negative weight
+bool Graph::hasNegativeEdges() const {
+    return negativeEdges > 0;
+}
+
+// graph with every edge turned around
+Graph Graph::reversed() const {
+    // in-degrees first, so the reversed graph is one arena block
+    vector<int> inDegree(n, 0);
+    for (int u = 0; u < n; u++) {
+        for (auto edge : storage->adjList[u]) inDegree[edge.to]++;
+    }
+    Graph reverse(n, inDegree);
+    for (int u = 0; u < n; u++) {
+        for (auto edge : storage->adjList[u]) {
+            reverse.addEdge(edge.to, u, edge.weight);
+        }
+    }
+    reverse.categories = categories;
+    return reverse;
 }
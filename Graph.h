@@ -5,6 +5,12 @@
 #ifndef COURSEWORK_GRAPH_H
 #define COURSEWORK_GRAPH_H
 
+#include "MemoryPlacement.h"
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 using namespace std;
 
@@ -13,13 +19,69 @@ struct Edge {
     int weight;
 };
 
+// adjacency lists live in the graph's own monotonic arena (std::pmr), see Graph(n, degrees)
+using AdjacencyList = pmr::vector<pmr::vector<Edge>>;
+
+// const methods only read the graph, so one Graph can be shared by many query threads
+// as long as nobody calls addEdge at the same time
 class Graph {
 private:
-    vector<vector<Edge>> adjList; // adjacency list representation
+    // arena and lists are allocated together, so moving a Graph just moves one pointer
+    // and the lists never outlive their arena
+    // placed graphs (placed()) take the arena blocks from their own PlacedMemory instead of the heap
+    // growing graphs (Graph(n), or the first addEdge into a full list) keep their lists in a pool instead:
+    // the monotonic arena never frees, so every reallocated list would stay there until the graph dies,
+    // the pool reuses the freed blocks
+    struct Storage {
+        shared_ptr<PlacedMemory> placement; // declared first, it must outlive the arena
+        pmr::monotonic_buffer_resource arena;
+        unique_ptr<pmr::unsynchronized_pool_resource> pool; // nullptr = lists in the arena
+        AdjacencyList adjList; // adjacency list representation
+        explicit Storage(size_t bytes, shared_ptr<PlacedMemory> placement = nullptr, bool growing = false)
+            : placement(move(placement)),
+              arena(bytes, upstream()),
+              pool(growing ? make_unique<pmr::unsynchronized_pool_resource>(upstream()) : nullptr),
+              adjList(pool ? static_cast<pmr::memory_resource*>(pool.get()) : &arena) {}
+        pmr::memory_resource* upstream() const {
+            return placement ? placement.get() : pmr::get_default_resource();
+        }
+    };
+    unique_ptr<Storage> storage;
     int n; // number of vertices
+    int negativeEdges; // number of edges with negative weight
+    // weight profile, updated by addEdge
+    long long edgeCount;
+    long long zeroOneEdges; // edges with weight 0 or 1
+    int minWeight;
+    int maxWeight;
+    // weight -> number of edges, built when the min or max edge is first removed, then kept up to date,
+    // so bulk loading never pays for it and repeated removals find the new min / max in O(log W)
+    map<int, long long> weightCounts;
+    vector<uint64_t> categories; // point of interest categories per vertex, empty = none anywhere
+    // change counters, copies keep them - preprocessed data (ArcFlags, MultiLevelOverlay) remembers the values
+    // it was built for, equal counts alone miss a changed weight or a removed and re-added edge
+    uint64_t version; // every addEdge / removeEdge / setEdgeWeight
+    uint64_t topologyVersion; // addEdge / removeEdge only
+
+    // profile bookkeeping of one edge, sign = +1 added / -1 removed
+    void countEdge(int weight, int sign);
+    // moves the lists from the arena to a pool, once per graph
+    void makeGrowing();
+    // copy of other in a new arena of exactly the needed size
+    Graph(const Graph& other, shared_ptr<PlacedMemory> placement);
 public:
     // init adjlist to n - else segfault
     Graph(const int& n);
+    // degree pre-counting - degrees[v] = out-degree of v, all lists are reserved in one arena block,
+    // so adding exactly these edges does no further allocation
+    Graph(int n, const vector<int>& degrees);
+    // from edges sorted by source (CSR): edges[offsets[v] .. offsets[v + 1]) leave v, offsets has n + 1 items
+    Graph(int n, const vector<long long>& offsets, const vector<Edge>& edges);
+    Graph(const Graph& other);
+    Graph& operator=(const Graph& other);
+    // a moved-from graph is empty (0 vertices, no edges) and may be assigned again
+    Graph(Graph&& other) noexcept;
+    Graph& operator=(Graph&& other) noexcept;
 
     // method for getting neighbors of a vertex
     // returns vector of pairs (neighbor vertex, weight)
@@ -29,13 +91,64 @@ public:
 
     // getters
     int getSize() const;
-    const vector<vector<Edge>>& getAdjList() const;
+    const AdjacencyList& getAdjList() const;
+    // edges leaving vertex, same range interface as CompressedGraph::neighbors
+    const pmr::vector<Edge>& neighbors(int vertex) const { return storage->adjList[vertex]; }
+    // heap memory of the adjacency lists (list headers + reserved edges)
+    size_t memoryBytes() const;
+
+    // copy in memory with huge pages and / or a NUMA policy (options.numa "interleave", or all pages
+    // bound to node >= 0 for one replica, see GraphStore), the graph is read only in the hot loops,
+    // so the placement only pays off for big graphs queried many times
+    Graph placed(const PlacementOptions& options, int node = -1) const;
+    bool isPlaced() const { return storage && storage->placement != nullptr; }
+    // where the adjacency lists of a placed graph actually are (huge pages, bytes per node),
+    // for a graph on the normal heap only bytes is filled
+    PlacementReport placementReport() const;
+
+    // true if at least one edge has negative weight (Dijkstra cannot be used)
+    bool hasNegativeEdges() const;
+
+    // weight profile - decides which engine can be used (see BreadthFirstSearch)
+    long long getEdgeCount() const { return edgeCount; }
+    int getMinWeight() const { return minWeight; } // INT_MAX for a graph without edges
+    int getMaxWeight() const { return maxWeight; } // INT_MIN for a graph without edges
+    // all weights are the same non-negative number - plain BFS, distance = hops * weight
+    bool hasUniformWeights() const { return edgeCount == 0 || (minWeight == maxWeight && minWeight >= 0); }
+    // all weights are 0 or 1 - 0-1 BFS
+    bool hasZeroOneWeights() const { return zeroOneEdges == edgeCount; }
+
+    // bumped by every edge change / by the changes of the edge set (and order) only, see version
+    uint64_t getVersion() const { return version; }
+    uint64_t getTopologyVersion() const { return topologyVersion; }
+
+    // point of interest categories - bit c of the mask = vertex has category c (0 .. 63)
+    // no vertex has any category until the first setCategories, copies and reversed() keep them
+    void setCategories(int vertex, uint64_t mask);
+    uint64_t getCategories(int vertex) const { return categories.empty() ? 0 : categories[vertex]; }
+    bool hasCategories() const { return !categories.empty(); }
+
+    // out-degree of every vertex
+    vector<int> degrees() const;
+
+    // graph with every edge turned around (u -> v becomes v -> u), used for backward searches
+    Graph reversed() const;
 
     // method for adding edges to the graph
+    // (adding to a full list of an arena graph first moves all lists to a pool, O(V + E) once)
     // from - starting vertex
     // to - ending vertex
     // weight - weight of the edge
     void addEdge(int from, int to, int weight);
+
+    // mutation API - with parallel edges from -> to the cheapest one is changed,
+    // that is the one shortest paths go through
+    // both return false if there is no edge from -> to
+    // (the first removal of the min or max weight builds the weight histogram in O(E), later ones are O(log W))
+    bool removeEdge(int from, int to);
+    bool setEdgeWeight(int from, int to, int weight);
+    // weight of the cheapest edge from -> to, INT_MAX if there is none
+    int edgeWeight(int from, int to) const;
 };
 
 #endif //COURSEWORK_GRAPH_H
@@ -0,0 +1,244 @@
+//
+// Created by filip on 2.11.2025.
+//
+
+#include "GraphGenerator.h"
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+using namespace std;
+
+// size of text/binary buffer before it is written to the file
+static const size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+// helper - random weight in [minWeight, maxWeight]
+static int randomWeight(mt19937_64& rng, int minWeight, int maxWeight) {
+    return uniform_int_distribution<int>(minWeight, maxWeight)(rng);
+}
+
+int GraphGenerator::generate(const GeneratorOptions& options, const EdgeSink& sink) {
+    if (options.type == "er") {
+        erdosRenyi(options.vertices, options.edges, options.minWeight, options.maxWeight, options.seed, sink);
+        return options.vertices;
+    }
+    if (options.type == "grid") {
+        if ((long long)options.rows * options.cols > INT_MAX) return -1;
+        grid(options.rows, options.cols, options.minWeight, options.maxWeight, options.seed, sink);
+        return options.rows * options.cols;
+    }
+    if (options.type == "rmat") {
+        rmat(options.scale, options.edges, options.minWeight, options.maxWeight, options.seed, sink);
+        return 1 << options.scale;
+    }
+    if (options.type == "dag") {
+        dag(options.vertices, options.edges, options.minWeight, options.maxWeight, options.seed, sink);
+        return options.vertices;
+    }
+    if (options.type == "negative") {
+        negativeNoCycle(options.vertices, options.edges, options.minWeight, options.maxWeight, options.seed, sink);
+        return options.vertices;
+    }
+    return -1;
+}
+
+bool GraphGenerator::setOption(GeneratorOptions& options, const string& argument, const string& value) {
+    if (argument == "--type") options.type = value;
+    else if (argument == "--vertices") options.vertices = stoi(value);
+    else if (argument == "--edges") options.edges = stoll(value);
+    else if (argument == "--rows") options.rows = stoi(value);
+    else if (argument == "--cols") options.cols = stoi(value);
+    else if (argument == "--scale") options.scale = stoi(value);
+    else if (argument == "--min-weight") options.minWeight = stoi(value);
+    else if (argument == "--max-weight") options.maxWeight = stoi(value);
+    else if (argument == "--seed") options.seed = stoull(value);
+    else return false;
+    return true;
+}
+
+Graph GraphGenerator::generateGraph(const GeneratorOptions& options) {
+    // vertex count is known before the first edge for every generator type
+    int vertices = 0;
+    if (options.type == "grid") {
+        if ((long long)options.rows * options.cols > INT_MAX) return Graph(0);
+        vertices = options.rows * options.cols;
+    }
+    else if (options.type == "rmat") vertices = 1 << options.scale;
+    else vertices = options.vertices;
+
+    // edges are buffered to count degrees, so the graph is built in one arena block
+    vector<int> triples;
+    generate(options, [&triples](int from, int to, int weight) {
+        triples.push_back(from);
+        triples.push_back(to);
+        triples.push_back(weight);
+    });
+    vector<int> degrees(vertices, 0);
+    for (size_t i = 0; i < triples.size(); i += 3) degrees[triples[i]]++;
+    Graph g(vertices, degrees);
+    for (size_t i = 0; i < triples.size(); i += 3) g.addEdge(triples[i], triples[i + 1], triples[i + 2]);
+    return g;
+}
+
+void GraphGenerator::erdosRenyi(int n, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink) {
+    if (n < 2) return;
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> vertex(0, n - 1);
+    for (long long i = 0; i < m; i++) {
+        int u = vertex(rng);
+        int v = vertex(rng);
+        while (v == u) v = vertex(rng); // no self loops
+        sink(u, v, randomWeight(rng, minWeight, maxWeight));
+    }
+}
+
+void GraphGenerator::grid(int rows, int cols, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink) {
+    if ((long long)rows * cols > INT_MAX) return;
+    mt19937_64 rng(seed);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int u = r * cols + c;
+            // right neighbour
+            if (c + 1 < cols) {
+                int w = randomWeight(rng, minWeight, maxWeight);
+                sink(u, u + 1, w);
+                sink(u + 1, u, w);
+            }
+            // bottom neighbour
+            if (r + 1 < rows) {
+                int w = randomWeight(rng, minWeight, maxWeight);
+                sink(u, u + cols, w);
+                sink(u + cols, u, w);
+            }
+        }
+    }
+}
+
+void GraphGenerator::rmat(int scale, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink,
+                          double a, double b, double c) {
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    for (long long i = 0; i < m; i++) {
+        int u = 0, v = 0;
+        // pick one quadrant of the adjacency matrix per bit
+        for (int bit = 0; bit < scale; bit++) {
+            double p = coin(rng);
+            if (p < a) {
+                // top left - nothing to set
+            } else if (p < a + b) {
+                v |= 1 << bit;
+            } else if (p < a + b + c) {
+                u |= 1 << bit;
+            } else {
+                u |= 1 << bit;
+                v |= 1 << bit;
+            }
+        }
+        if (u == v) { i--; continue; } // skip self loops, keep number of edges
+        sink(u, v, randomWeight(rng, minWeight, maxWeight));
+    }
+}
+
+void GraphGenerator::dag(int n, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink) {
+    if (n < 2) return;
+    mt19937_64 rng(seed);
+    // hidden topological order - position i is vertex order[i]
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rng);
+
+    uniform_int_distribution<int> position(0, n - 1);
+    for (long long i = 0; i < m; i++) {
+        int x = position(rng);
+        int y = position(rng);
+        while (y == x) y = position(rng);
+        if (x > y) swap(x, y);
+        sink(order[x], order[y], randomWeight(rng, minWeight, maxWeight));
+    }
+}
+
+void GraphGenerator::negativeNoCycle(int n, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink) {
+    if (n < 2) return;
+    mt19937_64 rng(seed);
+    // potentials are in the same range as weights, so roughly half of the edges end up negative
+    vector<int> potential(n);
+    for (int v = 0; v < n; v++) potential[v] = randomWeight(rng, 0, max(maxWeight, 1));
+
+    // base weights must be non-negative, otherwise negative cycles could appear
+    int low = max(minWeight, 0);
+    int high = max(maxWeight, low);
+    uniform_int_distribution<int> vertex(0, n - 1);
+    for (long long i = 0; i < m; i++) {
+        int u = vertex(rng);
+        int v = vertex(rng);
+        while (v == u) v = vertex(rng);
+        int w = randomWeight(rng, low, high);
+        sink(u, v, w + potential[u] - potential[v]);
+    }
+}
+
+// ----------------------------- EdgeFileWriter -----------------------------
+
+// helper - append decimal number followed by separator
+static void appendNumber(string& buffer, int value, char separator) {
+    char digits[16];
+    auto result = to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+    buffer.push_back(separator);
+}
+
+EdgeFileWriter::EdgeFileWriter(const string& filename, bool binary) : binary(binary), edgeCount(0) {
+    file = fopen(filename.c_str(), "wb");
+    buffer.reserve(WRITE_BUFFER_SIZE + 64);
+    if (file && binary) {
+        // placeholder header, real counts are written in close()
+        int vertices = 0;
+        long long edges = 0;
+        fwrite("PCCG", 1, 4, file);
+        fwrite(&vertices, sizeof(vertices), 1, file);
+        fwrite(&edges, sizeof(edges), 1, file);
+    }
+}
+
+EdgeFileWriter::~EdgeFileWriter() {
+    if (file) fclose(file);
+}
+
+bool EdgeFileWriter::isOpen() const {
+    return file != nullptr;
+}
+
+void EdgeFileWriter::write(int from, int to, int weight) {
+    if (binary) {
+        int triple[3] = {from, to, weight};
+        buffer.append(reinterpret_cast<const char*>(triple), sizeof(triple));
+    } else {
+        appendNumber(buffer, from, ' ');
+        appendNumber(buffer, to, ' ');
+        appendNumber(buffer, weight, '\n');
+    }
+    edgeCount++;
+    if (buffer.size() >= WRITE_BUFFER_SIZE) {
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+}
+
+void EdgeFileWriter::close(int vertices) {
+    if (!file) return;
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+    if (binary) {
+        fseek(file, 4, SEEK_SET);
+        fwrite(&vertices, sizeof(vertices), 1, file);
+        fwrite(&edgeCount, sizeof(edgeCount), 1, file);
+    }
+    fclose(file);
+    file = nullptr;
+}
+
+long long EdgeFileWriter::getEdgeCount() const {
+    return edgeCount;
+}
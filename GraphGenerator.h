@@ -0,0 +1,89 @@
+//
+// Created by filip on 2.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_GRAPHGENERATOR_H
+#define PCC_SEMESTRALKA_GRAPHGENERATOR_H
+#pragma once
+#include "Graph.h"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+using namespace std;
+
+// callback receiving generated edges one by one (from, to, weight)
+// generators never keep the edge list in memory, so huge graphs can be streamed to disk
+using EdgeSink = function<void(int, int, int)>;
+
+// all settings of the generator, unused fields are ignored by the chosen type
+struct GeneratorOptions {
+    string type = "er";      // er | grid | rmat | dag | negative
+    int vertices = 1000;     // er, dag, negative
+    long long edges = 5000;  // er, rmat, dag, negative
+    int rows = 32;           // grid
+    int cols = 32;           // grid
+    int scale = 10;          // rmat - graph has 2^scale vertices
+    int minWeight = 1;
+    int maxWeight = 100;
+    uint64_t seed = 1;
+};
+
+class GraphGenerator {
+public:
+    // generate graph described by options and push every edge to sink
+    // returns number of vertices of the generated graph, -1 for unknown type or a grid over INT_MAX vertices
+    static int generate(const GeneratorOptions& options, const EdgeSink& sink);
+
+    // set option from command line argument (e.g. "--edges", "5000")
+    // returns false if argument is not a generator option, throws on invalid number
+    static bool setOption(GeneratorOptions& options, const string& argument, const string& value);
+
+    // generate graph directly into memory (handy for tests and benchmarks)
+    // options generate() rejects give an empty graph (0 vertices)
+    static Graph generateGraph(const GeneratorOptions& options);
+
+    // Erdos-Renyi G(n, m) - m uniformly random edges without self loops
+    static void erdosRenyi(int n, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink);
+
+    // 2D grid rows x cols, every cell connected with its 4 neighbours in both directions
+    // both directions of one "road" get the same random weight
+    // nothing is generated for more than INT_MAX vertices (vertex ids are int)
+    static void grid(int rows, int cols, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink);
+
+    // R-MAT (recursive matrix / Kronecker) power-law graph with 2^scale vertices
+    // a, b, c are the quadrant probabilities, d = 1 - a - b - c
+    static void rmat(int scale, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink,
+                     double a = 0.57, double b = 0.19, double c = 0.19);
+
+    // random DAG - edges go forward in a random hidden topological order
+    static void dag(int n, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink);
+
+    // random graph with negative edges but without negative cycles
+    // weights are w + p[u] - p[v] for random potential p, so every cycle keeps its non-negative sum
+    static void negativeNoCycle(int n, long long m, int minWeight, int maxWeight, uint64_t seed, const EdgeSink& sink);
+};
+
+// writer for generated edges
+// text format - one "u v w" per line (same as loadGraphFromFile)
+// binary format - header "PCCG", int32 vertices, int64 edges, then int32 triples u v w (little endian)
+class EdgeFileWriter {
+private:
+    FILE* file;
+    bool binary;
+    long long edgeCount;
+    string buffer;
+public:
+    EdgeFileWriter(const string& filename, bool binary);
+    ~EdgeFileWriter();
+
+    bool isOpen() const;
+    void write(int from, int to, int weight);
+
+    // flush data and patch binary header, vertices - final number of vertices
+    void close(int vertices);
+
+    long long getEdgeCount() const;
+};
+
+#endif //PCC_SEMESTRALKA_GRAPHGENERATOR_H
@@ -0,0 +1,653 @@
+//
+// Created by filip on 26.11.2025.
+//
+
+#include "GraphLoader.h"
+#include "ThreadPool.h"
+#include "CompressedInput.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// whole file as one read only block of memory, mapped if possible
+class FileView {
+private:
+    const char* begin = nullptr;
+    size_t length = 0;
+    string buffer; // used when the file is not mapped
+    bool mapped = false;
+public:
+    explicit FileView(const string& filename) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                madvise(address, info.st_size, MADV_SEQUENTIAL);
+                begin = static_cast<const char*>(address);
+                length = info.st_size;
+                mapped = true;
+            }
+        }
+        if (fd >= 0) close(fd);
+        if (mapped) return;
+#endif
+        ifstream fin(filename, ios::binary);
+        if (!fin) { cerr << "Cannot open file " << filename << endl; exit(1); }
+        buffer.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+        begin = buffer.data();
+        length = buffer.size();
+    }
+    ~FileView() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped) munmap(const_cast<char*>(begin), length);
+#endif
+    }
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+};
+
+// edges of one chunk in file order, split by source vertex: buckets[u % ranges] holds u v w u v w ...
+// of the edges whose source u belongs to that range, so buildGraph can give every worker its own vertices
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    vector<vector<int>> buckets;
+    bool stopped = false;  // hit a token that is not a number, later chunks are ignored
+    int maxVertex = -1;
+    int values[3];         // triple in progress, continues in the next parseChunk call on the same chunk
+    int count = 0;
+};
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// whitespace separated integers until the end of the chunk or the first bad token
+// [begin, end) must not end inside a number
+// edges with a negative vertex are not kept (they still count for maxVertex, as before)
+static void parseChunk(Chunk& chunk, int ranges) {
+    const char* p = chunk.begin;
+    int* values = chunk.values;
+    int& count = chunk.count;
+    if (chunk.buckets.empty()) {
+        chunk.buckets.resize(ranges);
+        // rough guess of 12 bytes per edge, avoids most reallocations
+        for (vector<int>& bucket : chunk.buckets) bucket.reserve((chunk.end - chunk.begin) / 4 / ranges);
+    }
+    while (true) {
+        while (p < chunk.end && isSpace(*p)) p++;
+        if (p == chunk.end) break;
+        if (*p == '+') p++; // operator>> accepts a plus sign, from_chars does not
+        auto [next, error] = from_chars(p, chunk.end, values[count]);
+        if (error != errc()) {
+            chunk.stopped = true;
+            break;
+        }
+        p = next;
+        if (++count == 3) {
+            count = 0;
+            chunk.maxVertex = max(chunk.maxVertex, max(values[0], values[1]));
+            if (values[0] >= 0 && values[1] >= 0) {
+                vector<int>& bucket = chunk.buckets[values[0] % ranges];
+                bucket.insert(bucket.end(), values, values + 3);
+            }
+        }
+        // "12abc" - the number is read, the rest fails on the next read, same as operator>>
+        if (p < chunk.end && !isSpace(*p)) {
+            chunk.stopped = true;
+            break;
+        }
+    }
+}
+
+// run body(i) for i in [0, count) on the pool and wait
+static void parallelFor(ThreadPool& pool, int count, const function<void(int)>& body) {
+    for (int i = 0; i < count; i++) pool.submit([&body, i](int) { body(i); });
+    pool.wait();
+}
+
+// counting sort of the parsed chunks by source vertex into one CSR array, then the graph
+// worker r owns the vertices u % ranges == r: it counts them in its own array indexed by u / ranges and
+// later scatters their edges, so the counts take O(n) memory in total, not O(n) per chunk;
+// it walks the chunks in file order, so every list keeps the order of the file
+static Graph buildGraph(vector<Chunk>& chunks, ThreadPool& pool, int ranges, long long& totalEdges) {
+    int maxVertex = -1;
+    for (const Chunk& chunk : chunks) maxVertex = max(maxVertex, chunk.maxVertex);
+    int n = maxVertex + 1;
+    // cursor[r][u / ranges] = out-degree of u, later the next write position of u
+    vector<vector<long long>> cursor(ranges);
+    parallelFor(pool, ranges, [&](int r) {
+        cursor[r].assign(n / ranges + 1, 0);
+        for (const Chunk& chunk : chunks) {
+            if (chunk.buckets.empty()) continue; // dropped after a bad token
+            const vector<int>& triples = chunk.buckets[r];
+            for (size_t i = 0; i < triples.size(); i += 3) cursor[r][triples[i] / ranges]++;
+        }
+    });
+    // exclusive prefix sum of the degrees, contiguous vertex blocks first in parallel, then their bases
+    vector<long long> offsets(n + 1, 0);
+    vector<long long> blockTotal(ranges, 0);
+    auto blockBegin = [n, ranges](int b) { return (int)((long long)n * b / ranges); };
+    parallelFor(pool, ranges, [&](int b) {
+        long long running = 0;
+        for (int v = blockBegin(b); v < blockBegin(b + 1); v++) {
+            offsets[v] = running;
+            running += cursor[v % ranges][v / ranges];
+        }
+        blockTotal[b] = running;
+    });
+    vector<long long> blockBase(ranges, 0);
+    for (int b = 1; b < ranges; b++) blockBase[b] = blockBase[b - 1] + blockTotal[b - 1];
+    totalEdges = ranges > 0 ? blockBase[ranges - 1] + blockTotal[ranges - 1] : 0;
+    parallelFor(pool, ranges, [&](int b) {
+        for (int v = blockBegin(b); v < blockBegin(b + 1); v++) offsets[v] += blockBase[b];
+    });
+    offsets[n] = totalEdges;
+
+    // stable scatter, every worker writes only to the lists of its own vertices
+    vector<Edge> edges(totalEdges);
+    parallelFor(pool, ranges, [&](int r) {
+        vector<long long>& position = cursor[r];
+        for (int v = r; v < n; v += ranges) position[v / ranges] = offsets[v];
+        for (Chunk& chunk : chunks) {
+            if (chunk.buckets.empty()) continue;
+            vector<int>& triples = chunk.buckets[r];
+            for (size_t i = 0; i < triples.size(); i += 3)
+                edges[position[triples[i] / ranges]++] = {triples[i + 1], triples[i + 2]};
+            vector<int>().swap(triples); // free the text buffer early
+        }
+        vector<long long>().swap(position);
+    });
+    return Graph(n, offsets, edges);
+}
+
+// whole decompressed text into one chunk on this thread, for triples spread over several lines
+static void parseCompressedSequential(const string& filename, int threads, Chunk& chunk, long long& bytes) {
+    CompressedInput input(filename);
+    vector<char> block, carry; // carry - unfinished number at the end of the previous block
+    bytes = 0;
+    while (!chunk.stopped && input.nextBlock(block)) {
+        bytes += block.size();
+        if (!carry.empty()) block.insert(block.begin(), carry.begin(), carry.end());
+        size_t cut = block.size();
+        while (cut > 0 && !isSpace(block[cut - 1])) cut--;
+        chunk.begin = block.data();
+        chunk.end = block.data() + cut;
+        parseChunk(chunk, threads);
+        carry.assign(block.begin() + cut, block.end());
+    }
+    if (!chunk.stopped && !carry.empty()) {
+        chunk.begin = carry.data();
+        chunk.end = carry.data() + carry.size();
+        parseChunk(chunk, threads);
+    }
+}
+
+// .gz / .zst text - the decompression thread fills blocks, this thread cuts every block at newlines into
+// one piece per worker and the pool parses the pieces while the next block is decompressed,
+// so parsing scales with the threads like loadText and only decompression is sequential
+static Graph loadCompressedText(const string& filename, int threads, LoadStats* stats) {
+    auto startTime = chrono::steady_clock::now();
+    // a full queue blocks this thread and then the decompression, only a few blocks wait in memory
+    ThreadPool pool(threads, 2 * (size_t)threads);
+    deque<Chunk> pieces; // file order, references stay valid while pieces are added
+    long long bytes = 0, compressed = 0;
+    double waited = 0;
+    {
+        CompressedInput input(filename);
+        vector<char> block, carry; // carry - unfinished line at the end of the previous block
+        auto submit = [&](const shared_ptr<vector<char>>& text, size_t from, size_t to) {
+            pieces.emplace_back();
+            Chunk& piece = pieces.back();
+            piece.begin = text->data() + from;
+            piece.end = text->data() + to;
+            // the task keeps its block alive until the piece is parsed
+            pool.submit([&piece, text, threads](int) { parseChunk(piece, threads); });
+        };
+        while (input.nextBlock(block)) {
+            bytes += block.size();
+            auto text = make_shared<vector<char>>(move(carry));
+            text->insert(text->end(), block.begin(), block.end());
+            size_t cut = text->size();
+            while (cut > 0 && (*text)[cut - 1] != '\n') cut--;
+            carry.assign(text->begin() + cut, text->end());
+            // pieces end at a newline, like the chunks of loadText
+            size_t position = 0;
+            for (int c = 0; c < threads && position < cut; c++) {
+                size_t boundary = c + 1 == threads ? cut : max(position, cut / threads * (c + 1));
+                while (boundary < cut && (*text)[boundary] != '\n') boundary++;
+                if (boundary < cut) boundary++;
+                submit(text, position, boundary);
+                position = boundary;
+            }
+        }
+        if (!carry.empty()) {
+            size_t size = carry.size();
+            submit(make_shared<vector<char>>(move(carry)), 0, size);
+        }
+        pool.wait();
+        waited = input.waitSeconds();
+        compressed = input.compressedBytes();
+    }
+    // a triple split over a piece boundary means one edge per line was not kept, parse sequentially
+    bool split = false;
+    for (size_t c = 0; c + 1 < pieces.size(); c++) split |= pieces[c].count != 0 && !pieces[c].stopped;
+    if (split) {
+        pieces.assign(1, Chunk());
+        parseCompressedSequential(filename, threads, pieces[0], bytes);
+    }
+    // the sequential parser stops at the first bad token, so everything after it is dropped
+    for (size_t c = 0; c < pieces.size(); c++) {
+        if (pieces[c].stopped) {
+            pieces.erase(pieces.begin() + c + 1, pieces.end());
+            break;
+        }
+    }
+    vector<Chunk> chunks(make_move_iterator(pieces.begin()), make_move_iterator(pieces.end()));
+    auto parseTime = chrono::steady_clock::now();
+
+    long long totalEdges = 0;
+    Graph graph = buildGraph(chunks, pool, threads, totalEdges);
+    auto buildTime = chrono::steady_clock::now();
+
+    if (stats) {
+        stats->bytes = bytes;
+        stats->compressedBytes = compressed;
+        stats->edges = totalEdges;
+        stats->threads = threads;
+        stats->readSeconds = waited;
+        stats->parseSeconds = chrono::duration<double>(parseTime - startTime).count() - waited;
+        stats->buildSeconds = chrono::duration<double>(buildTime - parseTime).count();
+        stats->totalSeconds = chrono::duration<double>(buildTime - startTime).count();
+    }
+    return graph;
+}
+
+Graph GraphLoader::loadText(const string& filename, int threads, LoadStats* stats) {
+    auto startTime = chrono::steady_clock::now();
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    if (!CompressedInput::compression(filename).empty()) return loadCompressedText(filename, threads, stats);
+    FileView file(filename);
+    auto readTime = chrono::steady_clock::now();
+
+    // chunk boundaries moved forward to the next newline
+    vector<Chunk> chunks(threads);
+    const char* end = file.data() + file.size();
+    const char* position = file.data();
+    for (int c = 0; c < threads; c++) {
+        const char* boundary = c + 1 == threads ? end : file.data() + file.size() / threads * (c + 1);
+        boundary = max(boundary, position);
+        while (boundary < end && *boundary != '\n') boundary++;
+        if (boundary < end) boundary++;
+        chunks[c].begin = position;
+        chunks[c].end = boundary;
+        position = boundary;
+    }
+
+    ThreadPool pool(threads, threads);
+    parallelFor(pool, threads, [&chunks, threads](int c) { parseChunk(chunks[c], threads); });
+    // chunks end at a newline, a triple split over the boundary means one edge per line was not kept
+    bool split = false;
+    for (int c = 0; c + 1 < threads; c++) split |= chunks[c].count != 0 && !chunks[c].stopped;
+    if (split) {
+        // triples over several lines, parse the whole file sequentially like operator>> does
+        chunks.assign(threads, Chunk());
+        for (Chunk& chunk : chunks) chunk.begin = chunk.end = end;
+        chunks[0].begin = file.data();
+        parseChunk(chunks[0], threads);
+    }
+    // the sequential parser stops at the first bad token, so everything after it is dropped
+    for (int c = 0; c < threads; c++) {
+        if (chunks[c].stopped) {
+            for (int later = c + 1; later < threads; later++) chunks[later] = Chunk();
+            break;
+        }
+    }
+    auto parseTime = chrono::steady_clock::now();
+
+    long long totalEdges = 0;
+    Graph graph = buildGraph(chunks, pool, threads, totalEdges);
+    auto buildTime = chrono::steady_clock::now();
+
+    if (stats) {
+        stats->bytes = file.size();
+        stats->edges = totalEdges;
+        stats->threads = threads;
+        stats->readSeconds = chrono::duration<double>(readTime - startTime).count();
+        stats->parseSeconds = chrono::duration<double>(parseTime - readTime).count();
+        stats->buildSeconds = chrono::duration<double>(buildTime - parseTime).count();
+        stats->totalSeconds = chrono::duration<double>(buildTime - startTime).count();
+    }
+    return graph;
+}
+
+// ---- header based formats ----
+
+// line by line reader that remembers the line number for error messages
+// compressed files are read through CompressedInput
+class LineReader {
+private:
+    unique_ptr<CompressedInput> compressed;
+    ifstream file;
+    istream fin;
+    string filename;
+    long long number = 0;
+    long long bytes = 0;
+    long long diskBytes = 0;
+public:
+    string line;
+
+    explicit LineReader(const string& filename) : fin(nullptr), filename(filename) {
+        ifstream probe(filename, ios::binary | ios::ate);
+        if (probe) diskBytes = max<long long>(0, (long long)probe.tellg());
+        if (!CompressedInput::compression(filename).empty()) {
+            compressed = make_unique<CompressedInput>(filename);
+            fin.rdbuf(compressed.get());
+            return;
+        }
+        file.open(filename);
+        if (!file) { cerr << "Cannot open file " << filename << endl; exit(1); }
+        fin.rdbuf(file.rdbuf());
+    }
+    bool next() {
+        if (!getline(fin, line)) return false;
+        number++;
+        bytes += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return true;
+    }
+    [[noreturn]] void fail(const string& format, const string& message) const {
+        cerr << "Invalid " << format << " file " << filename << " (line " << number << "): " << message << endl;
+        exit(1);
+    }
+    long long bytesRead() const { return bytes; }
+    // items to reserve for a header count, at most one per minBytes of the file: a corrupt header must not
+    // reserve gigabytes (bad_alloc instead of an error message); compressed files hold more text than
+    // their size, their buffers just grow past the reservation
+    size_t reservation(long long count, long long minBytes) const {
+        return (size_t)max(0LL, min(count, diskBytes / minBytes + 1));
+    }
+};
+
+// next whitespace separated integer of [p, end), false at the end or on a bad token
+static bool readNumber(const char*& p, const char* end, long long& value) {
+    while (p < end && isSpace(*p)) p++;
+    if (p == end) return false;
+    if (*p == '+') p++;
+    auto [next, error] = from_chars(p, end, value);
+    if (error != errc() || (next < end && !isSpace(*next))) return false;
+    p = next;
+    return true;
+}
+
+static bool atLineEnd(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) p++;
+    return p == end;
+}
+
+static void fillStats(LoadStats* stats, long long bytes, long long edges, chrono::steady_clock::time_point start,
+                      chrono::steady_clock::time_point parsed) {
+    if (!stats) return;
+    auto done = chrono::steady_clock::now();
+    stats->bytes = bytes;
+    stats->edges = edges;
+    stats->threads = 1;
+    stats->readSeconds = 0; // streamed, reading is part of parsing
+    stats->parseSeconds = chrono::duration<double>(parsed - start).count();
+    stats->buildSeconds = chrono::duration<double>(done - parsed).count();
+    stats->totalSeconds = chrono::duration<double>(done - start).count();
+}
+
+// arcs buffered as triples, then one arena block sized by the degrees
+static Graph buildFromTriples(int n, const vector<int>& triples) {
+    vector<int> degrees(n, 0);
+    for (size_t i = 0; i < triples.size(); i += 3) degrees[triples[i]]++;
+    Graph graph(n, degrees);
+    for (size_t i = 0; i < triples.size(); i += 3) graph.addEdge(triples[i], triples[i + 1], triples[i + 2]);
+    return graph;
+}
+
+static bool hasExtension(const string& filename, const string& extension) {
+    if (filename.size() < extension.size()) return false;
+    string tail = filename.substr(filename.size() - extension.size());
+    for (char& c : tail) c = (char)tolower((unsigned char)c);
+    return tail == extension;
+}
+
+string GraphLoader::detectFormat(const string& filename) {
+    // .gz / .zst - extension and content of the decompressed file
+    string name = filename;
+    unique_ptr<CompressedInput> compressed;
+    ifstream file;
+    istream fin(nullptr);
+    if (!CompressedInput::compression(filename).empty()) {
+        for (string suffix : {".gz", ".zst"})
+            if (hasExtension(name, suffix)) name.resize(name.size() - suffix.size());
+        compressed = make_unique<CompressedInput>(filename);
+        fin.rdbuf(compressed.get());
+    } else {
+        file.open(filename, ios::binary);
+        fin.rdbuf(file.rdbuf());
+    }
+    string head(4096, '\0');
+    fin.read(&head[0], head.size());
+    head.resize(fin.gcount());
+
+    if (head.compare(0, 4, "PCCG") == 0) return "binary";
+    if (hasExtension(name, ".gr")) return "dimacs";
+    if (hasExtension(name, ".graph") || hasExtension(name, ".metis")) return "metis";
+    if (hasExtension(name, ".mtx")) return "mtx";
+
+    // no known extension - look at the first non-empty line
+    istringstream lines(head);
+    string line;
+    while (getline(lines, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos) continue;
+        if (line.compare(first, 14, "%%MatrixMarket") == 0) return "mtx";
+        if ((line[first] == 'c' || line[first] == 'p') && (line.size() == first + 1 || isSpace(line[first + 1])))
+            return "dimacs";
+        break;
+    }
+    return "text";
+}
+
+Graph GraphLoader::loadDimacs(const string& filename, LoadStats* stats) {
+    auto startTime = chrono::steady_clock::now();
+    LineReader reader(filename);
+    long long n = -1, m = 0;
+    vector<int> triples;
+
+    while (reader.next()) {
+        const string& line = reader.line;
+        const char* p = line.data();
+        const char* end = p + line.size();
+        while (p < end && isSpace(*p)) p++;
+        if (p == end || *p == 'c') continue;
+        if (*p == 'p') {
+            if (n >= 0) reader.fail("DIMACS", "second problem line");
+            string word, kind;
+            istringstream header(line);
+            header >> word >> kind >> n >> m;
+            if (!header || kind != "sp" || n < 0 || n > INT_MAX || m < 0)
+                reader.fail("DIMACS", "expected \"p sp <vertices> <arcs>\"");
+            triples.reserve(3 * reader.reservation(m, 8)); // "a 1 2 3\n" is the shortest arc
+            continue;
+        }
+        if (*p != 'a') reader.fail("DIMACS", "unknown line type");
+        if (n < 0) reader.fail("DIMACS", "arc before the problem line");
+        p++;
+        long long u, v, w;
+        if (!readNumber(p, end, u) || !readNumber(p, end, v) || !readNumber(p, end, w) || !atLineEnd(p, end))
+            reader.fail("DIMACS", "expected \"a <from> <to> <weight>\"");
+        if (u < 1 || u > n || v < 1 || v > n) reader.fail("DIMACS", "vertex out of range");
+        if (w < INT_MIN || w > INT_MAX) reader.fail("DIMACS", "weight out of range");
+        triples.insert(triples.end(), {(int)u - 1, (int)v - 1, (int)w});
+    }
+    if (n < 0) reader.fail("DIMACS", "missing problem line");
+    if ((long long)triples.size() / 3 != m) reader.fail("DIMACS", "header says " + to_string(m) + " arcs, file has " +
+                                                                  to_string(triples.size() / 3));
+    auto parseTime = chrono::steady_clock::now();
+    Graph graph = buildFromTriples((int)n, triples);
+    fillStats(stats, reader.bytesRead(), m, startTime, parseTime);
+    return graph;
+}
+
+Graph GraphLoader::loadMetis(const string& filename, LoadStats* stats) {
+    auto startTime = chrono::steady_clock::now();
+    LineReader reader(filename);
+    long long n = -1, m = 0;
+    bool vertexSizes = false, vertexWeights = false, edgeWeights = false;
+    long long constraints = 0;
+    // vertex lines come in order, so the lists are built directly as CSR
+    vector<long long> offsets;
+    vector<Edge> edges;
+
+    while (reader.next()) {
+        const string& line = reader.line;
+        if (!line.empty() && line[0] == '%') continue;
+        const char* p = line.data();
+        const char* end = p + line.size();
+        if (n < 0) {
+            if (atLineEnd(p, end)) continue;
+            string format;
+            istringstream header(line);
+            header >> n >> m;
+            if (!header || n < 0 || n > INT_MAX || m < 0 || m > LLONG_MAX / 2)
+                reader.fail("METIS", "expected \"<vertices> <edges> [fmt [ncon]]\"");
+            if (header >> format) {
+                if (format.size() > 3 || format.find_first_not_of("01") != string::npos)
+                    reader.fail("METIS", "fmt must be up to three binary digits");
+                format = string(3 - format.size(), '0') + format;
+                vertexSizes = format[0] == '1';
+                vertexWeights = format[1] == '1';
+                edgeWeights = format[2] == '1';
+            }
+            constraints = vertexWeights ? 1 : 0;
+            if (vertexWeights && !(header >> constraints)) constraints = 1;
+            // an empty line is the shortest vertex, "1 " the shortest arc
+            offsets.reserve(reader.reservation(n, 1) + 1);
+            offsets.push_back(0);
+            edges.reserve(reader.reservation(2 * m, 2));
+            continue;
+        }
+        if ((long long)offsets.size() > n) {
+            if (atLineEnd(p, end)) continue;
+            reader.fail("METIS", "more vertex lines than the header says");
+        }
+        // an empty line is a vertex without neighbours
+        if (atLineEnd(p, end)) {
+            offsets.push_back((long long)edges.size());
+            continue;
+        }
+        long long value, weight = 1;
+        long long skip = (vertexSizes ? 1 : 0) + constraints;
+        for (long long i = 0; i < skip; i++)
+            if (!readNumber(p, end, value)) reader.fail("METIS", "missing vertex size or weight");
+        while (readNumber(p, end, value)) {
+            if (value < 1 || value > n) reader.fail("METIS", "vertex out of range");
+            if (edgeWeights && !readNumber(p, end, weight)) reader.fail("METIS", "missing edge weight");
+            if (weight < INT_MIN || weight > INT_MAX) reader.fail("METIS", "weight out of range");
+            edges.push_back({(int)value - 1, (int)weight});
+        }
+        if (!atLineEnd(p, end)) reader.fail("METIS", "expected vertex numbers");
+        offsets.push_back((long long)edges.size());
+    }
+    if (n < 0) reader.fail("METIS", "missing header");
+    // trailing vertices without a line have no neighbours
+    while ((long long)offsets.size() <= n) offsets.push_back((long long)edges.size());
+    if ((long long)edges.size() != 2 * m)
+        reader.fail("METIS", "header says " + to_string(m) + " edges, file has " + to_string(edges.size()) + " arcs");
+    auto parseTime = chrono::steady_clock::now();
+    Graph graph((int)n, offsets, edges);
+    fillStats(stats, reader.bytesRead(), (long long)edges.size(), startTime, parseTime);
+    return graph;
+}
+
+Graph GraphLoader::loadMatrixMarket(const string& filename, LoadStats* stats) {
+    auto startTime = chrono::steady_clock::now();
+    LineReader reader(filename);
+    if (!reader.next()) reader.fail("Matrix Market", "empty file");
+    string banner, object, layout, field, symmetry;
+    istringstream header(reader.line);
+    header >> banner >> object >> layout >> field >> symmetry;
+    for (string* word : {&object, &layout, &field, &symmetry})
+        for (char& c : *word) c = (char)tolower((unsigned char)c);
+    if (banner != "%%MatrixMarket" || object != "matrix") reader.fail("Matrix Market", "missing %%MatrixMarket matrix banner");
+    if (layout != "coordinate") reader.fail("Matrix Market", "only the coordinate layout is a graph");
+    if (field != "integer" && field != "real" && field != "double" && field != "pattern")
+        reader.fail("Matrix Market", "unsupported field " + field);
+    if (symmetry != "general" && symmetry != "symmetric" && symmetry != "skew-symmetric")
+        reader.fail("Matrix Market", "unsupported symmetry " + symmetry);
+    bool pattern = field == "pattern", integer = field == "integer";
+    bool mirrored = symmetry != "general";
+    int mirrorSign = symmetry == "skew-symmetric" ? -1 : 1;
+
+    long long rows = -1, cols = 0, entries = 0, read = 0;
+    vector<int> triples;
+    while (reader.next()) {
+        const string& line = reader.line;
+        if (!line.empty() && line[0] == '%') continue;
+        const char* p = line.data();
+        const char* end = p + line.size();
+        if (atLineEnd(p, end)) continue;
+        if (rows < 0) {
+            if (!readNumber(p, end, rows) || !readNumber(p, end, cols) || !readNumber(p, end, entries) ||
+                !atLineEnd(p, end) || rows < 0 || cols < 0 || max(rows, cols) > INT_MAX || entries < 0)
+                reader.fail("Matrix Market", "expected \"<rows> <cols> <entries>\"");
+            // symmetric files store one triangle, most entries become two arcs
+            triples.reserve(3 * reader.reservation(entries, 4) * (mirrored ? 2 : 1)); // "1 1\n" is the shortest entry
+            continue;
+        }
+        long long i, j, weight = 1;
+        if (!readNumber(p, end, i) || !readNumber(p, end, j)) reader.fail("Matrix Market", "expected \"<row> <col> [value]\"");
+        if (i < 1 || i > rows || j < 1 || j > cols) reader.fail("Matrix Market", "entry out of range");
+        if (integer) {
+            if (!readNumber(p, end, weight)) reader.fail("Matrix Market", "missing integer value");
+        } else if (!pattern) {
+            while (p < end && isSpace(*p)) p++;
+            char* next = nullptr;
+            double value = strtod(p, &next);
+            if (next == p) reader.fail("Matrix Market", "missing value");
+            weight = llround(value);
+            p = next;
+        }
+        if (!atLineEnd(p, end)) reader.fail("Matrix Market", "unexpected text after the entry");
+        if (weight < INT_MIN || weight > INT_MAX) reader.fail("Matrix Market", "weight out of range");
+        // the mirrored arc of a skew-symmetric entry is -weight, which does not fit for INT_MIN
+        if (mirrorSign < 0 && i != j && weight == INT_MIN) reader.fail("Matrix Market", "weight out of range");
+        triples.insert(triples.end(), {(int)i - 1, (int)j - 1, (int)weight});
+        if (mirrored && i != j) triples.insert(triples.end(), {(int)j - 1, (int)i - 1, mirrorSign * (int)weight});
+        read++;
+    }
+    if (rows < 0) reader.fail("Matrix Market", "missing size line");
+    if (read != entries)
+        reader.fail("Matrix Market", "size line says " + to_string(entries) + " entries, file has " + to_string(read));
+    auto parseTime = chrono::steady_clock::now();
+    Graph graph = buildFromTriples((int)max(rows, cols), triples);
+    fillStats(stats, reader.bytesRead(), (long long)triples.size() / 3, startTime, parseTime);
+    return graph;
+}
@@ -0,0 +1,63 @@
+//
+// Created by filip on 26.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_GRAPHLOADER_H
+#define PCC_SEMESTRALKA_GRAPHLOADER_H
+#pragma once
+#include "Graph.h"
+#include <string>
+using namespace std;
+
+// timing of one load, filled by the GraphLoader readers
+struct LoadStats {
+    long long bytes = 0;           // decompressed size for .gz / .zst
+    long long compressedBytes = 0; // 0 for uncompressed files
+    long long edges = 0;
+    int threads = 0;
+    double readSeconds = 0;  // mapping / reading the file, waiting for the decompression thread
+    double parseSeconds = 0; // text -> per-chunk edge buffers
+    double buildSeconds = 0; // counting sort by source + adjacency lists
+    double totalSeconds = 0;
+
+    double gigabytesPerSecond() const { return totalSeconds > 0 ? bytes / totalSeconds / 1e9 : 0; }
+};
+
+// parallel loader of "u v w" text files (same format as loadGraphFromFile)
+// 1. the file is mapped to memory (read into a buffer where mmap is not available)
+// 2. it is split into one newline aligned chunk per thread, every thread parses its chunk
+//    into its own edge buffer and counts out-degrees of its edges
+// 3. counting sort by source - every chunk gets its own write position in each vertex range,
+//    so the scatter runs in parallel and edges keep the file order inside every list
+// 4. the sorted edge array becomes the adjacency lists in one arena block (Graph(n, offsets, edges))
+// like `fin >> u >> v >> w`, parsing stops at the first token that is not a number,
+// edges with a negative vertex are skipped
+// gzip / zstd files (recognized by their magic bytes) are not mapped, a CompressedInput thread
+// decompresses them block by block while the calling thread parses; the build is the same
+// all readers below accept compressed files too
+class GraphLoader {
+public:
+    // threads = 0 uses all cores; exits with an error message if the file can not be opened
+    static Graph loadText(const string& filename, int threads = 0, LoadStats* stats = nullptr);
+
+    // format of a graph file: "binary" (PCCG header), "dimacs", "metis", "mtx" or "text"
+    // known extensions (.gr, .graph / .metis, .mtx) win, otherwise the first line decides
+    // compressed files are judged by the content and name without .gz / .zst
+    static string detectFormat(const string& filename);
+
+    // streaming readers of standard benchmark formats, vertices are 1-based in the file and 0-based
+    // in the graph; edge storage is reserved from the counts in the header before the first edge is read
+    // malformed files end the program with an error message naming the line, like the binary loader
+
+    // DIMACS 9th challenge .gr: "c" comments, "p sp <n> <m>", then arcs "a <u> <v> <w>"
+    static Graph loadDimacs(const string& filename, LoadStats* stats = nullptr);
+    // METIS: "<n> <m> [fmt [ncon]]", then line i lists the neighbours of vertex i, "%" comments
+    // fmt digits: vertex sizes, vertex weights (ncon per vertex, skipped), edge weights (default 1)
+    // the graph is undirected, every edge is on both lines, so it becomes two arcs
+    static Graph loadMetis(const string& filename, LoadStats* stats = nullptr);
+    // Matrix Market coordinate format: entry "i j [value]" is the arc i -> j
+    // field integer / real (rounded) / pattern (weight 1), symmetry general, symmetric or skew-symmetric
+    static Graph loadMatrixMarket(const string& filename, LoadStats* stats = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_GRAPHLOADER_H
@@ -0,0 +1,57 @@
+//
+// Created by filip on 24.11.2025.
+//
+
+#include "GraphStore.h"
+#include <algorithm>
+#include <atomic>
+using namespace std;
+
+// graph of a new version in the memory the options ask for, replicas for the other nodes
+static shared_ptr<GraphVersion> placeVersion(Graph graph, long long version, const PlacementOptions& placement) {
+    if (!placement.hugePages && placement.numa == "local") {
+        return make_shared<GraphVersion>(GraphVersion{move(graph), version, {}});
+    }
+    if (placement.numa != "replicate") {
+        return make_shared<GraphVersion>(GraphVersion{graph.placed(placement), version, {}});
+    }
+    auto placed = make_shared<GraphVersion>(GraphVersion{graph.placed(placement, 0), version, {}});
+    for (int node = 1; node < Numa::nodeCount(); node++) placed->replicas.push_back(graph.placed(placement, node));
+    return placed;
+}
+
+GraphStore::GraphStore(Graph graph, const PlacementOptions& placement)
+    : placement(placement), current(placeVersion(move(graph), 1, placement)) {}
+
+shared_ptr<const GraphVersion> GraphStore::snapshot() const {
+    return atomic_load(&current);
+}
+
+long long GraphStore::update(const function<void(Graph&)>& change) {
+    lock_guard<mutex> guard(writeLock);
+    shared_ptr<const GraphVersion> old = atomic_load(&current);
+    // the copy is made outside of any reader path, queries keep using old meanwhile
+    Graph changed = old->graph;
+    change(changed);
+    shared_ptr<GraphVersion> next = placeVersion(move(changed), old->version + 1, placement);
+    atomic_store(&current, shared_ptr<const GraphVersion>(move(next)));
+    long long version = old->version + 1;
+
+    // nobody can pin a retired version again, use_count 1 means only this list holds it
+    retired.push_back(move(old));
+    retired.erase(remove_if(retired.begin(), retired.end(),
+                            [](const shared_ptr<const GraphVersion>& v) { return v.use_count() == 1; }),
+                  retired.end());
+    return version;
+}
+
+int GraphStore::applyWeightUpdates(const vector<EdgeUpdate>& updates, long long* version) {
+    int applied = 0;
+    long long published = update([&](Graph& graph) {
+        for (const EdgeUpdate& edge : updates) {
+            if (graph.setEdgeWeight(edge.from, edge.to, edge.weight)) applied++;
+        }
+    });
+    if (version) *version = published;
+    return applied;
+}
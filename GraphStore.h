@@ -0,0 +1,66 @@
+//
+// Created by filip on 24.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_GRAPHSTORE_H
+#define PCC_SEMESTRALKA_GRAPHSTORE_H
+#pragma once
+#include "Graph.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+// one immutable version of the graph
+struct GraphVersion {
+    Graph graph;
+    long long version;
+    // numa "replicate": copy for node i + 1 (graph itself is bound to node 0), empty otherwise
+    vector<Graph> replicas;
+
+    // copy of the graph on the given NUMA node, graph if there is none
+    const Graph& local(int node) const {
+        return node <= 0 || node > (int)replicas.size() ? graph : replicas[node - 1];
+    }
+};
+
+// weight change of the (cheapest) edge from -> to, see Graph::setEdgeWeight
+struct EdgeUpdate {
+    int from;
+    int to;
+    int weight;
+};
+
+// versioned graph snapshots for queries running while the graph is updated (read-copy-update)
+// - readers call snapshot() and keep the returned pointer for the whole query, the version they
+//   hold never changes and is freed when the last reader drops it
+// - writers copy the current version, change the copy and publish it with one atomic pointer store,
+//   readers never wait for a writer and never see a half applied update
+// old versions are reclaimed by later updates (or the destructor) as soon as nobody reads them
+// writers are serialized by a mutex, every update copies the whole graph (O(V + E)),
+// so updates should come in batches
+// with PlacementOptions every version is placed again (huge pages, interleaved or one replica per node)
+class GraphStore {
+private:
+    PlacementOptions placement;
+    shared_ptr<const GraphVersion> current; // accessed only through atomic_load / atomic_store
+    mutex writeLock;
+    // replaced versions, freed by the writer once no reader holds them, so a query thread
+    // never pays for destroying a whole graph
+    vector<shared_ptr<const GraphVersion>> retired;
+public:
+    explicit GraphStore(Graph graph, const PlacementOptions& placement = PlacementOptions());
+
+    // current version, safe to call from any thread
+    shared_ptr<const GraphVersion> snapshot() const;
+
+    // copy, change, publish - returns the new version number
+    long long update(const function<void(Graph&)>& change);
+
+    // batch of weight changes in one new version, edges that do not exist are skipped
+    // returns number of applied changes, version is set to the published version
+    int applyWeightUpdates(const vector<EdgeUpdate>& updates, long long* version = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_GRAPHSTORE_H
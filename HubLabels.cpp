@@ -0,0 +1,296 @@
+//
+// Created by filip on 7.12.2025.
+//
+
+#include "HubLabels.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+using namespace std;
+
+// entries compared at once by the query, labels are padded to a multiple of it
+#if defined(__AVX512F__)
+static const int W = 16;
+#elif defined(__AVX2__)
+static const int W = 8;
+#else
+static const int W = 4; // SSE2 / NEON
+#endif
+
+#if defined(__GNUC__)
+typedef int Vec __attribute__((vector_size(W * sizeof(int))));
+typedef unsigned UnsignedVec __attribute__((vector_size(W * sizeof(int))));
+#endif
+
+void HubLabels::LabelSet::append(const vector<pair<int,int>>& label, int sentinel) {
+    if (offsets.empty()) offsets.push_back(0);
+    for (const auto& [hub, distance] : label) {
+        hubs.push_back(hub);
+        distances.push_back(distance);
+    }
+    size_t padded = (label.size() + W - 1) / W * W;
+    hubs.insert(hubs.end(), padded - label.size(), sentinel);
+    distances.insert(distances.end(), padded - label.size(), 0);
+    offsets.push_back(hubs.size());
+    entries += (long long)label.size();
+}
+
+size_t HubLabels::LabelSet::memoryBytes() const {
+    return offsets.capacity() * sizeof(uint64_t) + (hubs.capacity() + distances.capacity()) * sizeof(int);
+}
+
+void HubLabels::setLabels(int vertices, const vector<vector<pair<int,int>>>& outLabels,
+                          const vector<vector<pair<int,int>>>& inLabels) {
+    n = vertices;
+    out = LabelSet();
+    in = LabelSet();
+    long long outEntries = 0, inEntries = 0;
+    for (const auto& label : outLabels) outEntries += (long long)label.size() + W;
+    for (const auto& label : inLabels) inEntries += (long long)label.size() + W;
+    out.hubs.reserve(outEntries);
+    out.distances.reserve(outEntries);
+    in.hubs.reserve(inEntries);
+    in.distances.reserve(inEntries);
+    out.offsets.reserve((size_t)n + 1);
+    in.offsets.reserve((size_t)n + 1);
+    for (int v = 0; v < n; v++) {
+        out.append(outLabels[v], OUT_SENTINEL);
+        in.append(inLabels[v], IN_SENTINEL);
+    }
+}
+
+// Dijkstra from root that does not expand vertices whose distance the existing labels already give
+// covered(u, d) - true if the labels of higher ranked hubs give a path from / to u of length <= d
+// every vertex that is not covered gets (rank, d) into its label
+static void prunedSearch(const Graph& graph, int root, int rank, vector<vector<pair<int,int>>>& labels,
+                         const function<bool(int, int)>& covered, vector<int>& dist, vector<int>& touched,
+                         vector<pair<int,int>>& heap) {
+    dist[root] = 0;
+    touched.push_back(root);
+    heap.push_back({0, root});
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        if (distance > dist[u]) continue;
+        if (covered(u, distance)) continue;
+        labels[u].push_back({rank, distance});
+        for (const Edge& edge : graph.neighbors(u)) {
+            int candidate = distance + edge.weight;
+            if (candidate < dist[edge.to]) {
+                if (dist[edge.to] == INT_MAX) touched.push_back(edge.to);
+                dist[edge.to] = candidate;
+                heap.push_back({candidate, edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+            }
+        }
+    }
+    for (int v : touched) dist[v] = INT_MAX;
+    touched.clear();
+}
+
+// vertices that many shortest paths go through first: shortest path trees from a few sample roots,
+// the score of v is the size of its subtree summed over all trees (a cheap betweenness estimate),
+// ties by degree - on grids and road networks this puts the middle of the map first,
+// a pure degree order gives labels several times longer there
+static vector<int> rankVertices(const Graph& graph, const Graph& reverse) {
+    const int SAMPLES = 32;
+    int n = graph.getSize();
+    vector<long long> score(n, 0);
+    vector<int> dist(n), parent(n), settled;
+    vector<long long> subtree(n);
+    vector<pair<int,int>> heap;
+    for (int sample = 0; sample < min(n, SAMPLES); sample++) {
+        int root = (int)((long long)sample * n / min(n, SAMPLES));
+        fill(dist.begin(), dist.end(), INT_MAX);
+        settled.clear();
+        dist[root] = 0;
+        parent[root] = -1;
+        heap.push_back({0, root});
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+            auto [distance, u] = heap.back();
+            heap.pop_back();
+            if (distance > dist[u]) continue;
+            settled.push_back(u);
+            for (const Edge& edge : graph.neighbors(u)) {
+                if (distance + edge.weight < dist[edge.to]) {
+                    dist[edge.to] = distance + edge.weight;
+                    parent[edge.to] = u;
+                    heap.push_back({dist[edge.to], edge.to});
+                    push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                }
+            }
+        }
+        // children are settled after their parent, so the reverse order sums subtrees bottom up
+        for (int u : settled) subtree[u] = 1;
+        for (auto it = settled.rbegin(); it != settled.rend(); ++it) {
+            score[*it] += subtree[*it];
+            if (parent[*it] != -1) subtree[parent[*it]] += subtree[*it];
+        }
+    }
+    vector<int> order(n);
+    for (int v = 0; v < n; v++) order[v] = v;
+    auto degree = [&](int v) { return graph.neighbors(v).size() + reverse.neighbors(v).size(); };
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        if (score[a] != score[b]) return score[a] > score[b];
+        if (degree(a) != degree(b)) return degree(a) > degree(b);
+        return a < b;
+    });
+    return order;
+}
+
+bool HubLabels::build(const Graph& graph) {
+    *this = HubLabels();
+    if (graph.hasNegativeEdges()) return false;
+    int vertices = graph.getSize();
+    Graph reverse = graph.reversed();
+
+    vector<int> order = rankVertices(graph, reverse);
+
+    vector<vector<pair<int,int>>> outLabels(vertices), inLabels(vertices);
+    vector<int> dist(vertices, INT_MAX), touched;
+    vector<pair<int,int>> heap;
+    // distances of the root to / from its hubs by hub rank, INT_MAX = no such hub
+    vector<int> rootHubs(vertices, INT_MAX);
+    // shortest known path through a hub that both labels contain
+    auto coveredBy = [&](const vector<pair<int,int>>& label, int distance) {
+        for (const auto& [hub, hubDistance] : label) {
+            if (rootHubs[hub] != INT_MAX && (long long)rootHubs[hub] + hubDistance <= distance) return true;
+        }
+        return false;
+    };
+
+    for (int rank = 0; rank < vertices; rank++) {
+        int root = order[rank];
+        // forward: d(root, u) goes into the in label of u
+        for (const auto& [hub, distance] : outLabels[root]) rootHubs[hub] = distance;
+        prunedSearch(graph, root, rank, inLabels,
+                     [&](int u, int distance) { return coveredBy(inLabels[u], distance); }, dist, touched, heap);
+        for (const auto& entry : outLabels[root]) rootHubs[entry.first] = INT_MAX;
+
+        // backward on the reversed graph: d(u, root) goes into the out label of u
+        for (const auto& [hub, distance] : inLabels[root]) rootHubs[hub] = distance;
+        prunedSearch(reverse, root, rank, outLabels,
+                     [&](int u, int distance) { return coveredBy(outLabels[u], distance); }, dist, touched, heap);
+        for (const auto& entry : inLabels[root]) rootHubs[entry.first] = INT_MAX;
+    }
+    setLabels(vertices, outLabels, inLabels);
+    return true;
+}
+
+int HubLabels::distance(int start, int end) const {
+    if (start < 0 || start >= n || end < 0 || end >= n) return INT_MAX;
+    const int* outHubs = out.hubs.data() + out.offsets[start];
+    const int* outDistances = out.distances.data() + out.offsets[start];
+    const int* inHubs = in.hubs.data() + in.offsets[end];
+    const int* inDistances = in.distances.data() + in.offsets[end];
+    size_t outSize = out.offsets[start + 1] - out.offsets[start];
+    size_t inSize = in.offsets[end + 1] - in.offsets[end];
+    size_t i = 0, j = 0;
+#if defined(__GNUC__)
+    // one block of W out entries against one block of W in entries: every in entry is broadcast
+    // and compared with the whole out block, distance sums of equal hubs are kept by a masked min
+    // (unsigned add like BatchedBellmanFord, no signed overflow for long paths)
+    UnsignedVec best = UnsignedVec{} + (unsigned)INT_MAX;
+    while (i < outSize && j < inSize) {
+        int outLast = outHubs[i + W - 1], inLast = inHubs[j + W - 1];
+        // blocks overlap only if neither ends before the other starts
+        if (outLast >= inHubs[j] && inLast >= outHubs[i]) {
+            Vec hubs, distances;
+            memcpy(&hubs, outHubs + i, sizeof(Vec));
+            memcpy(&distances, outDistances + i, sizeof(Vec));
+            for (int k = 0; k < W; k++) {
+                Vec equal = hubs == (Vec{} + inHubs[j + k]);
+                UnsignedVec sum = (UnsignedVec)distances + (unsigned)inDistances[j + k];
+                UnsignedVec take = (UnsignedVec)equal & (UnsignedVec)(sum < best);
+                best = (sum & take) | (best & ~take);
+            }
+        }
+        if (outLast < inLast) i += W;
+        else if (outLast > inLast) j += W;
+        else {
+            i += W;
+            j += W;
+        }
+    }
+    unsigned result = INT_MAX;
+    for (int l = 0; l < W; l++) result = min(result, (unsigned)best[l]);
+    return (int)min<unsigned>(result, INT_MAX);
+#else
+    long long best = INT_MAX;
+    while (i < outSize && j < inSize) {
+        if (outHubs[i] < inHubs[j]) i++;
+        else if (outHubs[i] > inHubs[j]) j++;
+        else best = min(best, (long long)outDistances[i++] + inDistances[j++]);
+    }
+    return (int)best;
+#endif
+}
+
+template <class T>
+static void writeValue(ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+static bool readValue(ifstream& in, T& value) {
+    return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+bool HubLabels::save(const string& filename) const {
+    ofstream file(filename, ios::binary);
+    if (!file) return false;
+    file.write("PCCH", 4);
+    writeValue(file, (int)VERSION);
+    writeValue(file, n);
+    for (const LabelSet* labels : {&out, &in}) {
+        // padding is left out, it is added again by load()
+        int sentinel = labels == &out ? OUT_SENTINEL : IN_SENTINEL;
+        vector<int> sizes(n, 0);
+        for (int v = 0; v < n; v++) {
+            uint64_t e = labels->offsets[v];
+            while (e < labels->offsets[v + 1] && labels->hubs[e] != sentinel) e++;
+            sizes[v] = (int)(e - labels->offsets[v]);
+            writeValue(file, sizes[v]);
+        }
+        for (int v = 0; v < n; v++) {
+            for (uint64_t e = labels->offsets[v]; e < labels->offsets[v] + sizes[v]; e++) {
+                writeValue(file, labels->hubs[e]);
+                writeValue(file, labels->distances[e]);
+            }
+        }
+    }
+    return (bool)file;
+}
+
+bool HubLabels::load(const string& filename) {
+    *this = HubLabels();
+    ifstream file(filename, ios::binary);
+    char magic[4];
+    int version = 0, vertices = 0;
+    if (!file.read(magic, 4) || string(magic, 4) != "PCCH" || !readValue(file, version) || version != VERSION ||
+        !readValue(file, vertices) || vertices < 0) {
+        return false;
+    }
+    vector<vector<pair<int,int>>> labels[2];
+    for (auto& direction : labels) {
+        direction.resize(vertices);
+        vector<int> sizes(vertices);
+        for (int& size : sizes) {
+            if (!readValue(file, size) || size < 0 || size > vertices) return false;
+        }
+        for (int v = 0; v < vertices; v++) {
+            direction[v].resize(sizes[v]);
+            int previous = -1;
+            for (auto& [hub, distance] : direction[v]) {
+                // the query merges labels, so hubs must be sorted
+                if (!readValue(file, hub) || !readValue(file, distance) || hub <= previous || hub >= vertices) return false;
+                previous = hub;
+            }
+        }
+    }
+    setLabels(vertices, labels[0], labels[1]);
+    return true;
+}
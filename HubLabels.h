@@ -0,0 +1,74 @@
+//
+// Created by filip on 7.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_HUBLABELS_H
+#define PCC_SEMESTRALKA_HUBLABELS_H
+#pragma once
+#include "Graph.h"
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// 2-hop distance labels (hub labeling) built by pruned landmark labeling (Akiba et al. 2013)
+// every vertex v has an out label {(h, d(v, h))} and an in label {(h, d(h, v))} such that for every
+// reachable pair some hub h is in both, so d(s, t) = min over common hubs of d(s, h) + d(h, t)
+// - vertices are ranked by how many sampled shortest paths go through them (then by degree), the search
+//   from rank r is pruned wherever the labels of ranks < r already give the distance, so most vertices
+//   end up with short labels of important hubs
+// - hubs are stored as ranks, a label is sorted by rank and its hubs and distances are two flat arrays
+//   padded to whole SIMD blocks, the query is a block merge of two labels (GCC/Clang vector extensions)
+// a distance query reads only the two labels, never the graph; paths are not available
+// building needs non-negative weights, time and label size grow fast on graphs without hierarchy
+// (random graphs), road networks and grids stay at a few hundred hubs per label
+class HubLabels {
+private:
+    static const int VERSION = 1;
+
+    // labels of all vertices in one direction, label of v = [offsets[v], offsets[v + 1]),
+    // the tail of every label is padded with the sentinel hub (distance 0)
+    struct LabelSet {
+        vector<uint64_t> offsets;
+        vector<int> hubs;
+        vector<int> distances;
+        long long entries = 0; // without padding
+
+        void append(const vector<pair<int,int>>& label, int sentinel);
+        size_t memoryBytes() const;
+    };
+    int n = 0;
+    LabelSet out; // (hub, d(v, hub)), padded with OUT_SENTINEL
+    LabelSet in;  // (hub, d(hub, v)), padded with IN_SENTINEL
+    // different sentinels never match each other, both are larger than every rank
+    static const int OUT_SENTINEL = INT_MAX;
+    static const int IN_SENTINEL = INT_MAX - 1;
+
+    void setLabels(int vertices, const vector<vector<pair<int,int>>>& outLabels,
+                   const vector<vector<pair<int,int>>>& inLabels);
+public:
+    HubLabels() = default;
+
+    // labels of graph, false (and no labels) if the graph has a negative edge
+    bool build(const Graph& graph);
+
+    // d(start, end), INT_MAX if end is not reachable or a vertex is out of range
+    int distance(int start, int end) const;
+
+    int getSize() const { return n; }
+    // label entries of both directions without padding
+    long long getLabelEntries() const { return out.entries + in.entries; }
+    // average entries of one label
+    double averageLabelSize() const { return n > 0 ? (double)getLabelEntries() / (2.0 * n) : 0; }
+    size_t memoryBytes() const { return out.memoryBytes() + in.memoryBytes(); }
+
+    // binary file "PCCH", version, vertices, then for out and in labels: entries per vertex (int32)
+    // and all (hub, distance) pairs without padding, so the file does not depend on the SIMD width
+    // both return false on I/O errors, load also for a file that is not a label file
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+};
+
+#endif //PCC_SEMESTRALKA_HUBLABELS_H
@@ -0,0 +1,226 @@
+//
+// Created by filip on 13.12.2025.
+//
+
+#include "Isochrone.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <thread>
+using namespace std;
+
+void Isochrone::query(const Graph& graph, int source, int budget, SearchWorkspace& workspace,
+                      IsochroneResult& result, SearchStats* stats) {
+    result.vertices.clear();
+    result.distances.clear();
+    if (source < 0 || source >= graph.getSize()) {
+        result.status = "Invalid vertex";
+        return;
+    }
+    if (budget < 0) {
+        result.status = "Invalid budget";
+        return;
+    }
+    if (graph.hasNegativeEdges()) {
+        result.status = "Negative edge weight";
+        return;
+    }
+    result.status = "OK";
+
+    auto& heap = workspace.heap;
+    SearchStats counters;
+    workspace.reset(graph.getSize());
+    workspace.update(source, 0, -1);
+    heap.push_back({0, source});
+    counters.heapPushes++;
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        counters.heapPops++;
+        if (workspace.isSettled(u) || distance > workspace.distance(u)) continue;
+        workspace.settle(u);
+        counters.verticesSettled++;
+        // the heap pops (distance, vertex) pairs in order, so the result is sorted already
+        result.vertices.push_back(u);
+        result.distances.push_back(distance);
+
+        for (const Edge& edge : graph.neighbors(u)) {
+            counters.edgesRelaxed++;
+            // long long - distance + weight can pass INT_MAX for a budget close to it
+            long long candidate = (long long)distance + edge.weight;
+            if (candidate <= budget && candidate < workspace.distance(edge.to)) {
+                workspace.update(edge.to, (int)candidate, u);
+                heap.push_back({(int)candidate, edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                counters.successfulRelaxations++;
+                counters.heapPushes++;
+            }
+        }
+    }
+    if (stats) stats->add(counters);
+}
+
+static const int LANES = 8;
+static const unsigned UNREACHED = UINT_MAX; // larger than every budget
+
+// buffers of one worker, allocated at its first group and clean after every group
+struct LaneBuffers {
+    vector<unsigned> dist;   // dist[v * LANES + lane]
+    vector<int> key;         // heap key of a queued vertex, INT_MAX = not queued
+    vector<char> touchedMark;
+    vector<int> touched;
+    vector<pair<int,int>> heap;
+    SearchStats counters;
+};
+
+#if defined(__GNUC__)
+typedef unsigned Lanes __attribute__((vector_size(LANES * sizeof(unsigned))));
+
+// relaxes one edge for all lanes, returns the smallest improved distance (INT_MAX = nothing improved)
+// reached distances and weights are <= INT_MAX, so the unsigned sum never wraps
+static int relaxLanes(const unsigned* from, unsigned weight, unsigned* to, const Lanes& budget) {
+    Lanes source, target;
+    memcpy(&source, from, sizeof(Lanes));
+    memcpy(&target, to, sizeof(Lanes));
+    Lanes sum = source + weight;
+    Lanes better = (Lanes)((source <= budget) & (sum <= budget) & (sum < target));
+    Lanes result = (sum & better) | (target & ~better);
+    memcpy(to, &result, sizeof(Lanes));
+    int best = INT_MAX;
+    for (int l = 0; l < LANES; l++) {
+        if (better[l]) best = min(best, (int)sum[l]);
+    }
+    return best;
+}
+#else
+struct Lanes {
+    unsigned values[LANES];
+    unsigned operator[](int l) const { return values[l]; }
+    unsigned& operator[](int l) { return values[l]; }
+};
+
+// portable variant, same relaxation lane by lane
+static int relaxLanes(const unsigned* from, unsigned weight, unsigned* to, const Lanes& budget) {
+    int best = INT_MAX;
+    for (int l = 0; l < LANES; l++) {
+        if (from[l] > budget[l]) continue;
+        unsigned sum = from[l] + weight;
+        if (sum <= budget[l] && sum < to[l]) {
+            to[l] = sum;
+            best = min(best, (int)sum);
+        }
+    }
+    return best;
+}
+#endif
+
+// one label correcting search for up to LANES (source, budget) pairs, first .. first + count
+static void runGroup(const Graph& graph, const vector<int>& sources, const vector<int>& budgets, size_t first,
+                     int count, LaneBuffers& buffers, vector<IsochroneResult>& results) {
+    int n = graph.getSize();
+    if (buffers.dist.empty()) {
+        buffers.dist.assign((size_t)n * LANES, UNREACHED);
+        buffers.key.assign(n, INT_MAX);
+        buffers.touchedMark.assign(n, 0);
+    }
+    SearchStats& counters = buffers.counters;
+    auto& heap = buffers.heap;
+    auto touch = [&](int v) {
+        if (!buffers.touchedMark[v]) {
+            buffers.touchedMark[v] = 1;
+            buffers.touched.push_back(v);
+        }
+    };
+    auto push = [&](int v, int key) {
+        buffers.key[v] = key;
+        heap.push_back({key, v});
+        push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        counters.heapPushes++;
+    };
+
+    // unused lanes keep budget 0 and no source, they never relax anything
+    Lanes budget;
+    for (int l = 0; l < LANES; l++) budget[l] = 0;
+    for (int l = 0; l < count; l++) {
+        IsochroneResult& result = results[first + l];
+        if (result.status != "OK") continue;
+        int source = sources[first + l];
+        budget[l] = (unsigned)budgets[first + l];
+        buffers.dist[(size_t)source * LANES + l] = 0;
+        touch(source);
+        if (buffers.key[source] != 0) push(source, 0);
+    }
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [key, u] = heap.back();
+        heap.pop_back();
+        counters.heapPops++;
+        // an older entry, the vertex was queued again with a smaller key
+        if (key != buffers.key[u]) continue;
+        buffers.key[u] = INT_MAX;
+        counters.verticesSettled++;
+        const unsigned* from = &buffers.dist[(size_t)u * LANES];
+        for (const Edge& edge : graph.neighbors(u)) {
+            counters.edgesRelaxed++;
+            int best = relaxLanes(from, (unsigned)edge.weight, &buffers.dist[(size_t)edge.to * LANES], budget);
+            if (best == INT_MAX) continue;
+            counters.successfulRelaxations++;
+            touch(edge.to);
+            if (best < buffers.key[edge.to]) push(edge.to, best);
+        }
+    }
+
+    // one sort for all lanes, every lane is then a filtered copy in vertex order
+    sort(buffers.touched.begin(), buffers.touched.end());
+    for (int l = 0; l < count; l++) {
+        IsochroneResult& result = results[first + l];
+        if (result.status != "OK") continue;
+        for (int v : buffers.touched) {
+            unsigned distance = buffers.dist[(size_t)v * LANES + l];
+            if (distance > budget[l]) continue;
+            result.vertices.push_back(v);
+            result.distances.push_back((int)distance);
+        }
+    }
+    for (int v : buffers.touched) {
+        fill(&buffers.dist[(size_t)v * LANES], &buffers.dist[(size_t)v * LANES] + LANES, UNREACHED);
+        buffers.touchedMark[v] = 0;
+    }
+    buffers.touched.clear();
+}
+
+vector<IsochroneResult> Isochrone::batch(const Graph& graph, const vector<int>& sources, const vector<int>& budgets,
+                                         int threads, SearchStats* stats) {
+    vector<IsochroneResult> results(sources.size());
+    bool negative = graph.hasNegativeEdges();
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (sources[i] < 0 || sources[i] >= graph.getSize()) results[i].status = "Invalid vertex";
+        else if (i >= budgets.size() || budgets[i] < 0) results[i].status = "Invalid budget";
+        else if (negative) results[i].status = "Negative edge weight";
+        else results[i].status = "OK";
+    }
+
+    size_t groups = (sources.size() + LANES - 1) / LANES;
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    threads = max(1, min(threads, (int)groups));
+    vector<LaneBuffers> buffers(threads);
+    {
+        ThreadPool pool(threads, groups + 1);
+        for (size_t group = 0; group < groups; group++) {
+            pool.submit([&, group](int worker) {
+                size_t first = group * LANES;
+                int count = (int)min<size_t>(LANES, sources.size() - first);
+                runGroup(graph, sources, budgets, first, count, buffers[worker], results);
+            });
+        }
+        pool.wait();
+    }
+    if (stats) {
+        for (const LaneBuffers& worker : buffers) stats->add(worker.counters);
+    }
+    return results;
+}
@@ -0,0 +1,44 @@
+//
+// Created by filip on 13.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_ISOCHRONE_H
+#define PCC_SEMESTRALKA_ISOCHRONE_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include "SearchWorkspace.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// vertices within budget of a source
+struct IsochroneResult {
+    string status;         // "OK", "Invalid vertex", "Invalid budget" or "Negative edge weight"
+    vector<int> vertices;  // query(): by distance (ties by vertex), batch(): by vertex
+    vector<int> distances; // distances[i] = d(source, vertices[i]) <= budget
+};
+
+// range queries - everything reachable within budget B ("all places within 15 minutes")
+// query() is a Dijkstra that never pushes a vertex beyond B and stops when the heap is empty,
+// so it touches only the ball of radius B; the workspace and the result buffers are reused
+// batch() answers many (source, budget) pairs, consecutive groups of 8 sources share one search:
+// every vertex keeps the 8 distances next to each other, one scan of a vertex relaxes its edges for
+// all lanes with one vector add / min (GCC/Clang vector extensions, plain loop elsewhere), the heap
+// key is the smallest improved lane and a vertex is scanned again when another lane improves
+// nearby sources reach mostly the same vertices in about the same order, so a batch costs little more
+// than one search; give the sources grouped by location, far apart sources scan more vertices
+// groups run in parallel, every worker has its own buffers
+class Isochrone {
+public:
+    // d(source, v) <= budget for every v in result, result buffers keep their capacity between calls
+    static void query(const Graph& graph, int source, int budget, SearchWorkspace& workspace,
+                      IsochroneResult& result, SearchStats* stats = nullptr);
+
+    // results[i] for (sources[i], budgets[i]), the vertices of query() in vertex order
+    // (a sort by distance per source would cost more than the shared search saves), threads = 0 uses all cores
+    static vector<IsochroneResult> batch(const Graph& graph, const vector<int>& sources, const vector<int>& budgets,
+                                         int threads = 0, SearchStats* stats = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_ISOCHRONE_H
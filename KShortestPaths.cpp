@@ -0,0 +1,137 @@
+//
+// Created by filip on 16.11.2025.
+//
+
+#include "KShortestPaths.h"
+#include "Dijkstra.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <set>
+using namespace std;
+
+// weight of the cheapest edge u -> v
+static int edgeWeight(const Graph& graph, int u, int v) {
+    int best = INT_MAX;
+    for (const Edge& edge : graph.getAdjList()[u]) {
+        if (edge.to == v) best = min(best, edge.weight);
+    }
+    return best;
+}
+
+// A* from spur to end that skips vertices and edges blocked in the workspace
+// toEnd (exact distances to end in the whole graph) is a consistent lower bound in every masked subgraph,
+// so the search only looks at vertices that can still be on a path shorter than the found detour
+static QueryResult spurSearch(const Graph& graph, int spur, int end, const vector<int>& toEnd,
+                              SearchWorkspace& workspace, SearchStats& counters) {
+    QueryResult result;
+    const auto& adjList = graph.getAdjList();
+    auto& heap = workspace.heap;
+    workspace.reset(graph.getSize());
+    workspace.update(spur, 0, -1);
+    heap.push_back({toEnd[spur], spur});
+    counters.heapPushes++;
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        int u = heap.back().second;
+        heap.pop_back();
+        counters.heapPops++;
+        if (workspace.isSettled(u)) continue;
+        workspace.settle(u);
+        counters.verticesSettled++;
+        if (u == end) break;
+
+        int distance = workspace.distance(u);
+        for (const Edge& edge : adjList[u]) {
+            counters.edgesRelaxed++;
+            if (toEnd[edge.to] == INT_MAX || workspace.isBlocked(edge.to) || workspace.isBlockedEdge(u, edge.to)) continue;
+            int candidate = distance + edge.weight;
+            if (candidate < workspace.distance(edge.to)) {
+                workspace.update(edge.to, candidate, u);
+                heap.push_back({candidate + toEnd[edge.to], edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                counters.successfulRelaxations++;
+                counters.heapPushes++;
+            }
+        }
+    }
+
+    if (!workspace.isSettled(end)) {
+        result.status = "Unreachable";
+        return result;
+    }
+    result.status = "OK";
+    result.distance = workspace.distance(end);
+    result.path = workspace.pathTo(end);
+    return result;
+}
+
+vector<QueryResult> KShortestPaths::query(const Graph& graph, int start, int end, int k, SearchWorkspace& workspace,
+                                          SearchStats* stats) {
+    return query(graph, graph.reversed(), start, end, k, workspace, stats);
+}
+
+vector<QueryResult> KShortestPaths::query(const Graph& graph, const Graph& reverse, int start, int end, int k,
+                                          SearchWorkspace& workspace, SearchStats* stats) {
+    vector<QueryResult> found;
+    SearchStats counters;
+    workspace.clearMask();
+
+    // one backward search gives distances to end for the A* bound and the first path as its tree
+    QueryResult backward = Dijkstra::query(reverse, end, -1, workspace, &counters);
+    QueryResult first;
+    first.status = backward.status;
+    if (first.status == "OK" && workspace.distance(start) == INT_MAX) first.status = "Unreachable";
+    if (first.status != "OK") {
+        if (stats) stats->add(counters);
+        found.push_back(first);
+        return found;
+    }
+    vector<int> toEnd(graph.getSize());
+    for (int v = 0; v < graph.getSize(); v++) toEnd[v] = workspace.distance(v);
+    first.distance = toEnd[start];
+    // parent in the backward search is the next vertex towards end
+    for (int v = start; v != -1; v = workspace.parent(v)) first.path.push_back(v);
+    found.push_back(first);
+
+    // candidates ordered by (distance, path), the set also drops duplicates
+    set<pair<int, vector<int>>> candidates;
+    while ((int)found.size() < k) {
+        const vector<int>& previous = found.back().path;
+
+        // prefix[i] = distance of previous[0..i]
+        vector<int> prefix(previous.size(), 0);
+        for (size_t i = 1; i < previous.size(); i++)
+            prefix[i] = prefix[i - 1] + edgeWeight(graph, previous[i - 1], previous[i]);
+
+        for (size_t i = 0; i + 1 < previous.size(); i++) {
+            int spur = previous[i];
+            workspace.clearMask();
+            // root vertices before the spur vertex must not be visited again
+            for (size_t j = 0; j < i; j++) workspace.blockVertex(previous[j]);
+            // paths sharing this root may not leave the spur vertex the same way
+            for (const QueryResult& path : found) {
+                if (path.path.size() > i + 1 && equal(previous.begin(), previous.begin() + i + 1, path.path.begin()))
+                    workspace.blockEdge(spur, path.path[i + 1]);
+            }
+
+            QueryResult spurPath = spurSearch(graph, spur, end, toEnd, workspace, counters);
+            if (spurPath.status != "OK") continue;
+            vector<int> total(previous.begin(), previous.begin() + i);
+            total.insert(total.end(), spurPath.path.begin(), spurPath.path.end());
+            candidates.insert({prefix[i] + spurPath.distance, total});
+        }
+        workspace.clearMask();
+
+        if (candidates.empty()) break;
+        QueryResult next;
+        next.status = "OK";
+        next.distance = candidates.begin()->first;
+        next.path = candidates.begin()->second;
+        candidates.erase(candidates.begin());
+        found.push_back(next);
+    }
+    if (stats) stats->add(counters);
+    return found;
+}
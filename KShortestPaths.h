@@ -0,0 +1,36 @@
+//
+// Created by filip on 16.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_KSHORTESTPATHS_H
+#define PCC_SEMESTRALKA_KSHORTESTPATHS_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include "SearchWorkspace.h"
+#include <vector>
+using namespace std;
+
+// k shortest loopless paths (Yen's algorithm)
+// every further path is found by spur searches from the vertices of the previous one:
+// the root part is fixed, its vertices are blocked and so are the edges the already found
+// paths with the same root continue with - the spur search then has to find a new detour
+// one backward Dijkstra::query from end gives the first path and exact distances to end,
+// spur searches are A* with these distances as the bound, so they stay close to the detour
+// the backward search runs on graph.reversed(), callers with many queries build it once and pass it in
+// all searches use one workspace with vertex/edge masks
+// paths are vertex sequences, parallel edges count once (with the smallest weight)
+class KShortestPaths {
+public:
+    // up to k paths from start to end ordered by distance (ties by vertex sequence)
+    // fewer than k if the graph has no more simple paths
+    // if there is no path at all, returns one result with the status of Dijkstra::query
+    // ("Unreachable", "Negative edge weight")
+    static vector<QueryResult> query(const Graph& graph, int start, int end, int k, SearchWorkspace& workspace,
+                                     SearchStats* stats = nullptr);
+    // same with reverse = graph.reversed() built by the caller
+    static vector<QueryResult> query(const Graph& graph, const Graph& reverse, int start, int end, int k,
+                                     SearchWorkspace& workspace, SearchStats* stats = nullptr);
+};
+
+#endif //PCC_SEMESTRALKA_KSHORTESTPATHS_H
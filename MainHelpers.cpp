@@ -3,10 +3,14 @@
 //
 
 #include "MainHelpers.h"
+#include "CompressedInput.h"
 #include <fstream>
 #include <limits>
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <algorithm>
+#include <functional>
 
 
 using namespace std;
@@ -87,27 +91,90 @@ Graph loadGraphFromArgs(int argc, char* argv[], int startIndex, int& outVertices
     return g;
 }
 
-Graph loadGraphFromFile(const string& filename) {
-    ifstream fin(filename);
+// binary edge list written by pcc-generator
+// header "PCCG", int32 vertices, int64 edges, then int32 triples u v w
+Graph loadGraphFromBinaryFile(const string& filename) {
+    ifstream fin(filename, ios::binary);
     if (!fin) { cerr << "Cannot open file " << filename << endl; exit(1); }
 
-    vector<pair<int,int>> edges;
-    vector<int> weights;
-    int maxVertex = -1;
-    int u, v, w;
+    char magic[4];
+    int vertices = 0;
+    long long edges = 0;
+    fin.read(magic, 4);
+    fin.read(reinterpret_cast<char*>(&vertices), sizeof(vertices));
+    fin.read(reinterpret_cast<char*>(&edges), sizeof(edges));
+    if (!fin || string(magic, 4) != "PCCG" || vertices < 0 || edges < 0) {
+        cerr << "Invalid binary graph file " << filename << endl;
+        exit(1);
+    }
+
+    // first pass counts degrees, second pass fills the lists reserved in one arena block
+    vector<int> degrees(vertices, 0);
+    vector<int> block(3 * 65536);
+    auto readEdges = [&](const function<void(int,int,int)>& edge) {
+        fin.clear();
+        fin.seekg(4 + sizeof(int) + sizeof(long long));
+        long long remaining = edges;
+        while (remaining > 0) {
+            long long count = min<long long>(remaining, 65536);
+            fin.read(reinterpret_cast<char*>(block.data()), count * 3 * sizeof(int));
+            if (!fin) { cerr << "Unexpected end of binary graph file " << filename << endl; exit(1); }
+            for (long long i = 0; i < count; ++i) edge(block[3 * i], block[3 * i + 1], block[3 * i + 2]);
+            remaining -= count;
+        }
+    };
+    readEdges([&degrees, vertices](int from, int to, int) {
+        if (from >= 0 && from < vertices && to >= 0 && to < vertices) degrees[from]++;
+    });
+    Graph g(vertices, degrees);
+    readEdges([&g](int from, int to, int weight) { g.addEdge(from, to, weight); });
+    return g;
+}
 
-    while (fin >> u >> v >> w) {
-        edges.push_back({u,v});
-        weights.push_back(w);
-        if (u > maxVertex) maxVertex = u;
-        if (v > maxVertex) maxVertex = v;
+Graph loadGraphFromFile(const string& filename, int threads, LoadStats* stats) {
+    string format = GraphLoader::detectFormat(filename);
+    if (format == "binary") {
+        if (!CompressedInput::compression(filename).empty()) {
+            cerr << "Compressed binary graph files are not supported, decompress " << filename << " first" << endl;
+            exit(1);
+        }
+        return loadGraphFromBinaryFile(filename);
     }
+    if (format == "dimacs") return GraphLoader::loadDimacs(filename, stats);
+    if (format == "metis") return GraphLoader::loadMetis(filename, stats);
+    if (format == "mtx") return GraphLoader::loadMatrixMarket(filename, stats);
+    return GraphLoader::loadText(filename, threads, stats);
+}
 
-    Graph g(maxVertex + 1);
-    for (size_t i = 0; i < edges.size(); ++i)
-        g.addEdge(edges[i].first, edges[i].second, weights[i]);
+// list of vertices separated by whitespace (sources / targets of --matrix)
+vector<int> loadVertexList(const string& filename) {
+    ifstream fin(filename);
+    if (!fin) { cerr << "Cannot open file " << filename << endl; exit(1); }
+    vector<int> vertices;
+    int v;
+    while (fin >> v) vertices.push_back(v);
+    if (!fin.eof()) {
+        cerr << "Error: File " << filename << " must contain only vertex numbers.\n";
+        exit(1);
+    }
+    return vertices;
+}
 
-    return g;
+void loadCategories(Graph& graph, const string& filename) {
+    ifstream fin(filename);
+    if (!fin) { cerr << "Cannot open file " << filename << endl; exit(1); }
+    int v, category;
+    while (fin >> v >> category) {
+        if (v < 0 || v >= graph.getSize() || category < 0 || category > 63) {
+            cerr << "Error: File " << filename << " has vertex " << v << " or category " << category << " out of range.\n";
+            exit(1);
+        }
+        graph.setCategories(v, graph.getCategories(v) | (1ULL << category));
+    }
+    if (!fin.eof()) {
+        cerr << "Error: File " << filename << " must contain only <vertex> <category> pairs.\n";
+        exit(1);
+    }
 }
 
 void loadGraphManual(Graph& g) {
@@ -154,9 +221,26 @@ void helperFunction() {
          << "  --file <filename> --algo <dijkstra|bellman>\n"
          << "  --stdin --algo <dijkstra|bellman>\n"
          << "  --manual <num_vertices> <edges...> --algo <dijkstra|bellman>\n"
+         << "  --file <filename> --algo dag\n"
+         << "  --file <filename> --algo yen [--k N]\n"
+         << "  --file <filename> --algo arcflags [--cells N] [--threads N]\n"
+         << "  --file <filename> --algo mld [--threads N]\n"
+         << "  --file <filename> --algo cycle\n"
+         << "  --file <filename> --serve <socket_path> [--threads N] [--queue N] [--algo <name>]\n"
+         << "  --file <filename> --matrix <sources_file> <targets_file> [--threads N]\n"
+         << "  --file <filename> --isochrone <vertex> <budget>\n"
+         << "  --file <filename> --categories <file> --nearest <vertex> <category> <k>\n"
+         << "  --file <filename> --write-external <layout_file>\n"
+         << "  --external <layout_file> --algo <dijkstra|bellman> [--cache MB]\n"
+         << "  --file <filename> --write-labels <labels_file>\n"
+         << "  --labels <labels_file>\n"
+         << "  --file <filename> --serve-stdin [--threads N] [--queue N] [--algo <name>]\n"
+         << "  --file <filename> --serve <socket_path> [--huge-pages] [--numa <policy>] [--pin]\n"
          << "  --help\n\n"
          << "Options:\n"
-         << "  --file <filename>      Load graph from file (each line: u v w)\n"
+         << "  --file <filename>      Load graph from file (each line: u v w, or binary file from pcc-generator)\n"
+         << "                        also DIMACS .gr, METIS .graph and Matrix Market .mtx (vertices from 1)\n"
+         << "                        text files may be compressed with gzip (.gz) or zstd (.zst)\n"
          << "  --stdin                Read graph interactively from keyboard\n"
          << "  --manual <num_vertices> <edges...>\n"
          << "                        Provide graph directly via command line.\n"
@@ -165,6 +249,37 @@ void helperFunction() {
          << "                        Example:\n"
          << "                          --manual 5 0 1 10 1 2 20 2 3 15 3 4 30 --algo dijkstra\n"
          << "                        Note: Make sure the graph is connected between start and end vertices.\n"
-         << "  --algo <name>          Choose algorithm: dijkstra or bellman\n"
+         << "  --algo <name>          Choose algorithm: dijkstra, bellman, dag or yen (k shortest loopless paths)\n"
+         << "                        bellman on an acyclic graph runs the O(V + E) dag engine\n"
+         << "                        bfs (equal weights), bfs-01 (weights 0/1), bfs-do (direction-optimizing bfs)\n"
+         << "                        auto picks the engine by the weights of the graph\n"
+         << "                        arcflags - Dijkstra pruned by arc flags (preprocessing first, non-negative weights)\n"
+         << "                        mld - multi-level overlay (partition, customization, query, non-negative weights)\n"
+         << "                        or cycle (find a negative cycle anywhere in the graph)\n"
+         << "  --k <n>                Number of paths for --algo yen (default 3)\n"
+         << "  --cells <n>            Number of cells for --algo arcflags (1 .. 64, default 32)\n"
+         << "  --stats                Print load time, peak RSS, algorithm and hardware performance counters of the run\n"
+         << "  --serve <socket_path>  Keep graph loaded and answer queries on a unix domain socket\n"
+         << "  --serve-stdin          Keep graph loaded and answer queries from standard input\n"
+         << "                        Query lines: <start> <end> [dijkstra|bellman], also stats, quit, shutdown\n"
+         << "                        range <start> <budget> lists the vertices within the budget\n"
+         << "                        update <u> <v> <w> [...] changes edge weights while queries keep running\n"
+         << "  --matrix <sources_file> <targets_file>\n"
+         << "                        Print distance matrix sources x targets (-1 = unreachable)\n"
+         << "                        Files contain vertex numbers separated by whitespace\n"
+         << "  --isochrone <v> <b>    Print every vertex within distance b of v as \"<vertex> <distance>\" lines\n"
+         << "  --categories <file>    Point of interest categories, \"<vertex> <category>\" pairs (category 0-63)\n"
+         << "  --nearest <v> <c> <k>  Print the k vertices of category c nearest to v as \"<vertex> <distance>\" lines\n"
+         << "  --write-external <f>   Write the graph in the on-disk layout of --external and exit\n"
+         << "  --external <f>         Search a graph that stays on disk, only distances are in memory\n"
+         << "  --cache <MB>           Memory for cached partitions of --external (default 64)\n"
+         << "  --write-labels <f>     Build hub labels (non-negative weights) for distance queries and exit\n"
+         << "  --labels <f>           Distance between two vertices from hub labels, the graph is not loaded\n"
+         << "  --threads <n>          Number of worker threads (server, matrix; default: number of cores)\n"
+         << "  --queue <n>            Max number of waiting queries, more are rejected (default 1024)\n"
+         << "  --huge-pages           Put the adjacency lists (and server search buffers) on 2 MB pages\n"
+         << "  --numa <policy>        Placement of the graph on NUMA nodes: local (default), interleave,\n"
+         << "                        replicate (server: one copy per node, queries read the local one)\n"
+         << "  --pin                  Pin server worker threads to cpus, spread over the NUMA nodes\n"
          << "  --help                 Show this help message and exit\n";
 }
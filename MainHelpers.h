@@ -6,14 +6,20 @@
 #define PCC_SEMESTRALKA_MAINHELPERS_H
 #pragma once
 #include "Graph.h"
+#include "GraphLoader.h"
 #include <string>
 
-Graph loadGraphFromFile(const std::string& filename);
+// text files are parsed in parallel by GraphLoader (threads = 0 uses all cores), stats only for text files
+Graph loadGraphFromFile(const std::string& filename, int threads = 0, LoadStats* stats = nullptr);
+Graph loadGraphFromBinaryFile(const std::string& filename);
 void loadGraphFromStdin(Graph& g);
 void loadGraphManual(Graph& g);
 int getInputVertices();
 void helperFunction();
 int readInt(const std::string& prompt);
 int readIntInRange(const std::string& prompt, int minValue, int maxValue);
+std::vector<int> loadVertexList(const std::string& filename);
+// "<vertex> <category>" pairs (category 0 .. 63), a vertex may be listed with several categories
+void loadCategories(Graph& graph, const std::string& filename);
 Graph loadGraphFromArgs(int argc, char* argv[], int startIndex, int& outVertices);
 #endif //PCC_SEMESTRALKA_MAINHELPERS_H
\ No newline at end of file
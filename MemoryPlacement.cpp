@@ -0,0 +1,247 @@
+//
+// Created by filip on 5.12.2025.
+//
+
+#include "MemoryPlacement.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const size_t HUGE_PAGE = 2 << 20;
+
+// memory policies of mbind(2), numaif.h is not installed everywhere
+static const int POLICY_BIND = 2;
+static const int POLICY_INTERLEAVE = 3;
+
+void PlacementReport::add(const PlacementReport& other) {
+    bytes += other.bytes;
+    if (other.hugePageBytes >= 0) hugePageBytes = max(hugePageBytes, 0LL) + other.hugePageBytes;
+    if (bytesPerNode.size() < other.bytesPerNode.size()) bytesPerNode.resize(other.bytesPerNode.size(), 0);
+    for (size_t node = 0; node < other.bytesPerNode.size(); node++) bytesPerNode[node] += other.bytesPerNode[node];
+}
+
+void printPlacement(ostream& out, const PlacementReport& report) {
+    out << "Placed bytes: " << report.bytes << "\n";
+    out << "Huge page bytes: ";
+    if (report.hugePageBytes < 0) out << "n/a\n";
+    else out << report.hugePageBytes << "\n";
+    if (report.bytesPerNode.empty()) out << "Bytes per NUMA node: n/a\n";
+    for (size_t node = 0; node < report.bytesPerNode.size(); node++)
+        out << "Bytes on NUMA node " << node << ": " << report.bytesPerNode[node] << "\n";
+}
+
+// "0-3,8,10-11" -> 0 1 2 3 8 10 11 (format of the cpu and node lists in /sys)
+static vector<int> parseList(const string& text) {
+    vector<int> result;
+    stringstream items(text);
+    string item;
+    while (getline(items, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        try {
+            int first = stoi(item.substr(0, dash));
+            int last = dash == string::npos ? first : stoi(item.substr(dash + 1));
+            for (int value = first; value <= last; value++) result.push_back(value);
+        } catch (...) {
+            return {};
+        }
+    }
+    return result;
+}
+
+static string readLine(const string& filename) {
+    ifstream fin(filename);
+    string line;
+    getline(fin, line);
+    return line;
+}
+
+int Numa::nodeCount() {
+    vector<int> nodes = parseList(readLine("/sys/devices/system/node/online"));
+    return nodes.empty() ? 1 : nodes.back() + 1;
+}
+
+vector<int> Numa::cpusOfNode(int node) {
+    vector<int> cpus = parseList(readLine("/sys/devices/system/node/node" + to_string(node) + "/cpulist"));
+    if (cpus.empty() && node == 0) {
+        // no NUMA information, the whole machine is node 0
+        for (int cpu = 0; cpu < (int)max(1u, thread::hardware_concurrency()); cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+int Numa::currentNode() {
+#ifdef __linux__
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return (int)node;
+#endif
+    return 0;
+}
+
+int Numa::workerCpu(int worker) {
+    int nodes = nodeCount();
+    int node = worker % nodes;
+    vector<int> cpus = cpusOfNode(node);
+    if (cpus.empty()) cpus = cpusOfNode(0);
+    return cpus[(worker / nodes) % cpus.size()];
+}
+
+bool Numa::pinThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+PlacementReport Numa::inspect(const void* address, size_t bytes) {
+    PlacementReport report;
+    report.bytes = (long long)bytes;
+#ifdef __linux__
+    uintptr_t first = (uintptr_t)address;
+    uintptr_t last = first + bytes;
+
+    // huge pages of the mappings that overlap the range (a mapping can hold more than the range)
+    ifstream smaps("/proc/self/smaps");
+    if (smaps) {
+        report.hugePageBytes = 0;
+        string line;
+        long long overlap = 0;
+        while (getline(smaps, line)) {
+            uintptr_t start, end;
+            char dash;
+            istringstream header(line);
+            if (header >> hex >> start >> dash >> end && dash == '-' && line.find(':') > line.find(' ')) {
+                overlap = start < last && end > first ? (long long)(min(end, last) - max(start, first)) : 0;
+                continue;
+            }
+            if (overlap == 0) continue;
+            if (line.rfind("AnonHugePages:", 0) == 0 || line.rfind("Private_Hugetlb:", 0) == 0 ||
+                line.rfind("Shared_Hugetlb:", 0) == 0) {
+                long long kb = atoll(line.c_str() + line.find(':') + 1);
+                report.hugePageBytes += min(kb << 10, overlap);
+            }
+        }
+    }
+
+    // node of every resident page, move_pages without target nodes only asks
+    long pageSize = sysconf(_SC_PAGESIZE);
+    vector<void*> pages;
+    for (uintptr_t page = first & ~(uintptr_t)(pageSize - 1); page < last; page += pageSize) pages.push_back((void*)page);
+    vector<int> status(pages.size(), -1);
+    if (!pages.empty() &&
+        syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) == 0) {
+        report.bytesPerNode.assign(nodeCount(), 0);
+        for (int node : status) {
+            if (node < 0) continue; // not resident yet
+            if (node >= (int)report.bytesPerNode.size()) report.bytesPerNode.resize(node + 1, 0);
+            report.bytesPerNode[node] += pageSize;
+        }
+    }
+#endif
+    return report;
+}
+
+PlacedMemory::PlacedMemory(bool hugePages, const string& numa, int node)
+    : hugePages(hugePages), numa(numa), node(node) {}
+
+PlacedMemory::~PlacedMemory() {
+#ifdef __linux__
+    for (const Mapping& mapping : mappings) munmap(mapping.address, mapping.bytes);
+#else
+    for (const Mapping& mapping : mappings) ::operator delete(mapping.address, align_val_t(HUGE_PAGE));
+#endif
+}
+
+void* PlacedMemory::do_allocate(size_t bytes, size_t alignment) {
+    (void)alignment; // mmap gives at least page alignment, the arena never asks for more
+#ifdef __linux__
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t unit = hugePages ? HUGE_PAGE : pageSize;
+    size_t size = (max<size_t>(bytes, 1) + unit - 1) / unit * unit;
+    void* address = MAP_FAILED;
+    bool explicitHuge = false;
+    if (hugePages) {
+        // explicit huge pages exist only if the admin reserved some (vm.nr_hugepages)
+        address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        explicitHuge = address != MAP_FAILED;
+    }
+    if (address == MAP_FAILED) {
+        // transparent huge pages need a 2 MB aligned address, so map a bit more and cut the ends
+        size_t mapped = hugePages ? size + HUGE_PAGE : size;
+        void* raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw bad_alloc();
+        uintptr_t start = (uintptr_t)raw;
+        uintptr_t aligned = hugePages ? (start + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1) : start;
+        if (aligned > start) munmap(raw, aligned - start);
+        if (start + mapped > aligned + size) munmap((void*)(aligned + size), start + mapped - aligned - size);
+        address = (void*)aligned;
+        if (hugePages) madvise(address, size, MADV_HUGEPAGE);
+    }
+    // policy before the first touch, pages are placed when they fault in
+    // (errors are ignored, the memory is usable with the default policy as well)
+    if (node >= 0 || numa == "interleave") {
+        int nodes = max(Numa::nodeCount(), node + 1);
+        vector<unsigned long> mask((nodes + 63) / 64, 0);
+        if (node >= 0) mask[node / 64] |= 1UL << (node % 64);
+        else for (int i = 0; i < nodes; i++) mask[i / 64] |= 1UL << (i % 64);
+        syscall(SYS_mbind, address, size, node >= 0 ? POLICY_BIND : POLICY_INTERLEAVE, mask.data(),
+                mask.size() * 64 + 1, 0);
+    }
+    if (explicitHuge) explicitHugeBytes += (long long)size;
+    mappings.push_back({address, size});
+    return address;
+#else
+    void* address = ::operator new(bytes, align_val_t(HUGE_PAGE));
+    mappings.push_back({address, bytes});
+    return address;
+#endif
+}
+
+void PlacedMemory::do_deallocate(void* address, size_t bytes, size_t alignment) {
+    (void)bytes;
+    (void)alignment;
+    auto mapping = find_if(mappings.begin(), mappings.end(), [&](const Mapping& m) { return m.address == address; });
+    if (mapping == mappings.end()) return;
+#ifdef __linux__
+    munmap(mapping->address, mapping->bytes);
+#else
+    ::operator delete(mapping->address, align_val_t(HUGE_PAGE));
+#endif
+    mappings.erase(mapping);
+}
+
+PlacementReport PlacedMemory::report() const {
+    PlacementReport report;
+    for (const Mapping& mapping : mappings) report.add(Numa::inspect(mapping.address, mapping.bytes));
+    return report;
+}
+
+void PlacedMemory::adviseHugePages(void* address, size_t bytes) {
+#ifdef __linux__
+    uintptr_t start = ((uintptr_t)address + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1);
+    uintptr_t end = ((uintptr_t)address + bytes) & ~(uintptr_t)(HUGE_PAGE - 1);
+    if (end > start) madvise((void*)start, end - start, MADV_HUGEPAGE);
+#else
+    (void)address;
+    (void)bytes;
+#endif
+}
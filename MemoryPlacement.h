@@ -0,0 +1,92 @@
+//
+// Created by filip on 5.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_MEMORYPLACEMENT_H
+#define PCC_SEMESTRALKA_MEMORYPLACEMENT_H
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// where the big read only arrays (adjacency lists of a Graph) are put
+struct PlacementOptions {
+    // 2 MB pages - explicit (MAP_HUGETLB) if the system has some reserved, else transparent (madvise)
+    bool hugePages = false;
+    // "local"      - pages go to the node of the thread that touches them first (kernel default)
+    // "interleave" - pages round robin over all nodes, every thread sees the same average latency
+    // "replicate"  - one copy of the graph per node (GraphStore), a query reads the copy of its node
+    string numa = "local";
+    // worker threads pinned to cpus, consecutive workers on different nodes (ThreadPool)
+    bool pinThreads = false;
+
+    bool isDefault() const { return !hugePages && numa == "local" && !pinThreads; }
+};
+
+// where the pages of some memory actually are, filled from the kernel (/proc/self/smaps, move_pages)
+struct PlacementReport {
+    long long bytes = 0;             // mapped bytes
+    long long hugePageBytes = -1;    // backed by transparent or explicit huge pages, -1 = unknown
+    vector<long long> bytesPerNode;  // resident bytes on every NUMA node, empty = unknown
+
+    void add(const PlacementReport& other);
+};
+
+// print report in "name: value" lines like printStats
+void printPlacement(ostream& out, const PlacementReport& report);
+
+// NUMA topology of the machine and thread pinning (Linux, other systems look like one node)
+class Numa {
+public:
+    static int nodeCount();
+    // cpus of a node in increasing order
+    static vector<int> cpusOfNode(int node);
+    // node of the cpu the calling thread runs on right now
+    static int currentNode();
+    // cpu for worker i so that consecutive workers are spread over the nodes
+    static int workerCpu(int worker);
+    // pin the calling thread to one cpu, false if not possible
+    static bool pinThread(int cpu);
+    // kernel view of the pages of [address, address + bytes)
+    static PlacementReport inspect(const void* address, size_t bytes);
+};
+
+// upstream of a Graph arena - every block is its own mmap, so pages can get their size
+// and NUMA policy before they are touched
+// blocks are rounded up to 2 MB with hugePages, small allocations should not come here
+// (the monotonic arena of a Graph asks for a few big blocks only)
+class PlacedMemory : public pmr::memory_resource {
+private:
+    struct Mapping {
+        void* address;
+        size_t bytes;
+    };
+    bool hugePages;
+    string numa; // "local" or "interleave"
+    int node;    // >= 0 - all pages bound to this node
+    vector<Mapping> mappings;
+    long long explicitHugeBytes = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* address, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+public:
+    PlacedMemory(bool hugePages, const string& numa, int node = -1);
+    ~PlacedMemory() override;
+    PlacedMemory(const PlacedMemory&) = delete;
+    PlacedMemory& operator=(const PlacedMemory&) = delete;
+
+    // pages of all blocks given out so far
+    PlacementReport report() const;
+    // bytes that got explicit huge pages (MAP_HUGETLB), the rest falls back to transparent ones
+    long long getExplicitHugeBytes() const { return explicitHugeBytes; }
+
+    // ask for transparent huge pages on the 2 MB aligned part of [address, address + bytes),
+    // used for arrays that are not allocated here (SearchWorkspace)
+    static void adviseHugePages(void* address, size_t bytes);
+};
+
+#endif //PCC_SEMESTRALKA_MEMORYPLACEMENT_H
@@ -0,0 +1,268 @@
+//
+// Created by filip on 11.12.2025.
+//
+
+#include "MultiLevelOverlay.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <functional>
+#include <thread>
+using namespace std;
+
+vector<int> MultiLevelOverlay::defaultCellSizes(int vertices) {
+    vector<int> sizes;
+    for (int size : {128, 2048, 32768}) {
+        if (size * 8 <= vertices) sizes.push_back(size);
+    }
+    if (sizes.empty()) sizes.push_back(max(1, vertices / 8));
+    return sizes;
+}
+
+bool MultiLevelOverlay::partition(const Graph& graph, const vector<int>& cellSizes) {
+    *this = MultiLevelOverlay();
+    for (size_t i = 0; i < cellSizes.size(); i++) {
+        if (cellSizes[i] <= 0 || (i > 0 && cellSizes[i] <= cellSizes[i - 1])) return false;
+    }
+    n = graph.getSize();
+    edgeCount = graph.getEdgeCount();
+    topologyVersion = graph.getTopologyVersion();
+    const Graph reverse = graph.reversed();
+    levels.resize(cellSizes.size());
+
+    // top down, cells of a level grow by BFS inside their parent cell (the whole graph for the top level)
+    vector<int> parent(n, 0);
+    vector<int> queue;
+    queue.reserve(n);
+    for (int i = (int)cellSizes.size() - 1; i >= 0; i--) {
+        Level& level = levels[i];
+        level.cell.assign(n, -1);
+        int size = cellSizes[i];
+        // seeds in vertex order, a parent cell is finished before the BFS runs out of its vertices
+        vector<int> byParent(n);
+        for (int v = 0; v < n; v++) byParent[v] = v;
+        stable_sort(byParent.begin(), byParent.end(), [&](int a, int b) { return parent[a] < parent[b]; });
+        int filled = size; // forces a new cell at the first seed
+        int currentParent = -1;
+        for (int seed : byParent) {
+            if (level.cell[seed] != -1) continue;
+            if (filled >= size || parent[seed] != currentParent) {
+                level.cellCount++;
+                filled = 0;
+                currentParent = parent[seed];
+            }
+            int c = level.cellCount - 1;
+            queue.clear();
+            queue.push_back(seed);
+            level.cell[seed] = c;
+            filled++;
+            for (size_t head = 0; head < queue.size() && filled < size; head++) {
+                int u = queue[head];
+                for (const Graph* side : {&graph, &reverse}) {
+                    for (const Edge& edge : side->neighbors(u)) {
+                        if (filled >= size) break;
+                        if (level.cell[edge.to] != -1 || parent[edge.to] != currentParent) continue;
+                        level.cell[edge.to] = c;
+                        filled++;
+                        queue.push_back(edge.to);
+                    }
+                }
+            }
+        }
+        parent = level.cell;
+    }
+
+    // entry and exit vertices of every cell
+    for (Level& level : levels) {
+        vector<vector<int>> entries(level.cellCount), exits(level.cellCount);
+        level.entryIndex.assign(n, -1);
+        for (int v = 0; v < n; v++) {
+            int c = level.cell[v];
+            for (const Edge& edge : reverse.neighbors(v)) {
+                if (level.cell[edge.to] != c) {
+                    level.entryIndex[v] = (int)entries[c].size();
+                    entries[c].push_back(v);
+                    break;
+                }
+            }
+            for (const Edge& edge : graph.neighbors(v)) {
+                if (level.cell[edge.to] != c) {
+                    exits[c].push_back(v);
+                    break;
+                }
+            }
+        }
+        level.firstEntry.assign(level.cellCount + 1, 0);
+        level.firstExit.assign(level.cellCount + 1, 0);
+        level.firstDistance.assign(level.cellCount + 1, 0);
+        for (int c = 0; c < level.cellCount; c++) {
+            level.entries.insert(level.entries.end(), entries[c].begin(), entries[c].end());
+            level.exits.insert(level.exits.end(), exits[c].begin(), exits[c].end());
+            level.firstEntry[c + 1] = level.entries.size();
+            level.firstExit[c + 1] = level.exits.size();
+            level.firstDistance[c + 1] = level.firstDistance[c] + (uint64_t)entries[c].size() * exits[c].size();
+        }
+        level.distances.assign(level.firstDistance[level.cellCount], INT_MAX);
+    }
+    return true;
+}
+
+// Dijkstra from every entry of cell c that stays inside c, on level 1 over the original edges,
+// higher levels over the cliques of the level below and the edges between its cells
+void MultiLevelOverlay::customizeCell(const Graph& graph, int level, int c, vector<int>& dist,
+                                      vector<int>& touched, vector<pair<int,int>>& heap) {
+    Level& current = levels[level];
+    const Level* below = level > 0 ? &levels[level - 1] : nullptr;
+    int exitCount = current.exitCount(c);
+    auto relax = [&](int v, int candidate) {
+        if (candidate < dist[v]) {
+            if (dist[v] == INT_MAX) touched.push_back(v);
+            dist[v] = candidate;
+            heap.push_back({candidate, v});
+            push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        }
+    };
+    for (int e = 0; e < current.entryCount(c); e++) {
+        relax(current.entries[current.firstEntry[c] + e], 0);
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+            auto [distance, u] = heap.back();
+            heap.pop_back();
+            if (distance > dist[u]) continue;
+            if (below && below->entryIndex[u] >= 0) {
+                int sub = below->cell[u];
+                const int* row = &below->distances[below->firstDistance[sub] +
+                                                   (uint64_t)below->entryIndex[u] * below->exitCount(sub)];
+                for (int x = 0; x < below->exitCount(sub); x++) {
+                    if (row[x] != INT_MAX) relax(below->exits[below->firstExit[sub] + x], distance + row[x]);
+                }
+            }
+            for (const Edge& edge : graph.neighbors(u)) {
+                if (current.cell[edge.to] != c) continue;
+                // inside a cell of the level below only its clique is used
+                if (below && below->cell[edge.to] == below->cell[u]) continue;
+                relax(edge.to, distance + edge.weight);
+            }
+        }
+        int* row = &current.distances[current.firstDistance[c] + (uint64_t)e * exitCount];
+        for (int x = 0; x < exitCount; x++) row[x] = dist[current.exits[current.firstExit[c] + x]];
+        for (int v : touched) dist[v] = INT_MAX;
+        touched.clear();
+    }
+}
+
+bool MultiLevelOverlay::customize(const Graph& graph, int threads, const vector<pair<int,int>>* changedEdges,
+                                  CustomizationStats* stats) {
+    if (graph.hasNegativeEdges() || graph.getSize() != n || graph.getEdgeCount() != edgeCount ||
+        graph.getTopologyVersion() != topologyVersion) return false;
+    auto start = chrono::high_resolution_clock::now();
+    CustomizationStats counters;
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    vector<vector<int>> dist(threads, vector<int>(n, INT_MAX));
+    vector<vector<int>> touched(threads);
+    vector<vector<pair<int,int>>> heaps(threads);
+    // before the first full customization every cell is stale
+    bool partial = changedEdges && customized;
+
+    for (int level = 0; level < (int)levels.size(); level++) {
+        auto levelStart = chrono::high_resolution_clock::now();
+        vector<int> cells;
+        if (partial) {
+            // a changed edge can only change the cliques of the cells that contain its tail
+            vector<char> changed(levels[level].cellCount, 0);
+            for (const auto& [from, to] : *changedEdges) {
+                if (from >= 0 && from < n) changed[levels[level].cell[from]] = 1;
+            }
+            for (int c = 0; c < levels[level].cellCount; c++) if (changed[c]) cells.push_back(c);
+        } else {
+            for (int c = 0; c < levels[level].cellCount; c++) cells.push_back(c);
+        }
+        {
+            // a level needs the finished cliques of the level below, so levels run one after another
+            ThreadPool pool(min(threads, max(1, (int)cells.size())), cells.size() + 1);
+            for (int c : cells) {
+                pool.submit([&, level, c](int worker) {
+                    customizeCell(graph, level, c, dist[worker], touched[worker], heaps[worker]);
+                });
+            }
+            pool.wait();
+        }
+        counters.cellsCustomized += (long long)cells.size();
+        counters.levelSeconds.push_back(
+                chrono::duration<double>(chrono::high_resolution_clock::now() - levelStart).count());
+    }
+    customized = true;
+    counters.totalSeconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    if (stats) *stats = counters;
+    return true;
+}
+
+int MultiLevelOverlay::distance(const Graph& graph, int start, int end, SearchWorkspace& workspace,
+                                SearchStats* stats) const {
+    if (!customized || start < 0 || start >= n || end < 0 || end >= n || graph.getSize() != n) return INT_MAX;
+    SearchStats counters;
+    auto& heap = workspace.heap;
+    workspace.reset(n);
+    workspace.update(start, 0, -1);
+    heap.push_back({0, start});
+    counters.heapPushes++;
+    auto relax = [&](int v, int candidate, int u) {
+        counters.edgesRelaxed++;
+        if (candidate < workspace.distance(v)) {
+            workspace.update(v, candidate, u);
+            heap.push_back({candidate, v});
+            push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+            counters.successfulRelaxations++;
+            counters.heapPushes++;
+        }
+    };
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        counters.heapPops++;
+        if (workspace.isSettled(u) || distance > workspace.distance(u)) continue;
+        workspace.settle(u);
+        counters.verticesSettled++;
+        if (u == end) break;
+
+        int level = queryLevel(u, start, end);
+        if (level == 0) {
+            for (const Edge& edge : graph.neighbors(u)) relax(edge.to, distance + edge.weight, u);
+            continue;
+        }
+        // u is an entry or exit of a cell without start and end: clique to its exits, then leave the cell
+        const Level& cells = levels[level - 1];
+        int c = cells.cell[u];
+        if (cells.entryIndex[u] >= 0) {
+            const int* row = &cells.distances[cells.firstDistance[c] + (uint64_t)cells.entryIndex[u] * cells.exitCount(c)];
+            for (int x = 0; x < cells.exitCount(c); x++) {
+                if (row[x] != INT_MAX) relax(cells.exits[cells.firstExit[c] + x], distance + row[x], u);
+            }
+        }
+        for (const Edge& edge : graph.neighbors(u)) {
+            if (cells.cell[edge.to] != c) relax(edge.to, distance + edge.weight, u);
+        }
+    }
+    if (stats) stats->add(counters);
+    return workspace.distance(end);
+}
+
+long long MultiLevelOverlay::getCliqueEntries() const {
+    long long entries = 0;
+    for (const Level& level : levels) entries += (long long)level.distances.size();
+    return entries;
+}
+
+size_t MultiLevelOverlay::memoryBytes() const {
+    size_t bytes = 0;
+    for (const Level& level : levels) {
+        bytes += (level.cell.capacity() + level.entryIndex.capacity() + level.entries.capacity() +
+                  level.exits.capacity() + level.distances.capacity()) * sizeof(int);
+        bytes += (level.firstEntry.capacity() + level.firstExit.capacity() + level.firstDistance.capacity()) *
+                 sizeof(uint64_t);
+    }
+    return bytes;
+}
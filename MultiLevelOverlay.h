@@ -0,0 +1,98 @@
+//
+// Created by filip on 11.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_MULTILEVELOVERLAY_H
+#define PCC_SEMESTRALKA_MULTILEVELOVERLAY_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include "SearchWorkspace.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// time of the phases of customize()
+struct CustomizationStats {
+    vector<double> levelSeconds; // bottom level first
+    long long cellsCustomized = 0;
+    double totalSeconds = 0;
+};
+
+// customizable route planning (multi-level overlay, Delling et al. 2011)
+// metric independent part - partition(): nested cells, level 1 the smallest, every cell of level i + 1
+// is a union of cells of level i, cells grow by BFS over edges in both directions inside their parent
+// metric part - customize(): for every cell the distances from each entry vertex (entered by an edge
+// from another cell) to each exit vertex (leaves by an edge to another cell) inside the cell;
+// level 1 searches the original edges of the cell, level i + 1 searches the cliques of level i plus the
+// edges between level i cells, so every level costs about the same, cells of one level run in parallel
+// weights can change any time (Graph::setEdgeWeight), only customize() has to run again, and with the list
+// of changed edges only the cells that contain them (one per level) are recomputed
+// distance() is a Dijkstra that uses the original edges only in the cells of start and end and the
+// cliques of the largest cells that contain neither of them everywhere else
+// the topology (vertices, edges, their order) must stay the one partition() saw
+class MultiLevelOverlay {
+private:
+    struct Level {
+        int cellCount = 0;
+        vector<int> cell;               // cell of every vertex
+        vector<int> entryIndex;         // position among the entries of its cell, -1 = not an entry
+        vector<uint64_t> firstEntry;    // entries of cell c = entries[firstEntry[c] .. firstEntry[c + 1])
+        vector<uint64_t> firstExit;
+        vector<int> entries;
+        vector<int> exits;
+        vector<uint64_t> firstDistance; // clique of cell c row by row (entry x exit), INT_MAX = no path
+        vector<int> distances;
+
+        int entryCount(int c) const { return (int)(firstEntry[c + 1] - firstEntry[c]); }
+        int exitCount(int c) const { return (int)(firstExit[c + 1] - firstExit[c]); }
+    };
+    int n = 0;
+    long long edgeCount = 0;
+    uint64_t topologyVersion = 0; // Graph::getTopologyVersion() at partition time
+    vector<Level> levels; // levels[0] = level 1
+    bool customized = false;
+
+    void customizeCell(const Graph& graph, int level, int c, vector<int>& dist, vector<int>& touched,
+                       vector<pair<int,int>>& heap);
+    // highest level whose cell of u contains neither start nor end, 0 = use the original edges
+    int queryLevel(int u, int start, int end) const {
+        for (int i = (int)levels.size() - 1; i >= 0; i--) {
+            int c = levels[i].cell[u];
+            if (c != levels[i].cell[start] && c != levels[i].cell[end]) return i + 1;
+        }
+        return 0;
+    }
+public:
+    // cells of 128, 2048 and 32768 vertices, only the levels with at least 8 cells (at least one level)
+    static vector<int> defaultCellSizes(int vertices);
+
+    // nested cells of at most cellSizes[i] vertices on level i + 1 (increasing sizes)
+    // returns false for sizes that are not increasing or not positive
+    bool partition(const Graph& graph, const vector<int>& cellSizes);
+
+    // cliques for the current weights of graph, threads = 0 uses all cores
+    // changedEdges (from, to) - recompute only the cells that contain one of them (nullptr = all cells)
+    // returns false if graph has negative edges or another topology than the partition
+    // (weight changes keep the topology, an added or removed edge does not)
+    bool customize(const Graph& graph, int threads = 0, const vector<pair<int,int>>* changedEdges = nullptr,
+                   CustomizationStats* stats = nullptr);
+
+    // d(start, end) over the overlay, INT_MAX if unreachable or not customized
+    // graph is the customized one, settled vertices and relaxed edges / clique arcs go to stats
+    int distance(const Graph& graph, int start, int end, SearchWorkspace& workspace,
+                 SearchStats* stats = nullptr) const;
+
+    int getLevelCount() const { return (int)levels.size(); }
+    int getCellCount(int level) const { return levels[level - 1].cellCount; }
+    // entries + exits of all cells of a level
+    long long getBoundaryVertices(int level) const {
+        return (long long)(levels[level - 1].entries.size() + levels[level - 1].exits.size());
+    }
+    // clique entries of all levels
+    long long getCliqueEntries() const;
+    size_t memoryBytes() const;
+};
+
+#endif //PCC_SEMESTRALKA_MULTILEVELOVERLAY_H
@@ -0,0 +1,162 @@
+//
+// Created by filip on 4.11.2025.
+//
+
+#include "PerfCounters.h"
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+void SearchStats::add(const SearchStats& other) {
+    verticesSettled += other.verticesSettled;
+    edgesRelaxed += other.edgesRelaxed;
+    successfulRelaxations += other.successfulRelaxations;
+    heapPushes += other.heapPushes;
+    heapPops += other.heapPops;
+}
+
+// unavailable counter (-1) stays unavailable
+static void addCounter(long long& total, long long value) {
+    if (value < 0) return;
+    total = total < 0 ? value : total + value;
+}
+
+void HardwareCounters::add(const HardwareCounters& other) {
+    addCounter(cycles, other.cycles);
+    addCounter(instructions, other.instructions);
+    addCounter(llcMisses, other.llcMisses);
+    addCounter(branchMisses, other.branchMisses);
+    addCounter(dtlbMisses, other.dtlbMisses);
+}
+
+#ifdef __linux__
+// open one counting event for the calling thread on any cpu
+static int openEvent(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+// config of generic cache event
+static uint64_t cacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+#endif
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds) fd = -1;
+#ifdef __linux__
+    fds[0] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[1] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[2] = openEvent(PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                                                      PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds[3] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds[4] = openEvent(PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                                      PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+HardwareCounters PerfCounters::stop() {
+    long long values[COUNTER_COUNT];
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        values[i] = -1;
+#ifdef __linux__
+        if (fds[i] < 0) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(fds[i], &value, sizeof(value)) == sizeof(value)) values[i] = static_cast<long long>(value);
+#endif
+    }
+    HardwareCounters counters;
+    counters.cycles = values[0];
+    counters.instructions = values[1];
+    counters.llcMisses = values[2];
+    counters.branchMisses = values[3];
+    counters.dtlbMisses = values[4];
+    return counters;
+}
+
+// helper - print one counter or n/a
+static void printCounter(ostream& out, const char* name, long long value) {
+    out << "  " << left << setw(24) << name;
+    if (value < 0) out << "n/a";
+    else out << value;
+    out << "\n";
+}
+
+void printStats(ostream& out, const SearchStats& stats, const HardwareCounters& counters) {
+    out << "Algorithm counters:\n";
+    printCounter(out, "vertices settled", stats.verticesSettled);
+    printCounter(out, "edges relaxed", stats.edgesRelaxed);
+    printCounter(out, "successful relaxations", stats.successfulRelaxations);
+    printCounter(out, "heap pushes", stats.heapPushes);
+    printCounter(out, "heap pops", stats.heapPops);
+    out << "Hardware counters:\n";
+    printCounter(out, "cycles", counters.cycles);
+    printCounter(out, "instructions", counters.instructions);
+    printCounter(out, "LLC misses", counters.llcMisses);
+    printCounter(out, "branch misses", counters.branchMisses);
+    printCounter(out, "dTLB misses", counters.dtlbMisses);
+    if (counters.cycles > 0 && counters.instructions >= 0) {
+        out << "  " << left << setw(24) << "IPC" << fixed << setprecision(2)
+            << static_cast<double>(counters.instructions) / counters.cycles << "\n";
+        out.unsetf(ios::fixed);
+    }
+    out << right;
+}
+
+long long peakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
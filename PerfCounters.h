@@ -0,0 +1,66 @@
+//
+// Created by filip on 4.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_PERFCOUNTERS_H
+#define PCC_SEMESTRALKA_PERFCOUNTERS_H
+#pragma once
+#include <cstdint>
+#include <ostream>
+using namespace std;
+
+// algorithmic counters filled by the engines when a pointer is passed to them
+// Dijkstra::run uses array scan instead of a real heap - push = distance lowered (insert / decrease-key),
+// pop = vertex with minimal distance extracted, Dijkstra::query counts real binary heap operations
+// Bellman-Ford counts every scan of a reachable vertex in a pass as settled
+struct SearchStats {
+    long long verticesSettled = 0;
+    long long edgesRelaxed = 0;          // edges looked at
+    long long successfulRelaxations = 0; // edges that improved distance
+    long long heapPushes = 0;
+    long long heapPops = 0;
+
+    void add(const SearchStats& other);
+};
+
+// values read from hardware performance counters, -1 = counter is not available
+struct HardwareCounters {
+    long long cycles = -1;
+    long long instructions = -1;
+    long long llcMisses = -1;
+    long long branchMisses = -1;
+    long long dtlbMisses = -1;
+
+    void add(const HardwareCounters& other);
+};
+
+// wrapper around Linux perf_event_open
+// counters are opened once in the constructor, every start/stop pair measures one engine run
+// on other systems (or with too restrictive perf_event_paranoid) all counters stay unavailable
+class PerfCounters {
+private:
+    static const int COUNTER_COUNT = 5;
+    int fds[COUNTER_COUNT];
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // true if at least one counter could be opened
+    bool isAvailable() const;
+
+    // reset and enable all counters
+    void start();
+
+    // disable counters and return values measured since start()
+    HardwareCounters stop();
+};
+
+// print algorithmic and hardware counters in "name: value" lines
+void printStats(ostream& out, const SearchStats& stats, const HardwareCounters& counters);
+
+// peak resident set size of the process so far in kB (getrusage), -1 if not available
+long long peakRssKb();
+
+#endif //PCC_SEMESTRALKA_PERFCOUNTERS_H
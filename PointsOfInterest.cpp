@@ -0,0 +1,123 @@
+//
+// Created by filip on 15.12.2025.
+//
+
+#include "PointsOfInterest.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <tuple>
+using namespace std;
+
+void PointsOfInterest::nearest(const Graph& graph, int source, uint64_t mask, int k, SearchWorkspace& workspace,
+                               NearestResult& result, SearchStats* stats) {
+    result.vertices.clear();
+    result.distances.clear();
+    if (source < 0 || source >= graph.getSize()) {
+        result.status = "Invalid vertex";
+        return;
+    }
+    if (k < 1) {
+        result.status = "Invalid k";
+        return;
+    }
+    if (graph.hasNegativeEdges()) {
+        result.status = "Negative edge weight";
+        return;
+    }
+    result.status = "OK";
+    // no vertex has a category, nothing to search for
+    if (!graph.hasCategories() || mask == 0) return;
+
+    auto& heap = workspace.heap;
+    SearchStats counters;
+    workspace.reset(graph.getSize());
+    workspace.update(source, 0, -1);
+    heap.push_back({0, source});
+    counters.heapPushes++;
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+        auto [distance, u] = heap.back();
+        heap.pop_back();
+        counters.heapPops++;
+        if (workspace.isSettled(u) || distance > workspace.distance(u)) continue;
+        workspace.settle(u);
+        counters.verticesSettled++;
+        if (graph.getCategories(u) & mask) {
+            result.vertices.push_back(u);
+            result.distances.push_back(distance);
+            if ((int)result.vertices.size() == k) break;
+        }
+
+        for (const Edge& edge : graph.neighbors(u)) {
+            counters.edgesRelaxed++;
+            int candidate = distance + edge.weight;
+            if (candidate < workspace.distance(edge.to)) {
+                workspace.update(edge.to, candidate, u);
+                heap.push_back({candidate, edge.to});
+                push_heap(heap.begin(), heap.end(), greater<pair<int,int>>());
+                counters.successfulRelaxations++;
+                counters.heapPushes++;
+            }
+        }
+    }
+    if (stats) stats->add(counters);
+}
+
+bool PoiBuckets::build(const Graph& graph, uint64_t categoryMask, int bucketSize) {
+    *this = PoiBuckets();
+    if (graph.hasNegativeEdges() || bucketSize < 1) return false;
+    n = graph.getSize();
+    maxK = bucketSize;
+    mask = categoryMask;
+    facilities.assign((size_t)n * maxK, -1);
+    distances.assign((size_t)n * maxK, INT_MAX);
+    vector<int> filled(n, 0);
+    Graph reverse = graph.reversed();
+
+    // (d(v, facility), v, facility) - a vertex sees its facilities in the order of distance
+    using Label = tuple<int, int, int>;
+    vector<Label> heap;
+    auto has = [&](int v, int facility) {
+        const int* bucket = &facilities[(size_t)v * maxK];
+        return find(bucket, bucket + filled[v], facility) != bucket + filled[v];
+    };
+    for (int v = 0; v < n; v++) {
+        if (graph.getCategories(v) & mask) heap.push_back({0, v, v});
+    }
+    make_heap(heap.begin(), heap.end(), greater<Label>());
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<Label>());
+        auto [distance, v, facility] = heap.back();
+        heap.pop_back();
+        // a full bucket has maxK closer facilities, a known facility came by a shorter path before
+        if (filled[v] == maxK || has(v, facility)) continue;
+        facilities[(size_t)v * maxK + filled[v]] = facility;
+        distances[(size_t)v * maxK + filled[v]] = distance;
+        filled[v]++;
+        for (const Edge& edge : reverse.neighbors(v)) {
+            if (filled[edge.to] == maxK || has(edge.to, facility)) continue;
+            heap.push_back({distance + edge.weight, edge.to, facility});
+            push_heap(heap.begin(), heap.end(), greater<Label>());
+        }
+    }
+    return true;
+}
+
+void PoiBuckets::nearest(int source, int k, NearestResult& result) const {
+    result.vertices.clear();
+    result.distances.clear();
+    if (source < 0 || source >= n) {
+        result.status = "Invalid vertex";
+        return;
+    }
+    if (k < 1 || k > maxK) {
+        result.status = "Invalid k";
+        return;
+    }
+    result.status = "OK";
+    for (int i = 0; i < k && facilities[(size_t)source * maxK + i] != -1; i++) {
+        result.vertices.push_back(facilities[(size_t)source * maxK + i]);
+        result.distances.push_back(distances[(size_t)source * maxK + i]);
+    }
+}
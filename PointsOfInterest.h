@@ -0,0 +1,59 @@
+//
+// Created by filip on 15.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_POINTSOFINTEREST_H
+#define PCC_SEMESTRALKA_POINTSOFINTEREST_H
+#pragma once
+#include "Graph.h"
+#include "PerfCounters.h"
+#include "SearchWorkspace.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// nearest points of interest of a source, by distance
+struct NearestResult {
+    string status;         // "OK", "Invalid vertex", "Invalid k" or "Negative edge weight"
+    vector<int> vertices;  // at most k, fewer if fewer are reachable
+    vector<int> distances; // distances[i] = d(source, vertices[i])
+};
+
+// "nearest k facilities of type T from s" - vertices carry a category mask (Graph::setCategories),
+// a vertex is a facility of the query if its mask shares a bit with the query mask
+// nearest() is a Dijkstra that stops as soon as the k-th facility is settled instead of settling the
+// whole graph, so its cost depends on how far the k-th facility is, not on the graph size
+class PointsOfInterest {
+public:
+    // k nearest facilities of mask, ties by vertex number, the source itself counts (distance 0)
+    static void nearest(const Graph& graph, int source, uint64_t mask, int k, SearchWorkspace& workspace,
+                        NearestResult& result, SearchStats* stats = nullptr);
+};
+
+// precomputed variant for repeated queries of one category mask: a bucket of the maxK nearest
+// facilities for every vertex, a query is a copy of the first k entries of one bucket
+// build is one multi-source Dijkstra from all facilities on the reversed graph where every vertex
+// accepts up to maxK different facilities, in the order of their distance, O(maxK * E log) time and
+// n * maxK entries; the buckets are valid for the weights and categories they were built from
+class PoiBuckets {
+private:
+    int n = 0;
+    int maxK = 0;
+    uint64_t mask = 0;
+    vector<int> facilities; // bucket of v = [v * maxK, (v + 1) * maxK), -1 after the last facility
+    vector<int> distances;
+public:
+    // false (and no buckets) for a graph with negative edges or maxK < 1
+    bool build(const Graph& graph, uint64_t mask, int maxK);
+
+    // same facilities and distances as PointsOfInterest::nearest (equal distances may pick other vertices),
+    // status "Invalid k" for k above the bucket size
+    void nearest(int source, int k, NearestResult& result) const;
+
+    int getMaxK() const { return maxK; }
+    uint64_t getMask() const { return mask; }
+    size_t memoryBytes() const { return (facilities.capacity() + distances.capacity()) * sizeof(int); }
+};
+
+#endif //PCC_SEMESTRALKA_POINTSOFINTEREST_H
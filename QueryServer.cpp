@@ -0,0 +1,319 @@
+//
+// Created by filip on 7.11.2025.
+//
+
+#include "QueryServer.h"
+#include "Dijkstra.h"
+#include "BellmanFord.h"
+#include "Isochrone.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace std;
+
+// current time in microseconds (monotonic clock)
+static long long nowMicros() {
+    return chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QueryServer::QueryServer(Graph graph, const ServerOptions& options)
+    : store(move(graph), options.placement), options(options), workspaces(max(options.threads, 1)),
+      pool(options.threads, options.queueCapacity, options.placement.pinThreads), answered(0), rejected(0),
+      totalLatency(0), stopping(false) {
+    // the arrays are allocated by the first query of every worker, on the worker's thread
+    for (SearchWorkspace& workspace : workspaces) workspace.useHugePages(options.placement.hugePages);
+    reachability.build(store.snapshot()->graph);
+}
+
+string QueryServer::answer(int start, int end, const string& algo, long long receivedAt, int worker) {
+    SearchWorkspace& workspace = workspaces[worker];
+    // pinned for the whole query, a concurrent update publishes a new version instead
+    shared_ptr<const GraphVersion> snapshot = store.snapshot();
+    const Graph& graph = snapshot->local(Numa::currentNode());
+    QueryResult result;
+    if (algo == "bellman") {
+        // passes only over the vertices reachable from start
+        result = BellmanFord::query(graph, reachability, start, end, workspace);
+    } else if (!graph.hasNegativeEdges() && !reachability.reachable(start, end)) {
+        result.status = "Unreachable";
+    } else {
+        result = Dijkstra::query(graph, start, end, workspace);
+    }
+    string status = "OK";
+    if (result.status == "Unreachable") status = "UNREACHABLE";
+    else if (result.status == "Negative edge weight") status = "NEGATIVE_EDGE";
+    else if (result.status == "Negative weight cycle detected") status = "NEGATIVE_CYCLE";
+
+    long long latency = nowMicros() - receivedAt;
+    answered++;
+    totalLatency += latency;
+
+    ostringstream response;
+    response << status << " " << start << " " << end;
+    if (status == "OK") response << " " << result.distance;
+    response << " " << latency;
+    return response.str();
+}
+
+string QueryServer::answerRange(int start, int budget, long long receivedAt, int worker) {
+    shared_ptr<const GraphVersion> snapshot = store.snapshot();
+    const Graph& graph = snapshot->local(Numa::currentNode());
+    IsochroneResult result;
+    Isochrone::query(graph, start, budget, workspaces[worker], result);
+
+    long long latency = nowMicros() - receivedAt;
+    answered++;
+    totalLatency += latency;
+
+    ostringstream response;
+    if (result.status != "OK") {
+        response << "NEGATIVE_EDGE " << start << " " << budget << " " << latency;
+        return response.str();
+    }
+    response << "RANGE " << start << " " << budget << " " << result.vertices.size() << " " << latency;
+    for (size_t i = 0; i < result.vertices.size(); i++) response << " " << result.vertices[i] << ":" << result.distances[i];
+    return response.str();
+}
+
+bool QueryServer::handleLine(const string& line, const function<void(const string&)>& reply) {
+    long long receivedAt = nowMicros();
+    istringstream request(line);
+    string first;
+    if (!(request >> first)) {
+        reply("ERROR empty request");
+        return true;
+    }
+    if (first == "quit") {
+        reply("BYE");
+        return false;
+    }
+    if (first == "shutdown") {
+        stopping = true;
+        reply("BYE");
+        return false;
+    }
+    if (first == "stats") {
+        reply(statsLine());
+        return true;
+    }
+
+    if (first == "update") {
+        // triples until the end of line
+        vector<EdgeUpdate> updates;
+        EdgeUpdate edge;
+        while (request >> edge.from >> edge.to >> edge.weight) updates.push_back(edge);
+        if (updates.empty() || !request.eof()) {
+            reply("ERROR expected: update <u> <v> <w> [<u> <v> <w> ...]");
+            return true;
+        }
+        long long version;
+        int applied = store.applyWeightUpdates(updates, &version);
+        reply("UPDATED applied=" + to_string(applied) + " version=" + to_string(version));
+        return true;
+    }
+
+    int start, end;
+    string algo = options.defaultAlgo;
+    int vertices = store.snapshot()->graph.getSize();
+    if (first == "range") {
+        int budget;
+        if (!(request >> start >> budget) || budget < 0) {
+            reply("ERROR expected: range <start> <budget>, budget >= 0");
+            return true;
+        }
+        if (start < 0 || start >= vertices) {
+            reply("ERROR vertices must be in range 0-" + to_string(vertices - 1));
+            return true;
+        }
+        bool queued = pool.trySubmit([this, start, budget, receivedAt, reply](int worker) {
+            reply(answerRange(start, budget, receivedAt, worker));
+        });
+        if (!queued) {
+            rejected++;
+            reply("ERROR busy " + to_string(start) + " " + to_string(budget));
+        }
+        return true;
+    }
+    istringstream numbers(line);
+    if (!(numbers >> start >> end)) {
+        reply("ERROR expected: <start> <end> [dijkstra|bellman]");
+        return true;
+    }
+    numbers >> algo;
+    if (start < 0 || start >= vertices || end < 0 || end >= vertices) {
+        reply("ERROR vertices must be in range 0-" + to_string(vertices - 1));
+        return true;
+    }
+    if (algo != "dijkstra" && algo != "bellman") {
+        reply("ERROR unknown algorithm " + algo);
+        return true;
+    }
+
+    bool queued = pool.trySubmit([this, start, end, algo, receivedAt, reply](int worker) {
+        reply(answer(start, end, algo, receivedAt, worker));
+    });
+    if (!queued) {
+        rejected++;
+        reply("ERROR busy " + to_string(start) + " " + to_string(end));
+    }
+    return true;
+}
+
+void QueryServer::serveStream(istream& in, ostream& out) {
+    mutex outputLock;
+    auto reply = [&out, &outputLock](const string& response) {
+        lock_guard<mutex> guard(outputLock);
+        out << response << "\n";
+        out.flush();
+    };
+    string line;
+    while (getline(in, line)) {
+        if (!handleLine(line, reply)) break;
+    }
+    // answers reference local reply, so wait for all of them
+    pool.wait();
+}
+
+string QueryServer::statsLine() const {
+    long long count = answered;
+    long long average = count == 0 ? 0 : totalLatency / count;
+    return "STATS answered=" + to_string(count) + " rejected=" + to_string(rejected.load())
+           + " avg_latency_us=" + to_string(average) + " version=" + to_string(store.snapshot()->version);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// one client connection, fd is closed when the last pending answer is written
+struct Connection {
+    int fd;
+    mutex writeLock;
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { close(fd); }
+
+    void send(const string& response) {
+        lock_guard<mutex> guard(writeLock);
+        string data = response + "\n";
+        size_t written = 0;
+        while (written < data.size()) {
+#ifdef MSG_NOSIGNAL
+            ssize_t n = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+#else
+            ssize_t n = ::send(fd, data.data() + written, data.size() - written, 0);
+#endif
+            if (n <= 0) return; // client is gone
+            written += n;
+        }
+    }
+};
+
+bool QueryServer::serveUnixSocket(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: Socket path is too long.\n";
+        return false;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        cerr << "Error: Cannot create socket.\n";
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listenFd, 64) < 0) {
+        cerr << "Error: Cannot listen on " << path << endl;
+        close(listenFd);
+        return false;
+    }
+    cout << "Listening on " << path << " with " << pool.getThreadCount() << " workers" << endl;
+
+    // client threads are detached, activeClients tells when all of them finished
+    vector<weak_ptr<Connection>> connections;
+    mutex connectionsLock;
+    condition_variable clientsDone;
+    int activeClients = 0;
+
+    while (!stopping) {
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) break; // listening socket was shut down
+        auto connection = make_shared<Connection>(clientFd);
+        {
+            lock_guard<mutex> guard(connectionsLock);
+            // forget closed connections
+            connections.erase(remove_if(connections.begin(), connections.end(),
+                                        [](const weak_ptr<Connection>& weak) { return weak.expired(); }),
+                              connections.end());
+            connections.push_back(connection);
+            activeClients++;
+        }
+
+        thread([this, connection, listenFd, &connections, &connectionsLock, &clientsDone, &activeClients]() mutable {
+            auto reply = [connection](const string& response) { connection->send(response); };
+            string pending;
+            char buffer[4096];
+            bool open = true;
+            while (open) {
+                ssize_t n = read(connection->fd, buffer, sizeof(buffer));
+                if (n <= 0) break;
+                pending.append(buffer, n);
+                size_t newline;
+                while (open && (newline = pending.find('\n')) != string::npos) {
+                    string line = pending.substr(0, newline);
+                    pending.erase(0, newline + 1);
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    open = handleLine(line, reply);
+                }
+            }
+            // pending answers keep their own reference, socket closes after the last one
+            connection.reset();
+            lock_guard<mutex> guard(connectionsLock);
+            if (stopping) {
+                // wake up accept and all other clients
+                shutdown(listenFd, SHUT_RDWR);
+                for (auto& weak : connections) {
+                    if (auto other = weak.lock()) shutdown(other->fd, SHUT_RD);
+                }
+            }
+            activeClients--;
+            clientsDone.notify_all();
+        }).detach();
+    }
+
+    {
+        unique_lock<mutex> guard(connectionsLock);
+        clientsDone.wait(guard, [&activeClients] { return activeClients == 0; });
+    }
+    pool.wait();
+    close(listenFd);
+    unlink(path.c_str());
+    cout << statsLine() << endl;
+    return true;
+}
+#else
+bool QueryServer::serveUnixSocket(const string& path) {
+    cerr << "Error: Unix domain sockets are not supported on this system.\n";
+    return false;
+}
+#endif
+
+PlacementReport QueryServer::placementReport() const {
+    shared_ptr<const GraphVersion> snapshot = store.snapshot();
+    PlacementReport report = snapshot->graph.placementReport();
+    for (const Graph& replica : snapshot->replicas) report.add(replica.placementReport());
+    return report;
+}
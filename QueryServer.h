@@ -0,0 +1,81 @@
+//
+// Created by filip on 7.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_QUERYSERVER_H
+#define PCC_SEMESTRALKA_QUERYSERVER_H
+#pragma once
+#include "Graph.h"
+#include "GraphStore.h"
+#include "ThreadPool.h"
+#include "SearchWorkspace.h"
+#include "ReachabilityIndex.h"
+#include <atomic>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+using namespace std;
+
+struct ServerOptions {
+    int threads = 4;              // worker threads answering queries
+    size_t queueCapacity = 1024;  // waiting queries, more are rejected with "ERROR busy"
+    string defaultAlgo = "dijkstra";
+    PlacementOptions placement;   // huge pages / NUMA placement of the graph and worker pinning
+};
+
+// long running query server - graph is loaded once and shared by all workers through a GraphStore,
+// every query runs on the snapshot that was current when it started, updates never block queries
+//
+// line protocol (one request per line):
+//   <start> <end> [dijkstra|bellman]  ->  OK <start> <end> <distance> <latency_us>
+//                                         UNREACHABLE | NEGATIVE_EDGE | NEGATIVE_CYCLE <start> <end> <latency_us>
+//   range <start> <budget>           ->  RANGE <start> <budget> <count> <latency_us> <vertex>:<distance> ...
+//                                         every vertex within the budget, by distance
+//                                         NEGATIVE_EDGE <start> <budget> <latency_us> for negative weights
+//   update <u> <v> <w> [<u> <v> <w> ...] ->  UPDATED applied=<n> version=<n>
+//                                         weight changes, published as one new graph version
+//   stats                             ->  STATS answered=<n> rejected=<n> avg_latency_us=<n> version=<n>
+//   quit                              ->  closes the connection
+//   shutdown                          ->  stops the whole server (socket mode)
+// answers of one connection may come in different order than the queries, they carry start and end
+// pairs in different strongly connected components without a path between them are answered UNREACHABLE
+// from the reachability index without any search
+// with numa "replicate" a worker searches the graph copy of the node it runs on (pin the workers, or the
+// kernel may move them away from their copy between queries)
+class QueryServer {
+private:
+    GraphStore store;
+    ServerOptions options;
+    ReachabilityIndex reachability; // built once, weight updates keep the topology
+    vector<SearchWorkspace> workspaces; // one per worker thread, must outlive the pool
+    ThreadPool pool;
+    atomic<long long> answered;
+    atomic<long long> rejected;
+    atomic<long long> totalLatency;
+    atomic<bool> stopping;
+
+    // run the engine, response line without newline
+    string answer(int start, int end, const string& algo, long long receivedAt, int worker);
+    string answerRange(int start, int budget, long long receivedAt, int worker);
+public:
+    QueryServer(Graph graph, const ServerOptions& options);
+
+    // process one request line, reply is called exactly once (possibly from a worker thread)
+    // returns false for "quit" and "shutdown"
+    bool handleLine(const string& line, const function<void(const string&)>& reply);
+
+    // read requests from in until EOF or quit, answers go to out
+    void serveStream(istream& in, ostream& out);
+
+    // listen on unix domain socket until "shutdown" is received
+    // returns false if the socket could not be created
+    bool serveUnixSocket(const string& path);
+
+    string statsLine() const;
+
+    // pages of the current graph version and its replicas
+    PlacementReport placementReport() const;
+};
+
+#endif //PCC_SEMESTRALKA_QUERYSERVER_H
@@ -0,0 +1,155 @@
+//
+// Created by filip on 17.12.2025.
+//
+
+#include "ReachabilityIndex.h"
+#include <algorithm>
+using namespace std;
+
+void ReachabilityIndex::build(const Graph& graph) {
+    *this = ReachabilityIndex();
+    n = graph.getSize();
+    edgeCount = graph.getEdgeCount();
+    topologyVersion = graph.getTopologyVersion();
+    component.assign(n, -1);
+
+    // iterative Tarjan - frames (vertex, next edge) replace the recursion
+    vector<int> order(n, -1), low(n, 0);
+    vector<char> onStack(n, 0);
+    vector<int> stack;
+    vector<pair<int, size_t>> frames;
+    int counter = 0;
+    for (int root = 0; root < n; root++) {
+        if (order[root] != -1) continue;
+        order[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = 1;
+        frames.push_back({root, 0});
+        while (!frames.empty()) {
+            int u = frames.back().first;
+            const auto& edges = graph.neighbors(u);
+            if (frames.back().second < edges.size()) {
+                int v = edges[frames.back().second++].to;
+                if (order[v] == -1) {
+                    order[v] = low[v] = counter++;
+                    stack.push_back(v);
+                    onStack[v] = 1;
+                    frames.push_back({v, 0});
+                } else if (onStack[v]) {
+                    low[u] = min(low[u], order[v]);
+                }
+                continue;
+            }
+            // all edges of u done, u is the root of a component if nothing below reached higher
+            if (low[u] == order[u]) {
+                int v;
+                do {
+                    v = stack.back();
+                    stack.pop_back();
+                    onStack[v] = 0;
+                    component[v] = componentCount;
+                } while (v != u);
+                componentCount++;
+            }
+            frames.pop_back();
+            if (!frames.empty()) low[frames.back().first] = min(low[frames.back().first], low[u]);
+        }
+    }
+
+    // members of every component (counting sort by component)
+    firstMember.assign(componentCount + 1, 0);
+    for (int v = 0; v < n; v++) firstMember[component[v] + 1]++;
+    for (int c = 0; c < componentCount; c++) firstMember[c + 1] += firstMember[c];
+    members.resize(n);
+    vector<uint64_t> next(firstMember.begin(), firstMember.end() - 1);
+    for (int v = 0; v < n; v++) members[next[component[v]]++] = v;
+
+    // condensation edges, parallel ones merged
+    vector<pair<int,int>> edges;
+    for (int u = 0; u < n; u++) {
+        for (const Edge& edge : graph.neighbors(u)) {
+            if (component[u] != component[edge.to]) edges.push_back({component[u], component[edge.to]});
+        }
+    }
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+    firstDagEdge.assign(componentCount + 1, 0);
+    dagEdges.reserve(edges.size());
+    for (const auto& [from, to] : edges) {
+        firstDagEdge[from + 1]++;
+        dagEdges.push_back(to);
+    }
+    for (int c = 0; c < componentCount; c++) firstDagEdge[c + 1] += firstDagEdge[c];
+
+    if (componentCount > MAX_CLOSURE) return;
+    // successors have smaller ids, so their rows are complete when c is processed
+    words = (componentCount + 63) / 64;
+    closure.assign((size_t)componentCount * words, 0);
+    for (int c = 0; c < componentCount; c++) {
+        uint64_t* row = &closure[(size_t)c * words];
+        row[c / 64] |= 1ULL << (c % 64);
+        for (uint64_t e = firstDagEdge[c]; e < firstDagEdge[c + 1]; e++) {
+            const uint64_t* successor = &closure[(size_t)dagEdges[e] * words];
+            // bits of a successor are all <= its id
+            for (int w = 0; w <= dagEdges[e] / 64; w++) row[w] |= successor[w];
+        }
+    }
+}
+
+bool ReachabilityIndex::reachable(int start, int end) const {
+    if (start < 0 || start >= n || end < 0 || end >= n) return false;
+    int from = component[start], to = component[end];
+    if (from == to) return true;
+    // condensation edges only lower the id
+    if (from < to) return false;
+    if (!closure.empty()) return (closure[(size_t)from * words + to / 64] >> (to % 64)) & 1;
+
+    // DFS over the components between the two ids
+    vector<char> visited(from - to + 1, 0);
+    vector<int> stack = {from};
+    visited[from - to] = 1;
+    while (!stack.empty()) {
+        int c = stack.back();
+        stack.pop_back();
+        for (uint64_t e = firstDagEdge[c]; e < firstDagEdge[c + 1]; e++) {
+            int successor = dagEdges[e];
+            if (successor == to) return true;
+            if (successor < to || visited[successor - to]) continue;
+            visited[successor - to] = 1;
+            stack.push_back(successor);
+        }
+    }
+    return false;
+}
+
+vector<int> ReachabilityIndex::reachableFrom(int start) const {
+    vector<int> vertices;
+    if (start < 0 || start >= n) return vertices;
+    int from = component[start];
+    vector<int> components;
+    if (!closure.empty()) {
+        const uint64_t* row = &closure[(size_t)from * words];
+        for (int c = from; c >= 0; c--) {
+            if ((row[c / 64] >> (c % 64)) & 1) components.push_back(c);
+        }
+    } else {
+        vector<char> visited(from + 1, 0);
+        vector<int> stack = {from};
+        visited[from] = 1;
+        while (!stack.empty()) {
+            int c = stack.back();
+            stack.pop_back();
+            components.push_back(c);
+            for (uint64_t e = firstDagEdge[c]; e < firstDagEdge[c + 1]; e++) {
+                if (!visited[dagEdges[e]]) {
+                    visited[dagEdges[e]] = 1;
+                    stack.push_back(dagEdges[e]);
+                }
+            }
+        }
+        // higher id first = topological order
+        sort(components.begin(), components.end(), greater<int>());
+    }
+    for (int c : components) vertices.insert(vertices.end(), members.begin() + firstMember[c], members.begin() + firstMember[c + 1]);
+    return vertices;
+}
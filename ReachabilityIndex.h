@@ -0,0 +1,63 @@
+//
+// Created by filip on 17.12.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_REACHABILITYINDEX_H
+#define PCC_SEMESTRALKA_REACHABILITYINDEX_H
+#pragma once
+#include "Graph.h"
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+// strongly connected components and reachability between them, built once after loading
+// - components by iterative Tarjan (no recursion, so paths of millions of vertices are fine), Tarjan finishes
+//   a component after all components it reaches, so every condensation edge goes from a higher id to a lower
+// - condensation DAG of the components, parallel edges merged
+// - up to MAX_CLOSURE components the whole transitive closure as one bitset per component,
+//   reachable() is then a bit test; bigger condensations search the DAG, only components with ids
+//   between the two are visited
+// only the topology matters, weight changes (GraphStore updates) keep the index valid,
+// added or removed edges need a new build
+class ReachabilityIndex {
+private:
+    int n = 0;
+    long long edgeCount = 0;
+    uint64_t topologyVersion = 0; // Graph::getTopologyVersion() at build time
+    int componentCount = 0;
+    vector<int> component;        // component of every vertex
+    vector<uint64_t> firstMember; // vertices of c = members[firstMember[c] .. firstMember[c + 1])
+    vector<int> members;
+    vector<uint64_t> firstDagEdge; // successors of c = dagEdges[firstDagEdge[c] .. firstDagEdge[c + 1])
+    vector<int> dagEdges;
+    int words = 0;                // closure row of c = closure[c * words ..], empty above MAX_CLOSURE
+    vector<uint64_t> closure;
+public:
+    static const int MAX_CLOSURE = 16384; // 32 MB of closure bits
+
+    void build(const Graph& graph);
+
+    // true if the index was built for this graph (or a copy of it) and no edge was added or removed since
+    bool matches(const Graph& graph) const {
+        return graph.getSize() == n && graph.getEdgeCount() == edgeCount &&
+               graph.getTopologyVersion() == topologyVersion;
+    }
+
+    // true if there is a path start -> end (start -> start always), false for vertices out of range
+    bool reachable(int start, int end) const;
+
+    // vertices reachable from start, components in topological order (a vertex before everything it reaches
+    // in another component), so one pass of Bellman-Ford over the list is exact on acyclic parts
+    vector<int> reachableFrom(int start) const;
+
+    int componentOf(int vertex) const { return component[vertex]; }
+    int getComponentCount() const { return componentCount; }
+    long long getDagEdges() const { return (long long)dagEdges.size(); }
+    bool hasClosure() const { return !closure.empty() || componentCount == 0; }
+    size_t memoryBytes() const {
+        return (component.capacity() + members.capacity() + dagEdges.capacity()) * sizeof(int) +
+               (firstMember.capacity() + firstDagEdge.capacity() + closure.capacity()) * sizeof(uint64_t);
+    }
+};
+
+#endif //PCC_SEMESTRALKA_REACHABILITYINDEX_H
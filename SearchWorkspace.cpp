@@ -0,0 +1,79 @@
+//
+// Created by filip on 9.11.2025.
+//
+
+#include "SearchWorkspace.h"
+#include "MemoryPlacement.h"
+#include <algorithm>
+using namespace std;
+
+SearchWorkspace::SearchWorkspace(int vertices) : epoch(1), maskEpoch(1), masked(false) {
+    reset(vertices);
+}
+
+void SearchWorkspace::reset(int vertices) {
+    if (vertices != size()) {
+        if (hugePages) {
+            // advice before the first touch, assign() then faults the arrays in as huge pages
+            dist = vector<int>();
+            parentVertex = vector<int>();
+            stamp = vector<unsigned>();
+            settledStamp = vector<unsigned>();
+            dist.reserve(vertices);
+            parentVertex.reserve(vertices);
+            stamp.reserve(vertices);
+            settledStamp.reserve(vertices);
+            PlacedMemory::adviseHugePages(dist.data(), vertices * sizeof(int));
+            PlacedMemory::adviseHugePages(parentVertex.data(), vertices * sizeof(int));
+            PlacedMemory::adviseHugePages(stamp.data(), vertices * sizeof(unsigned));
+            PlacedMemory::adviseHugePages(settledStamp.data(), vertices * sizeof(unsigned));
+        }
+        dist.assign(vertices, INT_MAX);
+        parentVertex.assign(vertices, -1);
+        stamp.assign(vertices, 0);
+        settledStamp.assign(vertices, 0);
+        blockedStamp.assign(vertices, 0);
+        edgeBlockStamp.assign(vertices, 0);
+        blockedEdges.clear();
+        masked = false;
+    }
+    heap.clear();
+    epoch++;
+    if (epoch == 0) {
+        // counter wrapped around, old stamps could look valid again
+        fill(stamp.begin(), stamp.end(), 0);
+        fill(settledStamp.begin(), settledStamp.end(), 0);
+        epoch = 1;
+    }
+}
+
+vector<int> SearchWorkspace::pathTo(int end) const {
+    vector<int> path;
+    if (end < 0 || end >= size() || distance(end) == INT_MAX) return path;
+    for (int v = end; v != -1; v = parent(v)) path.push_back(v);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+void SearchWorkspace::clearMask() {
+    blockedEdges.clear();
+    masked = false;
+    maskEpoch++;
+    if (maskEpoch == 0) {
+        fill(blockedStamp.begin(), blockedStamp.end(), 0);
+        fill(edgeBlockStamp.begin(), edgeBlockStamp.end(), 0);
+        maskEpoch = 1;
+    }
+}
+
+void SearchWorkspace::blockEdge(int from, int to) {
+    edgeBlockStamp[from] = maskEpoch;
+    blockedEdges.push_back({from, to});
+    masked = true;
+}
+
+bool SearchWorkspace::isBlockedEdge(int from, int to) const {
+    // only a few edges are blocked at once, the stamp filters out almost every vertex
+    if (edgeBlockStamp[from] != maskEpoch) return false;
+    return find(blockedEdges.begin(), blockedEdges.end(), make_pair(from, to)) != blockedEdges.end();
+}
@@ -0,0 +1,77 @@
+//
+// Created by filip on 9.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_SEARCHWORKSPACE_H
+#define PCC_SEMESTRALKA_SEARCHWORKSPACE_H
+#pragma once
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// result of one query without any printing
+// status is "OK", "Unreachable", "Negative weight cycle detected" or "Negative edge weight"
+struct QueryResult {
+    string status;
+    int distance = -1;  // -1 if status is not "OK"
+    vector<int> path;   // start ... end, empty if status is not "OK"
+};
+
+// buffers of one search, reused by consecutive queries of the same thread
+// reset() is O(1) - values are valid only if their stamp equals the current epoch,
+// so the O(V) arrays are allocated once and never cleared
+// one workspace must not be used by two threads at once, every thread needs its own
+class SearchWorkspace {
+private:
+    vector<int> dist;
+    vector<int> parentVertex;
+    vector<unsigned> stamp;        // dist/parent are valid for stamp == epoch
+    vector<unsigned> settledStamp; // vertex is settled for settledStamp == epoch
+    unsigned epoch;
+    // vertex/edge masks, they survive reset() and are dropped by clearMask()
+    vector<unsigned> blockedStamp;     // vertex is blocked for blockedStamp == maskEpoch
+    vector<unsigned> edgeBlockStamp;   // some edges leaving vertex are blocked for edgeBlockStamp == maskEpoch
+    vector<pair<int,int>> blockedEdges; // (from, to), all parallel edges from -> to are blocked
+    unsigned maskEpoch;
+    bool masked;
+    bool hugePages = false;
+public:
+    // binary min-heap of (distance, vertex) used with push_heap / pop_heap and greater<>
+    vector<pair<int,int>> heap;
+
+    explicit SearchWorkspace(int vertices = 0);
+
+    // start a new search on graph with given number of vertices
+    void reset(int vertices);
+
+    int size() const { return static_cast<int>(dist.size()); }
+    // ask for transparent huge pages on the O(V) arrays, applied when they are (re)allocated by reset()
+    // the arrays are touched first by the thread that calls reset, so a pinned worker gets them on its node
+    void useHugePages(bool enabled) { hugePages = enabled; }
+    int distance(int v) const { return stamp[v] == epoch ? dist[v] : INT_MAX; }
+    int parent(int v) const { return stamp[v] == epoch ? parentVertex[v] : -1; }
+    bool isSettled(int v) const { return settledStamp[v] == epoch; }
+
+    void update(int v, int distance, int parent) {
+        stamp[v] = epoch;
+        dist[v] = distance;
+        parentVertex[v] = parent;
+    }
+    void settle(int v) { settledStamp[v] = epoch; }
+
+    // masks for searches on a subgraph (spur searches of KShortestPaths)
+    // searches skip blocked vertices and edges until clearMask() is called
+    void clearMask();
+    void blockVertex(int v) { blockedStamp[v] = maskEpoch; masked = true; }
+    void blockEdge(int from, int to);
+    bool hasMask() const { return masked; }
+    bool isBlocked(int v) const { return blockedStamp[v] == maskEpoch; }
+    bool isBlockedEdge(int from, int to) const;
+
+    // path from the search start to end following parents, empty if end was not reached
+    vector<int> pathTo(int end) const;
+};
+
+#endif //PCC_SEMESTRALKA_SEARCHWORKSPACE_H
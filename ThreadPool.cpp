@@ -0,0 +1,79 @@
+//
+// Created by filip on 7.11.2025.
+//
+
+#include "ThreadPool.h"
+#include "MemoryPlacement.h"
+#include <algorithm>
+using namespace std;
+
+ThreadPool::ThreadPool(int threads, size_t capacity, bool pinned)
+    : capacity(max<size_t>(capacity, 1)), activeTasks(0), stopping(false), pinned(pinned) {
+    threads = max(threads, 1);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::workerLoop(int worker) {
+    // before the first task, so the worker's own buffers are first touched on its node
+    if (pinned) Numa::pinThread(Numa::workerCpu(worker));
+    while (true) {
+        Task task;
+        {
+            unique_lock<mutex> guard(lock);
+            notEmpty.wait(guard, [this] { return stopping || !tasks.empty(); });
+            // queued tasks are finished even when stopping
+            if (tasks.empty()) return;
+            task = move(tasks.front());
+            tasks.pop_front();
+            activeTasks++;
+        }
+        notFull.notify_one();
+
+        task(worker);
+
+        {
+            unique_lock<mutex> guard(lock);
+            activeTasks--;
+            if (tasks.empty() && activeTasks == 0) idle.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::trySubmit(Task task) {
+    {
+        unique_lock<mutex> guard(lock);
+        if (tasks.size() >= capacity) return false;
+        tasks.push_back(move(task));
+    }
+    notEmpty.notify_one();
+    return true;
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this] { return tasks.size() < capacity; });
+        tasks.push_back(move(task));
+    }
+    notEmpty.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(lock);
+    idle.wait(guard, [this] { return tasks.empty() && activeTasks == 0; });
+}
+
+int ThreadPool::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
@@ -0,0 +1,56 @@
+//
+// Created by filip on 7.11.2025.
+//
+
+#ifndef PCC_SEMESTRALKA_THREADPOOL_H
+#define PCC_SEMESTRALKA_THREADPOOL_H
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// fixed number of worker threads with a bounded task queue
+// task gets index of the worker (0 .. threads-1), so it can use per-worker data without locking
+// pinned workers stay on one cpu each, consecutive workers on different NUMA nodes (Numa::workerCpu)
+class ThreadPool {
+public:
+    using Task = function<void(int worker)>;
+private:
+    vector<thread> workers;
+    deque<Task> tasks;
+    size_t capacity;
+    int activeTasks;
+    bool stopping;
+    bool pinned;
+    mutex lock;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    condition_variable idle;
+
+    void workerLoop(int worker);
+public:
+    // threads - number of workers (at least 1), capacity - max number of waiting tasks
+    ThreadPool(int threads, size_t capacity, bool pinned = false);
+
+    // finishes all queued tasks and joins workers
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // add task, returns false if the queue is full
+    bool trySubmit(Task task);
+
+    // add task, blocks while the queue is full
+    void submit(Task task);
+
+    // block until queue is empty and no task is running
+    void wait();
+
+    int getThreadCount() const;
+};
+
+#endif //PCC_SEMESTRALKA_THREADPOOL_H
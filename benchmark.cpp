@@ -0,0 +1,1051 @@
+//
+// Created by filip on 4.11.2025.
+//
+// Benchmark harness - runs engines on a generated or loaded graph and reports
+// wall time together with algorithmic and hardware performance counters.
+//
+#include "GraphGenerator.h"
+#include "MainHelpers.h"
+#include "Dijkstra.h"
+#include "BellmanFord.h"
+#include "PerfCounters.h"
+#include "SearchWorkspace.h"
+#include "ThreadPool.h"
+#include "DistanceTable.h"
+#include "BatchedBellmanFord.h"
+#include "KShortestPaths.h"
+#include "DagShortestPath.h"
+#include "BreadthFirstSearch.h"
+#include "DynamicShortestPaths.h"
+#include "GraphStore.h"
+#include "GraphLoader.h"
+#include "CompressedGraph.h"
+#include "ExternalShortestPath.h"
+#include "HubLabels.h"
+#include "ArcFlags.h"
+#include "MultiLevelOverlay.h"
+#include "Isochrone.h"
+#include "PointsOfInterest.h"
+#include "ReachabilityIndex.h"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <climits>
+#include <iomanip>
+#include <algorithm>
+#include <mutex>
+#include <functional>
+using namespace std;
+
+// everything the benchmark modes need to know
+struct BenchmarkOptions {
+    string mode = "engines";
+    string algo = "all";
+    int queries = 10;
+    int threads = 0; // 0 = number of cores
+    int k = 10;      // paths per query in yen mode
+    uint64_t seed = 42;
+};
+
+static void benchmarkHelp() {
+    cout << "Usage:\n"
+         << "  pcc-benchmark [graph] [options]\n\n"
+         << "Graph (default: generated Erdos-Renyi graph, see pcc-generator --help):\n"
+         << "  --file <filename>      Load graph from file instead of generating it\n"
+         << "  --type, --vertices, --edges, --rows, --cols, --scale, --min-weight, --max-weight, --seed\n\n"
+         << "Options:\n"
+         << "  --mode <name>          engines    - run single source engines with counters\n"
+         << "                         throughput - concurrent point-to-point queries, 1 .. --threads threads\n"
+         << "                         matrix     - --queries x --queries distance table vs. pairwise queries\n"
+         << "                         batched    - Bellman-Ford from --queries sources, one by one vs. 8/16 lanes\n"
+         << "                         yen        - --queries random k shortest paths queries\n"
+         << "                         dynamic    - --queries random edge weight changes, repair vs. full Dijkstra\n"
+         << "                         updates    - query latency on graph snapshots without and with a writer\n"
+         << "                         load       - parallel text loading of --file with 1 .. --threads threads\n"
+         << "                         compressed - memory and query time of the varint encoded graph\n"
+         << "                         external   - on-disk engines with a partition cache of 100 / 25 / 5 % of the graph\n"
+         << "                         placement  - query throughput and dTLB misses with huge pages / NUMA placement\n"
+         << "                         hub        - hub label build and query latency (1000 x --queries) vs. Dijkstra\n"
+         << "                         arcflags   - arc flag preprocessing for 16 / 32 / 64 cells and query speedup\n"
+         << "                         mld        - multi-level overlay: partition, customization (1 thread / --threads,\n"
+         << "                                      after --queries weight changes) and query time vs. Dijkstra\n"
+         << "                         isochrone  - 8 x --queries range queries from nearby sources: full Dijkstra,\n"
+         << "                                      bounded search, batches of 8 lanes (1 / --threads threads)\n"
+         << "                         poi        - 4 nearest of 1 % tagged vertices: full Dijkstra, early stop, buckets\n"
+         << "                         reachability - SCC index build, unreachable pairs with and without the index,\n"
+         << "                                      Bellman-Ford over all vs. over the reachable vertices\n"
+         << "                         cycle      - plants a negative cycle, V-1 passes vs. early detection\n"
+         << "  --algo <name>          dijkstra, bellman, dag (acyclic graphs only), bfs (equal or 0/1 weights)\n"
+         << "                         or all (default all)\n"
+         << "  --queries <q>          Number of random queries (default 10)\n"
+         << "  --threads <t>          Max number of threads for throughput mode (default: number of cores)\n"
+         << "  --k <k>                Paths per query in yen mode (default 10)\n"
+         << "  --query-seed <s>       Seed of random queries (default 42)\n"
+         << "  --help                 Show this help message and exit\n";
+}
+
+// random source vertices, same for every engine
+static vector<int> randomSources(const Graph& graph, int count, uint64_t seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> vertex(0, graph.getSize() - 1);
+    vector<int> sources(count);
+    for (int& s : sources) s = vertex(rng);
+    return sources;
+}
+
+// run one engine for all sources and print totals
+template <typename Engine>
+static void benchmarkEngine(const string& name, const Graph& graph, const vector<int>& sources, Engine engine) {
+    PerfCounters perf;
+    SearchStats stats;
+    HardwareCounters counters;
+    vector<int> distances, parent;
+    long long totalMicros = 0;
+    int failed = 0;
+
+    for (int source : sources) {
+        auto startTime = chrono::high_resolution_clock::now();
+        perf.start();
+        bool ok = engine(graph, source, distances, parent, &stats);
+        counters.add(perf.stop());
+        auto endTime = chrono::high_resolution_clock::now();
+        totalMicros += chrono::duration_cast<chrono::microseconds>(endTime - startTime).count();
+        if (!ok) failed++;
+    }
+
+    cout << "== " << name << " ==\n";
+    cout << "  queries                 " << sources.size() << " (" << failed << " failed)\n";
+    cout << "  total time              " << totalMicros << " us\n";
+    cout << "  average time            " << (sources.empty() ? 0 : totalMicros / (long long)sources.size()) << " us\n";
+    printStats(cout, stats, counters);
+}
+
+static void benchmarkEngines(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    if (options.algo == "dijkstra" || options.algo == "all")
+        benchmarkEngine("Dijkstra", graph, sources, Dijkstra::run);
+    if (options.algo == "bellman" || options.algo == "all")
+        benchmarkEngine("Bellman-Ford", graph, sources,
+                        static_cast<bool (*)(const Graph&, int, vector<int>&, vector<int>&, SearchStats*)>(BellmanFord::run));
+    vector<int> order;
+    if ((options.algo == "dag" || options.algo == "all") && DagShortestPath::topologicalOrder(graph, order)) {
+        benchmarkEngine("DAG", graph, sources, [&](const Graph& g, int s, vector<int>& d, vector<int>& p, SearchStats* st) {
+            return DagShortestPath::run(g, s, order, d, p, st);
+        });
+    }
+    if ((options.algo == "bfs" || options.algo == "all") && graph.hasUniformWeights()) {
+        benchmarkEngine("BFS", graph, sources, BreadthFirstSearch::run);
+        Graph reverse = graph.reversed();
+        benchmarkEngine("BFS direction-optimizing", graph, sources,
+                        [&](const Graph& g, int s, vector<int>& d, vector<int>& p, SearchStats* st) {
+            return BreadthFirstSearch::runDirectionOptimizing(g, reverse, s, d, p, st);
+        });
+    }
+    if ((options.algo == "bfs" || options.algo == "all") && graph.hasZeroOneWeights())
+        benchmarkEngine("0-1 BFS", graph, sources, BreadthFirstSearch::runZeroOne);
+}
+
+// queries/second of Dijkstra::query on shared graph for 1, 2, 4, ... threads
+static void benchmarkThroughput(const Graph& graph, const BenchmarkOptions& options) {
+    int maxThreads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    cout << "threads  queries/s  speedup\n";
+    double baseline = 0;
+    for (int threads : threadCounts) {
+        vector<SearchWorkspace> workspaces(threads);
+        atomic<int> next(0);
+        atomic<long long> checksum(0);
+        auto startTime = chrono::high_resolution_clock::now();
+        {
+            // every thread takes queries from a shared counter until all are done
+            ThreadPool pool(threads, threads);
+            for (int t = 0; t < threads; t++) {
+                pool.submit([&](int worker) {
+                    long long localSum = 0;
+                    for (int q = next++; q < (int)sources.size(); q = next++) {
+                        QueryResult result = Dijkstra::query(graph, sources[q], targets[q], workspaces[worker]);
+                        localSum += result.distance;
+                    }
+                    checksum += localSum;
+                });
+            }
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        double seconds = chrono::duration<double>(endTime - startTime).count();
+        double perSecond = seconds > 0 ? sources.size() / seconds : 0;
+        if (threads == 1) baseline = perSecond;
+        cout << setw(7) << threads << "  " << setw(9) << (long long)perSecond << "  "
+             << fixed << setprecision(2) << (baseline > 0 ? perSecond / baseline : 0) << "x"
+             << "   (checksum " << checksum << ")\n";
+        cout.unsetf(ios::fixed);
+    }
+}
+
+// many-to-many table against the same number of point-to-point queries
+static void benchmarkMatrix(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+
+    DistanceMatrix matrix;
+    auto tableStart = chrono::high_resolution_clock::now();
+    if (!DistanceTable::compute(graph, sources, targets, matrix, options.threads)) {
+        cerr << "Error: Distance table needs non-negative edges.\n";
+        return;
+    }
+    auto tableEnd = chrono::high_resolution_clock::now();
+
+    SearchWorkspace workspace;
+    int mismatches = 0;
+    auto pairStart = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < sources.size(); i++) {
+        for (size_t j = 0; j < targets.size(); j++) {
+            QueryResult result = Dijkstra::query(graph, sources[i], targets[j], workspace);
+            int distance = result.status == "OK" ? result.distance : INT_MAX;
+            if (distance != matrix.at(i, j)) mismatches++;
+        }
+    }
+    auto pairEnd = chrono::high_resolution_clock::now();
+
+    cout << "table " << sources.size() << " x " << targets.size() << "       "
+         << chrono::duration_cast<chrono::milliseconds>(tableEnd - tableStart).count() << " ms\n";
+    cout << "pairwise queries (1 thread) "
+         << chrono::duration_cast<chrono::milliseconds>(pairEnd - pairStart).count() << " ms\n";
+    cout << "mismatches                  " << mismatches << "\n";
+}
+
+// k scalar Bellman-Ford runs against one batched sweep with 8 and 16 lanes
+static void benchmarkBatched(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+
+    // scalar baseline is the early stopping BellmanFord::query, not the always V-1 passes run()
+    vector<vector<int>> scalar(sources.size(), vector<int>(graph.getSize()));
+    SearchWorkspace workspace;
+    SearchStats scalarStats;
+    auto scalarStart = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < sources.size(); i++) {
+        BellmanFord::query(graph, sources[i], -1, workspace, &scalarStats);
+        for (int v = 0; v < graph.getSize(); v++) scalar[i][v] = workspace.distance(v);
+    }
+    auto scalarEnd = chrono::high_resolution_clock::now();
+    cout << "scalar   " << setw(8) << chrono::duration_cast<chrono::milliseconds>(scalarEnd - scalarStart).count()
+         << " ms, edges relaxed " << scalarStats.edgesRelaxed << "\n";
+
+    for (int lanes : {8, 16}) {
+        vector<vector<int>> batched;
+        SearchStats stats;
+        auto startTime = chrono::high_resolution_clock::now();
+        BatchedBellmanFord::run(graph, sources, batched, lanes, &stats);
+        auto endTime = chrono::high_resolution_clock::now();
+        cout << "lanes " << setw(2) << lanes << " " << setw(8)
+             << chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count()
+             << " ms, edges relaxed " << stats.edgesRelaxed
+             << (batched == scalar ? ", results identical" : ", RESULTS DIFFER") << "\n";
+    }
+}
+
+// k shortest paths between random pairs, one workspace and one reversed graph for all queries
+static void benchmarkYen(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    const Graph reverse = graph.reversed();
+    SearchWorkspace workspace;
+    SearchStats stats;
+    long long totalMicros = 0, maxMicros = 0, paths = 0;
+    for (size_t q = 0; q < sources.size(); q++) {
+        auto startTime = chrono::high_resolution_clock::now();
+        vector<QueryResult> result = KShortestPaths::query(graph, reverse, sources[q], targets[q], options.k,
+                                                           workspace, &stats);
+        auto endTime = chrono::high_resolution_clock::now();
+        long long micros = chrono::duration_cast<chrono::microseconds>(endTime - startTime).count();
+        totalMicros += micros;
+        maxMicros = max(maxMicros, micros);
+        if (result[0].status == "OK") paths += result.size();
+    }
+    cout << "queries                 " << sources.size() << " (k = " << options.k << ", " << paths << " paths found)\n";
+    cout << "average time            " << (sources.empty() ? 0 : totalMicros / (long long)sources.size()) << " us\n";
+    cout << "max time                " << maxMicros << " us\n";
+    cout << "vertices settled        " << stats.verticesSettled << "\n";
+}
+
+// random weight changes of existing edges, incremental repair against a full search after every change
+static void benchmarkDynamic(const Graph& original, const BenchmarkOptions& options) {
+    Graph graph = original;
+    int source = randomSources(graph, 1, options.seed)[0];
+    auto buildStart = chrono::high_resolution_clock::now();
+    DynamicShortestPaths dynamic(graph, source);
+    auto buildEnd = chrono::high_resolution_clock::now();
+    if (!dynamic.isValid()) {
+        cerr << "Error: Dynamic shortest paths need non-negative edges.\n";
+        return;
+    }
+
+    mt19937_64 rng(options.seed + 3);
+    uniform_int_distribution<int> vertex(0, graph.getSize() - 1);
+    uniform_int_distribution<int> weight(max(graph.getMinWeight(), 0), max(graph.getMaxWeight(), 1));
+    SearchWorkspace workspace;
+    SearchStats repairStats, fullStats;
+    long long repairMicros = 0, fullMicros = 0;
+    int changes = 0, mismatches = 0;
+    while (changes < options.queries) {
+        int u = vertex(rng);
+        if (graph.getAdjList()[u].empty()) continue;
+        int v = graph.getAdjList()[u][rng() % graph.getAdjList()[u].size()].to;
+        changes++;
+
+        auto repairStart = chrono::high_resolution_clock::now();
+        dynamic.changeWeight(u, v, weight(rng), &repairStats);
+        auto repairEnd = chrono::high_resolution_clock::now();
+        Dijkstra::query(graph, source, -1, workspace, &fullStats);
+        auto fullEnd = chrono::high_resolution_clock::now();
+        repairMicros += chrono::duration_cast<chrono::microseconds>(repairEnd - repairStart).count();
+        fullMicros += chrono::duration_cast<chrono::microseconds>(fullEnd - repairEnd).count();
+        for (int x = 0; x < graph.getSize(); x++) {
+            if (dynamic.distance(x) != workspace.distance(x)) {
+                mismatches++;
+                break;
+            }
+        }
+    }
+
+    cout << "initial tree      " << setw(8) << chrono::duration_cast<chrono::microseconds>(buildEnd - buildStart).count()
+         << " us\n";
+    cout << "repair            " << setw(8) << (changes ? repairMicros / changes : 0) << " us per change, vertices settled "
+         << repairStats.verticesSettled << "\n";
+    cout << "full Dijkstra     " << setw(8) << (changes ? fullMicros / changes : 0) << " us per change, vertices settled "
+         << fullStats.verticesSettled << "\n";
+    cout << "changes " << changes << ", mismatches " << mismatches << "\n";
+}
+
+// latency percentiles of point-to-point queries on GraphStore snapshots,
+// first with a quiet graph, then while a writer publishes batches of 100 weight changes
+static void benchmarkUpdates(const Graph& graph, const BenchmarkOptions& options) {
+    int threads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    GraphStore store(graph);
+
+    for (bool writing : {false, true}) {
+        vector<long long> latencies(sources.size());
+        vector<SearchWorkspace> workspaces(threads);
+        atomic<int> next(0);
+        atomic<bool> done(false);
+        long long versionsBefore = store.snapshot()->version;
+
+        thread writer([&]() {
+            mt19937_64 rng(options.seed + 5);
+            uniform_int_distribution<int> vertex(0, graph.getSize() - 1);
+            uniform_int_distribution<int> weight(max(graph.getMinWeight(), 0), max(graph.getMaxWeight(), 1));
+            while (writing && !done) {
+                vector<EdgeUpdate> batch;
+                for (int i = 0; i < 100; i++) {
+                    int u = vertex(rng);
+                    if (graph.getAdjList()[u].empty()) continue;
+                    batch.push_back({u, graph.getAdjList()[u][rng() % graph.getAdjList()[u].size()].to, weight(rng)});
+                }
+                store.applyWeightUpdates(batch);
+            }
+        });
+        {
+            ThreadPool pool(threads, threads);
+            for (int t = 0; t < threads; t++) {
+                pool.submit([&](int worker) {
+                    for (int q = next++; q < (int)sources.size(); q = next++) {
+                        auto startTime = chrono::high_resolution_clock::now();
+                        shared_ptr<const GraphVersion> snapshot = store.snapshot();
+                        Dijkstra::query(snapshot->graph, sources[q], targets[q], workspaces[worker]);
+                        auto endTime = chrono::high_resolution_clock::now();
+                        latencies[q] = chrono::duration_cast<chrono::microseconds>(endTime - startTime).count();
+                    }
+                });
+            }
+        }
+        done = true;
+        writer.join();
+
+        sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double p) { return latencies[(size_t)(p * (latencies.size() - 1))]; };
+        cout << (writing ? "with updates " : "no updates   ") << " p50 " << setw(7) << percentile(0.5)
+             << " us  p99 " << setw(7) << percentile(0.99) << " us  max " << setw(7) << latencies.back()
+             << " us  versions published " << store.snapshot()->version - versionsBefore << "\n";
+    }
+}
+
+// memory of Graph vs CompressedGraph and the same queries on both
+static void benchmarkCompressed(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    auto buildStart = chrono::high_resolution_clock::now();
+    CompressedGraph compressed(graph);
+    auto buildEnd = chrono::high_resolution_clock::now();
+
+    size_t plainBytes = graph.memoryBytes(), compressedBytes = compressed.memoryBytes();
+    cout << "Graph           " << setw(12) << plainBytes << " bytes  "
+         << fixed << setprecision(2) << (double)plainBytes / max(1LL, graph.getEdgeCount()) << " B/edge\n";
+    cout << "CompressedGraph " << setw(12) << compressedBytes << " bytes  "
+         << (double)compressedBytes / max(1LL, graph.getEdgeCount()) << " B/edge  ("
+         << (double)plainBytes / max<size_t>(1, compressedBytes) << "x smaller, " << compressed.getWeightBytes()
+         << " B weights, built in " << chrono::duration_cast<chrono::milliseconds>(buildEnd - buildStart).count()
+         << " ms)\n";
+    cout.unsetf(ios::fixed);
+
+    auto timeQueries = [&](const string& name, auto&& graphToQuery) {
+        SearchWorkspace workspace;
+        long long checksum = 0;
+        auto startTime = chrono::high_resolution_clock::now();
+        for (size_t q = 0; q < sources.size(); q++) {
+            QueryResult result = graph.hasNegativeEdges()
+                ? BellmanFord::query(graphToQuery, sources[q], targets[q], workspace)
+                : Dijkstra::query(graphToQuery, sources[q], targets[q], workspace);
+            checksum += result.distance;
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        double ms = chrono::duration<double, milli>(endTime - startTime).count();
+        cout << name << setw(10) << (long long)(ms * 1000 / max<size_t>(1, sources.size())) << " us/query  checksum "
+             << checksum << "\n";
+        return ms;
+    };
+    double plainMs = timeQueries("Graph          ", graph);
+    double compressedMs = timeQueries("CompressedGraph", compressed);
+    cout << "slowdown " << fixed << setprecision(2) << compressedMs / max(plainMs, 1e-9) << "x\n";
+    cout.unsetf(ios::fixed);
+}
+
+// semi-external engines with shrinking partition cache, bytes read relative to the graph data
+static void benchmarkExternal(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    const string layout = "benchmark_external.pccx";
+    if (!ExternalGraph::write(graph, layout)) {
+        cerr << "Error: Cannot write " << layout << "\n";
+        return;
+    }
+    SearchWorkspace workspace;
+    auto memoryStart = chrono::high_resolution_clock::now();
+    for (int source : sources) {
+        if (graph.hasNegativeEdges()) BellmanFord::query(graph, source, -1, workspace);
+        else Dijkstra::query(graph, source, -1, workspace);
+    }
+    auto memoryEnd = chrono::high_resolution_clock::now();
+    cout << "in memory        " << setw(10) << chrono::duration_cast<chrono::microseconds>(memoryEnd - memoryStart).count() / max<size_t>(1, sources.size())
+         << " us/query\n";
+
+    long long dataBytes = ExternalGraph(layout).dataBytes();
+    for (int percent : {100, 25, 5}) {
+        ExternalGraph external(layout, (size_t)(dataBytes * percent / 100));
+        vector<int> distances, parent;
+        auto startTime = chrono::high_resolution_clock::now();
+        for (int source : sources) {
+            if (graph.hasNegativeEdges()) ExternalShortestPath::bellmanFord(external, source, distances, parent);
+            else ExternalShortestPath::dijkstra(external, source, distances, parent);
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        if (!external.isOpen()) return;
+        const ExternalIoStats& io = external.ioStats();
+        cout << "cache " << setw(3) << percent << " %      " << setw(10)
+             << chrono::duration_cast<chrono::microseconds>(endTime - startTime).count() / max<size_t>(1, sources.size())
+             << " us/query  read " << fixed << setprecision(2)
+             << (double)io.bytesRead / max(1LL, dataBytes) / max<size_t>(1, sources.size()) << "x graph/query  "
+             << io.partitionsRead << " partitions read, " << io.cacheHits << " cache hits\n";
+        cout.unsetf(ios::fixed);
+    }
+    remove(layout.c_str());
+}
+
+// concurrent queries on a GraphStore with every placement, dTLB misses summed over the worker threads
+// (each worker counts its own thread), huge page and node bytes as the kernel reports them
+static void benchmarkPlacement(const Graph& graph, const BenchmarkOptions& options) {
+    int threads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    vector<pair<string, PlacementOptions>> placements;
+    placements.push_back({"heap", PlacementOptions()});
+    PlacementOptions huge;
+    huge.hugePages = true;
+    placements.push_back({"huge pages", huge});
+    PlacementOptions interleave;
+    interleave.numa = "interleave";
+    interleave.pinThreads = true;
+    placements.push_back({"interleave, pinned", interleave});
+    interleave.hugePages = true;
+    placements.push_back({"interleave + huge, pinned", interleave});
+    PlacementOptions replicate = interleave;
+    replicate.numa = "replicate";
+    placements.push_back({"replicate + huge, pinned", replicate});
+
+    cout << Numa::nodeCount() << " NUMA node(s), " << threads << " threads\n";
+    cout << "placement                    ms/query   dTLB misses/query   huge page MB   MB per node\n";
+    for (const auto& [name, placement] : placements) {
+        GraphStore store(graph, placement);
+        vector<SearchWorkspace> workspaces(threads);
+        for (SearchWorkspace& workspace : workspaces) workspace.useHugePages(placement.hugePages);
+        atomic<int> next(0);
+        HardwareCounters counters;
+        counters.dtlbMisses = 0;
+        mutex countersLock;
+        auto startTime = chrono::high_resolution_clock::now();
+        {
+            ThreadPool pool(threads, threads, placement.pinThreads);
+            for (int t = 0; t < threads; t++) {
+                pool.submit([&](int worker) {
+                    PerfCounters perf;
+                    perf.start();
+                    shared_ptr<const GraphVersion> snapshot = store.snapshot();
+                    const Graph& local = snapshot->local(Numa::currentNode());
+                    for (int q = next++; q < (int)sources.size(); q = next++)
+                        Dijkstra::query(local, sources[q], targets[q], workspaces[worker]);
+                    HardwareCounters measured = perf.stop();
+                    lock_guard<mutex> guard(countersLock);
+                    if (measured.dtlbMisses < 0) counters.dtlbMisses = -1;
+                    else if (counters.dtlbMisses >= 0) counters.dtlbMisses += measured.dtlbMisses;
+                });
+            }
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        double seconds = chrono::duration<double>(endTime - startTime).count();
+
+        shared_ptr<const GraphVersion> snapshot = store.snapshot();
+        PlacementReport report = snapshot->graph.placementReport();
+        for (const Graph& replica : snapshot->replicas) report.add(replica.placementReport());
+        cout << left << setw(26) << name << right << fixed << setprecision(2) << setw(11)
+             << seconds * 1000 / max<size_t>(1, sources.size()) << setw(20);
+        cout.unsetf(ios::fixed);
+        if (counters.dtlbMisses < 0) cout << "n/a";
+        else cout << counters.dtlbMisses / max<size_t>(1, sources.size());
+        cout << setw(15);
+        if (report.hugePageBytes < 0) cout << "n/a";
+        else cout << report.hugePageBytes / (1 << 20);
+        cout << "   ";
+        if (report.bytesPerNode.empty()) cout << "n/a";
+        for (long long bytes : report.bytesPerNode) cout << bytes / (1 << 20) << " ";
+        cout << "\n";
+    }
+}
+
+// latency percentile of sorted nanosecond samples
+static long long percentile(const vector<long long>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    return sorted[min(sorted.size() - 1, (size_t)(fraction * sorted.size()))];
+}
+
+// labels are built once, then point-to-point latency of label lookups against Dijkstra::query
+static void benchmarkHub(const Graph& graph, const BenchmarkOptions& options) {
+    HubLabels labels;
+    auto buildStart = chrono::high_resolution_clock::now();
+    if (!labels.build(graph)) {
+        cerr << "Error: Hub labels need non-negative edge weights.\n";
+        return;
+    }
+    auto buildEnd = chrono::high_resolution_clock::now();
+    cout << "build " << chrono::duration_cast<chrono::milliseconds>(buildEnd - buildStart).count() << " ms, "
+         << labels.getLabelEntries() << " entries, average label " << fixed << setprecision(1)
+         << labels.averageLabelSize() << " hubs, " << labels.memoryBytes() / (1 << 20) << " MB (graph "
+         << graph.memoryBytes() / (1 << 20) << " MB)\n";
+    cout.unsetf(ios::fixed);
+
+    SearchWorkspace workspace;
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    vector<long long> dijkstraNs;
+    int wrong = 0;
+    for (size_t q = 0; q < sources.size(); q++) {
+        auto startTime = chrono::high_resolution_clock::now();
+        QueryResult result = Dijkstra::query(graph, sources[q], targets[q], workspace);
+        auto endTime = chrono::high_resolution_clock::now();
+        dijkstraNs.push_back(chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count());
+        int expected = result.status == "OK" ? result.distance : INT_MAX;
+        if (labels.distance(sources[q], targets[q]) != expected) wrong++;
+    }
+
+    vector<int> labelSources = randomSources(graph, options.queries * 1000, options.seed + 2);
+    vector<int> labelTargets = randomSources(graph, options.queries * 1000, options.seed + 3);
+    vector<long long> labelNs;
+    long long checksum = 0;
+    for (size_t q = 0; q < labelSources.size(); q++) {
+        auto startTime = chrono::high_resolution_clock::now();
+        checksum += labels.distance(labelSources[q], labelTargets[q]);
+        auto endTime = chrono::high_resolution_clock::now();
+        labelNs.push_back(chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count());
+    }
+    sort(dijkstraNs.begin(), dijkstraNs.end());
+    sort(labelNs.begin(), labelNs.end());
+    cout << "engine        queries     p50 ns     p99 ns\n";
+    cout << "Dijkstra   " << setw(10) << dijkstraNs.size() << setw(11) << percentile(dijkstraNs, 0.5)
+         << setw(11) << percentile(dijkstraNs, 0.99) << "\n";
+    cout << "hub labels " << setw(10) << labelNs.size() << setw(11) << percentile(labelNs, 0.5)
+         << setw(11) << percentile(labelNs, 0.99) << "   (checksum " << checksum << ")\n";
+    cout << "distances different from Dijkstra: " << wrong << "\n";
+}
+
+// point-to-point queries with and without arc flags, settled vertices show how narrow the search gets
+static void benchmarkArcFlags(const Graph& graph, const BenchmarkOptions& options) {
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    SearchWorkspace workspace;
+    auto timeQueries = [&](const ArcFlags* flags, SearchStats& stats, long long& checksum) {
+        auto startTime = chrono::high_resolution_clock::now();
+        for (size_t q = 0; q < sources.size(); q++) {
+            QueryResult result = flags ? Dijkstra::query(graph, *flags, sources[q], targets[q], workspace, &stats)
+                                       : Dijkstra::query(graph, sources[q], targets[q], workspace, &stats);
+            checksum += result.distance;
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        return chrono::duration<double, micro>(endTime - startTime).count() / max<size_t>(1, sources.size());
+    };
+
+    SearchStats plainStats;
+    long long plainChecksum = 0;
+    double plainUs = timeQueries(nullptr, plainStats, plainChecksum);
+    cout << "cells  build ms  flags/edge  boundary   us/query  settled/query  speedup\n";
+    cout << "    -         -           -         -" << setw(11) << (long long)plainUs << setw(15)
+         << plainStats.verticesSettled / max<size_t>(1, sources.size()) << "    1.00x\n";
+    for (int cells : {16, 32, 64}) {
+        ArcFlags flags;
+        auto buildStart = chrono::high_resolution_clock::now();
+        if (!flags.build(graph, cells, options.threads)) {
+            cerr << "Error: Arc flags need non-negative edge weights.\n";
+            return;
+        }
+        auto buildEnd = chrono::high_resolution_clock::now();
+        SearchStats stats;
+        long long checksum = 0;
+        double us = timeQueries(&flags, stats, checksum);
+        cout << setw(5) << flags.getCellCount() << setw(10)
+             << chrono::duration_cast<chrono::milliseconds>(buildEnd - buildStart).count() << setw(12) << fixed
+             << setprecision(2) << flags.averageFlags() << setw(10) << flags.getBoundaryVertices() << setw(11)
+             << (long long)us << setw(15) << stats.verticesSettled / max<size_t>(1, sources.size()) << setw(8)
+             << plainUs / max(us, 1e-9) << "x" << (checksum == plainChecksum ? "" : "   DISTANCES DIFFER") << "\n";
+        cout.unsetf(ios::fixed);
+    }
+}
+
+// the three phases of the multi-level overlay timed apart: partition once, customization per metric
+// (all cells, then only the cells of changed edges), queries over the overlay
+static void benchmarkOverlay(const Graph& original, const BenchmarkOptions& options) {
+    Graph graph = original;
+    int threads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    MultiLevelOverlay overlay;
+    vector<int> sizes = MultiLevelOverlay::defaultCellSizes(graph.getSize());
+    auto partitionStart = chrono::high_resolution_clock::now();
+    overlay.partition(graph, sizes);
+    auto partitionEnd = chrono::high_resolution_clock::now();
+    cout << "partition: " << chrono::duration_cast<chrono::milliseconds>(partitionEnd - partitionStart).count()
+         << " ms, " << overlay.getLevelCount() << " levels\n";
+    cout << "level  cell size  cells  boundary\n";
+    for (int level = 1; level <= overlay.getLevelCount(); level++) {
+        cout << setw(5) << level << setw(11) << sizes[level - 1] << setw(7) << overlay.getCellCount(level)
+             << setw(10) << overlay.getBoundaryVertices(level) << "\n";
+    }
+
+    auto printCustomization = [](const string& name, const CustomizationStats& stats) {
+        cout << left << setw(22) << name << right << setw(7) << stats.cellsCustomized << fixed << setprecision(1)
+             << setw(10) << stats.totalSeconds * 1000 << "   levels ms:";
+        for (double seconds : stats.levelSeconds) cout << " " << seconds * 1000;
+        cout << "\n";
+        cout.unsetf(ios::fixed);
+    };
+    cout << "customization          cells        ms\n";
+    CustomizationStats stats;
+    if (!overlay.customize(graph, 1, nullptr, &stats)) {
+        cerr << "Error: Multi-level overlay needs non-negative edge weights.\n";
+        return;
+    }
+    printCustomization("all cells, 1 thread", stats);
+    overlay.customize(graph, threads, nullptr, &stats);
+    printCustomization("all cells, " + to_string(threads) + " threads", stats);
+
+    // new metric: --queries random edges get a random weight in [min, max]
+    mt19937_64 rng(options.seed + 3);
+    vector<pair<int,int>> changed;
+    for (int u : randomSources(graph, options.queries, options.seed + 2)) {
+        if (graph.neighbors(u).empty()) continue;
+        int to = graph.neighbors(u)[rng() % graph.neighbors(u).size()].to;
+        uniform_int_distribution<int> weight(graph.getMinWeight(), max(graph.getMinWeight(), graph.getMaxWeight()));
+        graph.setEdgeWeight(u, to, weight(rng));
+        changed.push_back({u, to});
+    }
+    overlay.customize(graph, threads, &changed, &stats);
+    printCustomization(to_string(changed.size()) + " changed edges", stats);
+    cout << "overlay: " << overlay.getCliqueEntries() << " clique entries, "
+         << overlay.memoryBytes() / (1024 * 1024) << " MB\n\n";
+
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    vector<int> targets = randomSources(graph, options.queries, options.seed + 1);
+    SearchWorkspace workspace;
+    SearchStats dijkstraStats, overlayStats;
+    long long dijkstraChecksum = 0, overlayChecksum = 0;
+    auto dijkstraStart = chrono::high_resolution_clock::now();
+    for (size_t q = 0; q < sources.size(); q++) {
+        QueryResult result = Dijkstra::query(graph, sources[q], targets[q], workspace, &dijkstraStats);
+        dijkstraChecksum += result.status == "OK" ? result.distance : -1;
+    }
+    auto overlayStart = chrono::high_resolution_clock::now();
+    for (size_t q = 0; q < sources.size(); q++) {
+        int distance = overlay.distance(graph, sources[q], targets[q], workspace, &overlayStats);
+        overlayChecksum += distance == INT_MAX ? -1 : distance;
+    }
+    auto overlayEnd = chrono::high_resolution_clock::now();
+    size_t queries = max<size_t>(1, sources.size());
+    double dijkstraUs = chrono::duration<double, micro>(overlayStart - dijkstraStart).count() / queries;
+    double overlayUs = chrono::duration<double, micro>(overlayEnd - overlayStart).count() / queries;
+    cout << "engine      us/query  settled/query\n";
+    cout << "Dijkstra " << setw(11) << (long long)dijkstraUs << setw(15) << dijkstraStats.verticesSettled / queries << "\n";
+    cout << "overlay  " << setw(11) << (long long)overlayUs << setw(15) << overlayStats.verticesSettled / queries
+         << "   speedup " << fixed << setprecision(2) << dijkstraUs / max(overlayUs, 1e-9) << "x"
+         << (dijkstraChecksum == overlayChecksum ? "" : "   DISTANCES DIFFER") << "\n";
+    cout.unsetf(ios::fixed);
+}
+
+// range queries the old way (whole Dijkstra, then filter), bounded one by one and batched
+// sources come in groups of 8 nearest vertices around --queries random centers, the budget reaches
+// about 2 % of the vertices from the first center
+static void benchmarkIsochrone(const Graph& graph, const BenchmarkOptions& options) {
+    int threads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    vector<int> centers = randomSources(graph, options.queries, options.seed);
+    if (centers.empty()) return;
+    SearchWorkspace workspace;
+    IsochroneResult result;
+    if (Dijkstra::query(graph, centers[0], -1, workspace).status != "OK") {
+        cerr << "Error: Isochrones need non-negative edge weights.\n";
+        return;
+    }
+    vector<int> reached;
+    for (int v = 0; v < graph.getSize(); v++) {
+        if (workspace.distance(v) != INT_MAX) reached.push_back(workspace.distance(v));
+    }
+    sort(reached.begin(), reached.end());
+    int budget = reached[min(reached.size() - 1, (size_t)max(1, graph.getSize() / 50))];
+
+    vector<int> sources, randomGroup;
+    for (int center : centers) {
+        Isochrone::query(graph, center, INT_MAX - 1, workspace, result);
+        for (size_t i = 0; i < 8; i++) sources.push_back(result.vertices[min(i, result.vertices.size() - 1)]);
+    }
+    randomGroup = randomSources(graph, (int)sources.size(), options.seed + 1);
+    vector<int> budgets(sources.size(), budget);
+    cout << sources.size() << " sources, budget " << budget << "\n";
+
+    long long expected = 0;
+    // run returns a checksum of the isochrones and counts scanned vertices in stats
+    auto timeRun = [&](const string& name, const function<long long(SearchStats&)>& run) {
+        SearchStats stats;
+        auto startTime = chrono::high_resolution_clock::now();
+        long long checksum = run(stats);
+        auto endTime = chrono::high_resolution_clock::now();
+        double us = chrono::duration<double, micro>(endTime - startTime).count() / sources.size();
+        if (name == "full Dijkstra") expected = checksum;
+        cout << left << setw(28) << name << right << setw(12) << (long long)us << setw(16)
+             << stats.verticesSettled / (long long)sources.size()
+             << (checksum == expected || name == "batch, random sources" ? "" : "   RESULTS DIFFER") << "\n";
+    };
+    auto sum = [](const IsochroneResult& isochrone) {
+        long long total = (long long)isochrone.vertices.size();
+        for (int d : isochrone.distances) total += d;
+        return total;
+    };
+    cout << "engine                          us/source  scans/source\n";
+    timeRun("full Dijkstra", [&](SearchStats& stats) {
+        long long checksum = 0;
+        for (int source : sources) {
+            Dijkstra::query(graph, source, -1, workspace, &stats);
+            for (int v = 0; v < graph.getSize(); v++) {
+                if (workspace.distance(v) <= budget) checksum += 1 + workspace.distance(v);
+            }
+        }
+        return checksum;
+    });
+    timeRun("bounded query", [&](SearchStats& stats) {
+        long long checksum = 0;
+        for (int source : sources) {
+            Isochrone::query(graph, source, budget, workspace, result, &stats);
+            checksum += sum(result);
+        }
+        return checksum;
+    });
+    timeRun("batch, 1 thread", [&](SearchStats& stats) {
+        long long checksum = 0;
+        for (const IsochroneResult& isochrone : Isochrone::batch(graph, sources, budgets, 1, &stats)) checksum += sum(isochrone);
+        return checksum;
+    });
+    timeRun("batch, " + to_string(threads) + " threads", [&](SearchStats& stats) {
+        long long checksum = 0;
+        for (const IsochroneResult& isochrone : Isochrone::batch(graph, sources, budgets, threads, &stats)) checksum += sum(isochrone);
+        return checksum;
+    });
+    timeRun("batch, random sources", [&](SearchStats& stats) {
+        long long checksum = 0;
+        for (const IsochroneResult& isochrone : Isochrone::batch(graph, randomGroup, budgets, 1, &stats)) checksum += sum(isochrone);
+        return checksum;
+    });
+}
+
+// k nearest facilities: settle everything and pick the closest tagged vertices, Dijkstra stopped at the
+// k-th facility, and precomputed buckets (build time apart from the lookups)
+static void benchmarkPoi(const Graph& original, const BenchmarkOptions& options) {
+    const int K = 4;
+    Graph graph = original;
+    for (int v : randomSources(graph, max(K, graph.getSize() / 100), options.seed + 4)) graph.setCategories(v, 1);
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+    size_t queries = max<size_t>(1, sources.size());
+    SearchWorkspace workspace;
+    NearestResult result;
+
+    cout << "engine               build ms   us/query  settled/query\n";
+    SearchStats fullStats, earlyStats;
+    long long fullChecksum = 0, earlyChecksum = 0, bucketChecksum = 0;
+    auto fullStart = chrono::high_resolution_clock::now();
+    for (int source : sources) {
+        if (Dijkstra::query(graph, source, -1, workspace, &fullStats).status != "OK") {
+            cerr << "Error: Nearest facilities need non-negative edge weights.\n";
+            return;
+        }
+        vector<pair<int,int>> tagged;
+        for (int v = 0; v < graph.getSize(); v++) {
+            if (graph.getCategories(v) && workspace.distance(v) != INT_MAX) tagged.push_back({workspace.distance(v), v});
+        }
+        partial_sort(tagged.begin(), tagged.begin() + min<size_t>(K, tagged.size()), tagged.end());
+        for (size_t i = 0; i < K && i < tagged.size(); i++) fullChecksum += tagged[i].first;
+    }
+    auto earlyStart = chrono::high_resolution_clock::now();
+    for (int source : sources) {
+        PointsOfInterest::nearest(graph, source, 1, K, workspace, result, &earlyStats);
+        for (int d : result.distances) earlyChecksum += d;
+    }
+    auto buildStart = chrono::high_resolution_clock::now();
+    PoiBuckets buckets;
+    buckets.build(graph, 1, K);
+    auto bucketStart = chrono::high_resolution_clock::now();
+    for (int source : sources) {
+        buckets.nearest(source, K, result);
+        for (int d : result.distances) bucketChecksum += d;
+    }
+    auto bucketEnd = chrono::high_resolution_clock::now();
+
+    auto us = [&](chrono::high_resolution_clock::time_point from, chrono::high_resolution_clock::time_point to) {
+        return chrono::duration<double, micro>(to - from).count() / queries;
+    };
+    cout << "full Dijkstra              -" << setw(11) << (long long)us(fullStart, earlyStart) << setw(15)
+         << fullStats.verticesSettled / (long long)queries << "\n";
+    cout << "early stop                 -" << setw(11) << (long long)us(earlyStart, buildStart) << setw(15)
+         << earlyStats.verticesSettled / (long long)queries
+         << (earlyChecksum == fullChecksum ? "" : "   DISTANCES DIFFER") << "\n";
+    cout << "buckets     " << setw(15) << chrono::duration_cast<chrono::milliseconds>(bucketStart - buildStart).count()
+         << fixed << setprecision(2) << setw(11) << us(bucketStart, bucketEnd) << setw(15) << 0
+         << (bucketChecksum == fullChecksum ? "" : "   DISTANCES DIFFER") << "   (" << buckets.memoryBytes() / 1024
+         << " kB)\n";
+    cout.unsetf(ios::fixed);
+}
+
+// impossible queries: a search explores everything reachable before it says "Unreachable",
+// the index answers from the component DAG; Bellman-Ford passes over all vs. the reachable vertices
+static void benchmarkReachability(const Graph& graph, const BenchmarkOptions& options) {
+    ReachabilityIndex index;
+    auto buildStart = chrono::high_resolution_clock::now();
+    index.build(graph);
+    auto buildEnd = chrono::high_resolution_clock::now();
+    cout << "index: " << index.getComponentCount() << " components, " << index.getDagEdges() << " DAG edges, "
+         << (index.hasClosure() ? "closure" : "DAG search") << ", " << index.memoryBytes() / 1024 << " kB, built in "
+         << chrono::duration_cast<chrono::milliseconds>(buildEnd - buildStart).count() << " ms\n";
+
+    // random pairs, the unreachable ones are the interesting part
+    vector<int> sources = randomSources(graph, options.queries * 10, options.seed);
+    vector<int> targets = randomSources(graph, options.queries * 10, options.seed + 1);
+    vector<pair<int,int>> unreachable;
+    auto indexStart = chrono::high_resolution_clock::now();
+    for (size_t q = 0; q < sources.size(); q++) {
+        if (!index.reachable(sources[q], targets[q])) unreachable.push_back({sources[q], targets[q]});
+    }
+    auto indexEnd = chrono::high_resolution_clock::now();
+    cout << unreachable.size() << " of " << sources.size() << " random pairs are unreachable, index "
+         << fixed << setprecision(3)
+         << chrono::duration<double, micro>(indexEnd - indexStart).count() / max<size_t>(1, sources.size())
+         << " us/pair\n";
+    cout.unsetf(ios::fixed);
+
+    SearchWorkspace workspace;
+    bool negative = graph.hasNegativeEdges();
+    if (!negative && !unreachable.empty()) {
+        SearchStats stats;
+        auto startTime = chrono::high_resolution_clock::now();
+        for (const auto& [start, end] : unreachable) Dijkstra::query(graph, start, end, workspace, &stats);
+        auto endTime = chrono::high_resolution_clock::now();
+        cout << "Dijkstra on unreachable pairs: "
+             << (long long)(chrono::duration<double, micro>(endTime - startTime).count() / unreachable.size())
+             << " us/query, " << stats.verticesSettled / (long long)unreachable.size() << " settled/query\n";
+    }
+
+    cout << "Bellman-Ford          us/query   scans/query\n";
+    size_t queries = min<size_t>(sources.size(), max(1, options.queries));
+    for (bool restricted : {false, true}) {
+        SearchStats stats;
+        auto startTime = chrono::high_resolution_clock::now();
+        for (size_t q = 0; q < queries; q++) {
+            if (restricted) BellmanFord::query(graph, index, sources[q], targets[q], workspace, &stats);
+            else BellmanFord::query(graph, sources[q], targets[q], workspace, &stats);
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        cout << (restricted ? "reachable vertices " : "all vertices       ") << setw(12)
+             << (long long)(chrono::duration<double, micro>(endTime - startTime).count() / queries) << setw(14)
+             << stats.verticesSettled / (long long)queries << "\n";
+    }
+}
+
+// GB/s of GraphLoader::loadText for 1, 2, 4, ... threads
+static void benchmarkLoad(const string& filename, const BenchmarkOptions& options) {
+    int maxThreads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    cout << "threads     read    parse    build    total     GB/s  speedup\n";
+    double baseline = 0;
+    for (int threads : threadCounts) {
+        LoadStats stats;
+        Graph graph = GraphLoader::loadText(filename, threads, &stats);
+        if (threads == 1) baseline = stats.totalSeconds;
+        cout << setw(7) << threads << fixed << setprecision(3)
+             << setw(9) << stats.readSeconds << setw(9) << stats.parseSeconds << setw(9) << stats.buildSeconds
+             << setw(9) << stats.totalSeconds << setw(9) << stats.gigabytesPerSecond() << setw(8) << setprecision(2)
+             << (stats.totalSeconds > 0 ? baseline / stats.totalSeconds : 0) << "x"
+             << "   (" << graph.getSize() << " vertices, " << stats.edges << " edges)\n";
+        cout.unsetf(ios::fixed);
+    }
+}
+
+// run() needs all V-1 passes to see a negative cycle, runWithCycle stops as soon as it is proven
+static void benchmarkCycle(const Graph& original, const BenchmarkOptions& options) {
+    // cycle of three random vertices with total weight -3
+    Graph graph = original;
+    vector<int> cycleVertices = randomSources(graph, 3, options.seed + 7);
+    for (int i = 0; i < 3; i++) graph.addEdge(cycleVertices[i], cycleVertices[(i + 1) % 3], -1);
+    vector<int> sources = randomSources(graph, options.queries, options.seed);
+
+    vector<int> distances, parent;
+    NegativeCycle cycle;
+    SearchStats passStats, earlyStats;
+    int passCycles = 0, earlyCycles = 0;
+    auto passStart = chrono::high_resolution_clock::now();
+    for (int source : sources) {
+        if (!BellmanFord::run(graph, source, distances, parent, &passStats)) passCycles++;
+    }
+    auto passEnd = chrono::high_resolution_clock::now();
+    for (int source : sources) {
+        if (!BellmanFord::runWithCycle(graph, source, distances, parent, cycle, &earlyStats)) earlyCycles++;
+    }
+    auto earlyEnd = chrono::high_resolution_clock::now();
+    auto wholeStart = chrono::high_resolution_clock::now();
+    bool noCycle = BellmanFord::runWithCycle(graph, -1, distances, parent, cycle);
+    auto wholeEnd = chrono::high_resolution_clock::now();
+
+    cout << "V-1 passes        " << setw(8) << chrono::duration_cast<chrono::milliseconds>(passEnd - passStart).count()
+         << " ms, edges relaxed " << passStats.edgesRelaxed << ", cycles " << passCycles << "\n";
+    cout << "early detection   " << setw(8) << chrono::duration_cast<chrono::milliseconds>(earlyEnd - passEnd).count()
+         << " ms, edges relaxed " << earlyStats.edgesRelaxed << ", cycles " << earlyCycles << "\n";
+    cout << "whole graph       " << setw(8) << chrono::duration_cast<chrono::microseconds>(wholeEnd - wholeStart).count()
+         << " us, cycle of " << (noCycle ? 0 : cycle.vertices.size()) << " vertices, weight " << cycle.weight << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions generator;
+    BenchmarkOptions options;
+    string filename;
+
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--help") {
+            benchmarkHelp();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Error: Unknown or incomplete argument '" << argument << "'.\n";
+            return 1;
+        }
+        string value = argv[++i];
+        try {
+            if (GraphGenerator::setOption(generator, argument, value)) continue;
+            if (argument == "--file") filename = value;
+            else if (argument == "--mode") options.mode = value;
+            else if (argument == "--algo") options.algo = value;
+            else if (argument == "--queries") options.queries = stoi(value);
+            else if (argument == "--threads") options.threads = stoi(value);
+            else if (argument == "--k") options.k = stoi(value);
+            else if (argument == "--query-seed") options.seed = stoull(value);
+            else {
+                cerr << "Error: Unknown argument '" << argument << "'.\n";
+                return 1;
+            }
+        } catch (...) {
+            cerr << "Error: Value of " << argument << " must be a number.\n";
+            return 1;
+        }
+    }
+
+    if (options.mode == "load") {
+        if (filename.empty()) {
+            cerr << "Error: Mode load needs --file.\n";
+            return 1;
+        }
+        benchmarkLoad(filename, options);
+        return 0;
+    }
+
+    auto loadStart = chrono::high_resolution_clock::now();
+    Graph graph = filename.empty() ? GraphGenerator::generateGraph(generator) : loadGraphFromFile(filename);
+    auto loadEnd = chrono::high_resolution_clock::now();
+    if (graph.getSize() == 0) {
+        cerr << "Error: Graph is empty.\n";
+        return 1;
+    }
+
+    long long edges = 0;
+    for (const auto& list : graph.getAdjList()) edges += list.size();
+    cout << "Graph: " << graph.getSize() << " vertices, " << edges << " edges (loaded in "
+         << chrono::duration_cast<chrono::milliseconds>(loadEnd - loadStart).count() << " ms, peak RSS "
+         << peakRssKb() / 1024 << " MB)\n";
+
+    if (options.mode == "engines") {
+        benchmarkEngines(graph, options);
+    } else if (options.mode == "throughput") {
+        benchmarkThroughput(graph, options);
+    } else if (options.mode == "matrix") {
+        benchmarkMatrix(graph, options);
+    } else if (options.mode == "batched") {
+        benchmarkBatched(graph, options);
+    } else if (options.mode == "dynamic") {
+        benchmarkDynamic(graph, options);
+    } else if (options.mode == "updates") {
+        benchmarkUpdates(graph, options);
+    } else if (options.mode == "cycle") {
+        benchmarkCycle(graph, options);
+    } else if (options.mode == "yen") {
+        benchmarkYen(graph, options);
+    } else if (options.mode == "compressed") {
+        benchmarkCompressed(graph, options);
+    } else if (options.mode == "external") {
+        benchmarkExternal(graph, options);
+    } else if (options.mode == "placement") {
+        benchmarkPlacement(graph, options);
+    } else if (options.mode == "hub") {
+        benchmarkHub(graph, options);
+    } else if (options.mode == "arcflags") {
+        benchmarkArcFlags(graph, options);
+    } else if (options.mode == "mld") {
+        benchmarkOverlay(graph, options);
+    } else if (options.mode == "isochrone") {
+        benchmarkIsochrone(graph, options);
+    } else if (options.mode == "poi") {
+        benchmarkPoi(graph, options);
+    } else if (options.mode == "reachability") {
+        benchmarkReachability(graph, options);
+    } else {
+        cerr << "Error: Unknown mode '" << options.mode << "'.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+//
+// Created by filip on 2.11.2025.
+//
+// Standalone tool for generating synthetic benchmark graphs.
+// Output is either the "u v w" text format of loadGraphFromFile or the compact binary format.
+//
+#include "GraphGenerator.h"
+#include <iostream>
+#include <chrono>
+#include <climits>
+using namespace std;
+
+static void generatorHelp() {
+    cout << "Usage:\n"
+         << "  pcc-generator --type <er|grid|rmat|dag|negative> --out <filename> [options]\n\n"
+         << "Options:\n"
+         << "  --type <name>          er       - Erdos-Renyi random graph (--vertices, --edges)\n"
+         << "                         grid     - 2D road-like grid (--rows, --cols)\n"
+         << "                         rmat     - R-MAT / Kronecker power-law graph (--scale, --edges)\n"
+         << "                         dag      - random acyclic graph (--vertices, --edges)\n"
+         << "                         negative - negative weights without negative cycle (--vertices, --edges)\n"
+         << "  --vertices <n>         Number of vertices (default 1000)\n"
+         << "  --edges <m>            Number of edges (default 5000)\n"
+         << "  --rows <r> --cols <c>  Grid size (default 32 x 32)\n"
+         << "  --scale <s>            R-MAT graph has 2^s vertices (default 10)\n"
+         << "  --min-weight <w>       Minimal edge weight (default 1)\n"
+         << "  --max-weight <w>       Maximal edge weight (default 100)\n"
+         << "  --seed <s>             Random seed (default 1)\n"
+         << "  --format <text|binary> Output format (default text)\n"
+         << "  --out <filename>       Output file\n"
+         << "  --help                 Show this help message and exit\n";
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    string output, format = "text";
+
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--help") {
+            generatorHelp();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Error: Unknown or incomplete argument '" << argument << "'.\n";
+            return 1;
+        }
+        string value = argv[++i];
+        try {
+            if (GraphGenerator::setOption(options, argument, value)) continue;
+            if (argument == "--format") format = value;
+            else if (argument == "--out") output = value;
+            else {
+                cerr << "Error: Unknown argument '" << argument << "'.\n";
+                return 1;
+            }
+        } catch (...) {
+            cerr << "Error: Value of " << argument << " must be a number.\n";
+            return 1;
+        }
+    }
+
+    if (output.empty()) {
+        cerr << "Error: Missing required --out argument.\n";
+        return 1;
+    }
+    if (format != "text" && format != "binary") {
+        cerr << "Error: Unknown format '" << format << "'. Use 'text' or 'binary'.\n";
+        return 1;
+    }
+    if (options.minWeight > options.maxWeight) {
+        cerr << "Error: --min-weight must not be greater than --max-weight.\n";
+        return 1;
+    }
+    if (options.vertices < 1 || options.edges < 1 || options.rows < 1 || options.cols < 1) {
+        cerr << "Error: --vertices, --edges, --rows and --cols must be positive.\n";
+        return 1;
+    }
+    if (options.type == "grid" && (long long)options.rows * options.cols > INT_MAX) {
+        cerr << "Error: --rows x --cols must be at most " << INT_MAX << " vertices.\n";
+        return 1;
+    }
+    if (options.scale < 1 || options.scale > 30) {
+        cerr << "Error: --scale must be in range 1-30.\n";
+        return 1;
+    }
+
+    EdgeFileWriter writer(output, format == "binary");
+    if (!writer.isOpen()) {
+        cerr << "Cannot open file " << output << endl;
+        return 1;
+    }
+
+    auto startTime = chrono::high_resolution_clock::now();
+    int vertices = GraphGenerator::generate(options, [&writer](int from, int to, int weight) {
+        writer.write(from, to, weight);
+    });
+    if (vertices < 0) {
+        cerr << "Error: Unknown graph type '" << options.type << "'.\n";
+        return 1;
+    }
+    writer.close(vertices);
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
+
+    cout << "Generated " << options.type << " graph: " << vertices << " vertices, "
+         << writer.getEdgeCount() << " edges -> " << output << " (" << format << ", "
+         << duration << " ms)" << endl;
+    return 0;
+}
@@ -5,7 +5,22 @@
 #include "Graph.h"
 #include "Dijkstra.h"
 #include "BellmanFord.h"
+#include "PerfCounters.h"
+#include "QueryServer.h"
+#include "DistanceTable.h"
+#include "KShortestPaths.h"
+#include "DagShortestPath.h"
+#include "BreadthFirstSearch.h"
+#include "ExternalShortestPath.h"
+#include "HubLabels.h"
+#include "MultiLevelOverlay.h"
+#include "Isochrone.h"
+#include "PointsOfInterest.h"
 #include <iostream>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <climits>
 using namespace std;
 
 // ---------- Main function ----------
@@ -17,6 +32,19 @@ int main(int argc, char* argv[]) {
     }
 
     string mode, algo, filename;
+    bool printCounters = false;
+    string serveMode, socketPath;
+    string sourcesFile, targetsFile; // --matrix mode
+    int isochroneSource = -1, isochroneBudget = -1; // --isochrone mode
+    string categoriesFile; // --categories input
+    int nearestSource = -1, nearestCategory = -1, nearestCount = 0; // --nearest mode
+    int pathCount = 3; // --k for --algo yen
+    int cellCount = 32; // --cells for --algo arcflags
+    string externalFile; // --write-external output
+    string labelsFile;   // --write-labels output
+    int cacheMegabytes = 64; // --cache for --external
+    ServerOptions serverOptions;
+    serverOptions.threads = max(1, (int)thread::hardware_concurrency());
 
     int manualArgsIndex = -1; // pro loadGraphFromArgs
     // --- Parse command line arguments ---
@@ -30,6 +58,20 @@ int main(int argc, char* argv[]) {
             mode = "file";
             filename = argv[++i];
         }
+        else if (argument == "--external" && i + 1 < argc) {
+            mode = "external";
+            filename = argv[++i];
+        }
+        else if (argument == "--write-external" && i + 1 < argc) {
+            externalFile = argv[++i];
+        }
+        else if (argument == "--labels" && i + 1 < argc) {
+            mode = "labels";
+            filename = argv[++i];
+        }
+        else if (argument == "--write-labels" && i + 1 < argc) {
+            labelsFile = argv[++i];
+        }
         else if (argument == "--stdin") {
             mode = "stdin";
         }
@@ -40,6 +82,81 @@ int main(int argc, char* argv[]) {
         else if (argument == "--algo" && i + 1 < argc) {
             algo = argv[++i];
         }
+        else if (argument == "--stats") {
+            printCounters = true;
+        }
+        else if (argument == "--huge-pages") {
+            serverOptions.placement.hugePages = true;
+        }
+        else if (argument == "--pin") {
+            serverOptions.placement.pinThreads = true;
+        }
+        else if (argument == "--numa" && i + 1 < argc) {
+            serverOptions.placement.numa = argv[++i];
+            if (serverOptions.placement.numa != "local" && serverOptions.placement.numa != "interleave" &&
+                serverOptions.placement.numa != "replicate") {
+                cerr << "Error: --numa must be local, interleave or replicate.\n";
+                return 1;
+            }
+        }
+        else if (argument == "--serve" && i + 1 < argc) {
+            serveMode = "socket";
+            socketPath = argv[++i];
+        }
+        else if (argument == "--serve-stdin") {
+            serveMode = "stdin";
+        }
+        else if (argument == "--matrix" && i + 2 < argc) {
+            sourcesFile = argv[++i];
+            targetsFile = argv[++i];
+        }
+        else if (argument == "--isochrone" && i + 2 < argc) {
+            try {
+                isochroneSource = stoi(argv[++i]);
+                isochroneBudget = stoi(argv[++i]);
+            } catch (...) {
+                isochroneSource = isochroneBudget = -1;
+            }
+            if (isochroneSource < 0 || isochroneBudget < 0) {
+                cerr << "Error: --isochrone needs a vertex and a non-negative budget.\n";
+                return 1;
+            }
+        }
+        else if (argument == "--categories" && i + 1 < argc) {
+            categoriesFile = argv[++i];
+        }
+        else if (argument == "--nearest" && i + 3 < argc) {
+            try {
+                nearestSource = stoi(argv[++i]);
+                nearestCategory = stoi(argv[++i]);
+                nearestCount = stoi(argv[++i]);
+            } catch (...) {
+                nearestSource = -1;
+            }
+            if (nearestSource < 0 || nearestCategory < 0 || nearestCategory > 63 || nearestCount <= 0) {
+                cerr << "Error: --nearest needs a vertex, a category 0-63 and a positive count.\n";
+                return 1;
+            }
+        }
+        else if ((argument == "--threads" || argument == "--queue" || argument == "--k" || argument == "--cache" ||
+                  argument == "--cells") &&
+                 i + 1 < argc) {
+            int value;
+            try {
+                value = stoi(argv[++i]);
+            } catch (...) {
+                value = 0;
+            }
+            if (value <= 0) {
+                cerr << "Error: " << argument << " must be a positive integer.\n";
+                return 1;
+            }
+            if (argument == "--threads") serverOptions.threads = value;
+            else if (argument == "--k") pathCount = value;
+            else if (argument == "--cache") cacheMegabytes = value;
+            else if (argument == "--cells") cellCount = value;
+            else serverOptions.queueCapacity = value;
+        }
         else {
             // ignorujeme argumenty pro manual, jdou do loadGraphFromArgs
             if (mode != "manual") {
@@ -49,7 +166,8 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (algo.empty()) {
+    if (algo.empty() && serveMode.empty() && sourcesFile.empty() && externalFile.empty() && labelsFile.empty() &&
+        isochroneSource < 0 && nearestSource < 0 && mode != "labels") {
         cerr << "Error: Missing required --algo argument.\n";
         return 1;
     }
@@ -57,13 +175,70 @@ int main(int argc, char* argv[]) {
         cerr << "Error: Must specify one of --file, --stdin, or --manual.\n";
         return 1;
     }
+    if (!serveMode.empty() && mode == "stdin") {
+        cerr << "Error: Server mode needs graph from --file or --manual, stdin is used for queries.\n";
+        return 1;
+    }
+
+    // --- Graph on disk (layout from --write-external), only distances are kept in memory ---
+    if (mode == "external") {
+        ExternalGraph external(filename, (size_t)cacheMegabytes << 20);
+        if (!external.isOpen()) return 1;
+        if (algo != "dijkstra" && algo != "bellman") {
+            cerr << "Error: --external supports --algo dijkstra or bellman.\n";
+            return 1;
+        }
+        if (external.getSize() == 0) {
+            cerr << "Error: Graph has no vertices.\n";
+            return 1;
+        }
+        int start = readIntInRange("Enter start vertex: ", 0, external.getSize() - 1);
+        int end = readIntInRange("Enter end vertex: ", 0, external.getSize() - 1);
+        SearchStats stats;
+        HardwareCounters counters;
+        auto result = ExternalShortestPath::shortestPath(external, start, end, algo, &stats, &counters);
+        if (!external.isOpen()) return 1; // corrupt partition, reason is on cerr
+        if (printCounters) printStats(cout, stats, counters);
+        if (result.first == "OK")
+            cout << "Shortest path (" << start << " -> " << end << ") = " << result.second << " [external " << algo << "]\n";
+        else
+            cout << "External " << algo << ": " << result.first << endl;
+        return 0;
+    }
+
+    // --- Distance from hub labels (--write-labels), the graph itself is not loaded ---
+    if (mode == "labels") {
+        HubLabels labels;
+        if (!labels.load(filename)) {
+            cerr << "Error: " << filename << " is not a hub label file.\n";
+            return 1;
+        }
+        if (labels.getSize() == 0) {
+            cerr << "Error: Graph has no vertices.\n";
+            return 1;
+        }
+        int start = readIntInRange("Enter start vertex: ", 0, labels.getSize() - 1);
+        int end = readIntInRange("Enter end vertex: ", 0, labels.getSize() - 1);
+        auto startTime = chrono::high_resolution_clock::now();
+        int distance = labels.distance(start, end);
+        auto endTime = chrono::high_resolution_clock::now();
+        if (distance == INT_MAX)
+            cout << "No path from " << start << " to " << end << "\n";
+        else
+            cout << "Shortest distance (" << start << " -> " << end << ") = " << distance << " [hub labels]\n";
+        cerr << "Query took " << chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count()
+             << " ns, average label " << labels.averageLabelSize() << " hubs\n";
+        return 0;
+    }
 
     Graph graph(0); // placeholder
     int vertices = 0;
 
     // --- Load graph based on selected mode ---
+    auto loadStart = chrono::high_resolution_clock::now();
+    LoadStats loadStats;
     if (mode == "file") {
-        graph = loadGraphFromFile(filename);
+        graph = loadGraphFromFile(filename, serverOptions.threads, &loadStats);
         vertices = graph.getSize();
     }
     else if (mode == "stdin") {
@@ -78,14 +253,184 @@ int main(int argc, char* argv[]) {
         }
         graph = loadGraphFromArgs(argc, argv, manualArgsIndex, vertices);
     }
+    if (!categoriesFile.empty()) loadCategories(graph, categoriesFile);
+    if (printCounters) {
+        auto loadEnd = chrono::high_resolution_clock::now();
+        cerr << "Graph loaded: " << graph.getSize() << " vertices, " << graph.getEdgeCount() << " edges in "
+             << chrono::duration_cast<chrono::milliseconds>(loadEnd - loadStart).count() << " ms, peak RSS "
+             << peakRssKb() << " kB\n";
+        if (loadStats.bytes > 0) {
+            if (loadStats.compressedBytes > 0)
+                cerr << "Decompressed " << loadStats.compressedBytes << " bytes, parser waited "
+                     << (long long)(loadStats.readSeconds * 1000) << " ms for the decompression thread\n";
+            cerr << "Parsed " << loadStats.bytes << " bytes with " << loadStats.threads << " threads: read "
+                 << (long long)(loadStats.readSeconds * 1000) << " ms, parse " << (long long)(loadStats.parseSeconds * 1000)
+                 << " ms, build " << (long long)(loadStats.buildSeconds * 1000) << " ms, "
+                 << loadStats.gigabytesPerSecond() << " GB/s\n";
+        }
+    }
+
+    // --- Conversion to the on-disk layout of --external ---
+    if (!externalFile.empty()) {
+        if (!ExternalGraph::write(graph, externalFile)) {
+            cerr << "Error: Cannot write " << externalFile << ".\n";
+            return 1;
+        }
+        cerr << "External graph written to " << externalFile << "\n";
+        return 0;
+    }
+
+    // --- Hub labels for distance queries without the graph (--labels) ---
+    if (!labelsFile.empty()) {
+        HubLabels labels;
+        auto startTime = chrono::high_resolution_clock::now();
+        if (!labels.build(graph)) {
+            cerr << "Error: Hub labels need non-negative edge weights.\n";
+            return 1;
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        if (!labels.save(labelsFile)) {
+            cerr << "Error: Cannot write " << labelsFile << ".\n";
+            return 1;
+        }
+        cerr << "Hub labels written to " << labelsFile << ": built in "
+             << chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count() << " ms, "
+             << labels.getLabelEntries() << " entries (average label " << labels.averageLabelSize() << " hubs, "
+             << labels.memoryBytes() / 1024 << " kB in memory)\n";
+        return 0;
+    }
+
+    // --- Huge pages / NUMA placement of the adjacency lists (the server places every version itself) ---
+    const PlacementOptions& placement = serverOptions.placement;
+    if (serveMode.empty() && (placement.hugePages || placement.numa != "local")) {
+        // one search thread reads the graph, with "replicate" its copy goes to the node it runs on
+        graph = graph.placed(placement, placement.numa == "replicate" ? Numa::currentNode() : -1);
+        if (printCounters) printPlacement(cerr, graph.placementReport());
+    }
+
+    // --- Server mode - graph stays loaded and queries are answered until shutdown ---
+    if (!serveMode.empty()) {
+        if (!algo.empty()) serverOptions.defaultAlgo = algo;
+        QueryServer server(move(graph), serverOptions);
+        if (printCounters && !placement.isDefault()) printPlacement(cerr, server.placementReport());
+        if (serveMode == "stdin") {
+            server.serveStream(cin, cout);
+            cerr << server.statsLine() << endl;
+            return 0;
+        }
+        return server.serveUnixSocket(socketPath) ? 0 : 1;
+    }
+
+    // --- Many-to-many mode - whole sources x targets matrix, -1 = unreachable ---
+    if (!sourcesFile.empty()) {
+        vector<int> sources = loadVertexList(sourcesFile);
+        vector<int> targets = loadVertexList(targetsFile);
+        DistanceMatrix matrix;
+        auto startTime = chrono::high_resolution_clock::now();
+        if (!DistanceTable::compute(graph, sources, targets, matrix, serverOptions.threads)) {
+            cerr << "Error: Vertices must be in range 0-" << vertices - 1 << " and no negative cycle may be reachable.\n";
+            return 1;
+        }
+        auto endTime = chrono::high_resolution_clock::now();
+        for (int i = 0; i < matrix.rows; i++) {
+            for (int j = 0; j < matrix.cols; j++) {
+                int distance = matrix.at(i, j);
+                cout << (distance == INT_MAX ? -1 : distance) << (j + 1 < matrix.cols ? " " : "\n");
+            }
+        }
+        cerr << "Distance table " << matrix.rows << " x " << matrix.cols << " computed in "
+             << chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count() << " ms\n";
+        return 0;
+    }
+
+    // --- Isochrone mode - every vertex within the budget, one "<vertex> <distance>" line each ---
+    if (isochroneSource >= 0) {
+        SearchWorkspace workspace;
+        IsochroneResult result;
+        SearchStats stats;
+        auto startTime = chrono::high_resolution_clock::now();
+        Isochrone::query(graph, isochroneSource, isochroneBudget, workspace, result, &stats);
+        auto endTime = chrono::high_resolution_clock::now();
+        if (result.status != "OK") {
+            cerr << "Isochrone: " << result.status << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < result.vertices.size(); i++) cout << result.vertices[i] << " " << result.distances[i] << "\n";
+        cerr << result.vertices.size() << " vertices within " << isochroneBudget << " of " << isochroneSource << " found in "
+             << chrono::duration_cast<chrono::microseconds>(endTime - startTime).count() << " microseconds\n";
+        return 0;
+    }
+
+    // --- Nearest points of interest - k closest vertices of a category, "<vertex> <distance>" lines ---
+    if (nearestSource >= 0) {
+        SearchWorkspace workspace;
+        NearestResult result;
+        SearchStats stats;
+        auto startTime = chrono::high_resolution_clock::now();
+        PointsOfInterest::nearest(graph, nearestSource, 1ULL << nearestCategory, nearestCount, workspace, result, &stats);
+        auto endTime = chrono::high_resolution_clock::now();
+        if (result.status != "OK") {
+            cerr << "Nearest: " << result.status << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < result.vertices.size(); i++) cout << result.vertices[i] << " " << result.distances[i] << "\n";
+        cerr << result.vertices.size() << " of category " << nearestCategory << " found in "
+             << chrono::duration_cast<chrono::microseconds>(endTime - startTime).count() << " microseconds ("
+             << stats.verticesSettled << " vertices settled)\n";
+        return 0;
+    }
+
+    // --- Acyclic graphs are solved in O(V + E) by the DAG engine instead of Bellman-Ford ---
+    vector<int> topologicalOrder;
+    bool acyclic = false;
+    if (algo == "bellman" || algo == "dag" || algo == "auto") {
+        auto startTime = chrono::high_resolution_clock::now();
+        acyclic = DagShortestPath::topologicalOrder(graph, topologicalOrder);
+        auto endTime = chrono::high_resolution_clock::now();
+        cerr << "Graph is " << (acyclic ? "acyclic" : "cyclic") << " (checked in "
+             << chrono::duration_cast<chrono::microseconds>(endTime - startTime).count() << " microseconds)\n";
+        if (algo == "dag" && !acyclic) {
+            cerr << "Error: --algo dag needs an acyclic graph.\n";
+            return 1;
+        }
+        if (algo == "auto") {
+            // engine by the weight profile of the graph
+            algo = BreadthFirstSearch::chooseEngine(graph, acyclic);
+            cerr << "Weights " << graph.getMinWeight() << " .. " << graph.getMaxWeight() << ", using " << algo << "\n";
+        }
+        if (acyclic && algo == "bellman") algo = "dag";
+    }
+
+    // --- Whole graph negative cycle search, no start/end vertex ---
+    if (algo == "cycle") {
+        vector<int> distances, parent;
+        NegativeCycle cycle;
+        auto startTime = chrono::high_resolution_clock::now();
+        bool noCycle = BellmanFord::runWithCycle(graph, -1, distances, parent, cycle);
+        auto endTime = chrono::high_resolution_clock::now();
+        if (noCycle) {
+            cout << "No negative cycle\n";
+        } else {
+            cout << "Negative cycle:";
+            for (int v : cycle.vertices) cout << " " << v;
+            cout << " " << cycle.vertices[0] << " (weight " << cycle.weight << ")\n";
+        }
+        cerr << "Searched in " << chrono::duration_cast<chrono::microseconds>(endTime - startTime).count()
+             << " microseconds\n";
+        return 0;
+    }
 
     // --- Read start and end vertices safely ---
     int start = readIntInRange("Enter start vertex: ", 0, vertices-1);
     int end   = readIntInRange("Enter end vertex: ", 0, vertices-1);
 
     // --- Run the selected algorithm ---
+    SearchStats stats;
+    PerfCounters perf;
     if (algo == "dijkstra") {
-        int dist = Dijkstra::shortestPath(graph, start, end);
+        HardwareCounters counters;
+        int dist = Dijkstra::shortestPath(graph, start, end, &stats, &counters);
+        if (printCounters) printStats(cout, stats, counters);
         if (dist == -1) {
             cerr << "Dijkstra: Unreachable\n";
             return 1;
@@ -94,14 +439,108 @@ int main(int argc, char* argv[]) {
         }
     }
     else if (algo == "bellman") {
-        auto result = BellmanFord::shortestPath(graph, start, end);
+        HardwareCounters counters;
+        auto result = BellmanFord::shortestPath(graph, start, end, &stats, &counters);
+        if (printCounters) printStats(cout, stats, counters);
         if (result.first == "OK")
             cout << "Shortest path (" << start << " -> " << end << ") = " << result.second << " [Bellman-Ford]\n";
         else
             cout << "Bellman-Ford: " << result.first << endl;
     }
+    else if (algo == "dag") {
+        HardwareCounters counters;
+        auto result = DagShortestPath::shortestPath(graph, start, end, topologicalOrder, &stats, &counters);
+        if (printCounters) printStats(cout, stats, counters);
+        if (result.first == "OK")
+            cout << "Shortest path (" << start << " -> " << end << ") = " << result.second << " [DAG]\n";
+        else
+            cout << "DAG: " << result.first << endl;
+    }
+    else if (algo == "bfs" || algo == "bfs-01" || algo == "bfs-do") {
+        HardwareCounters counters;
+        auto result = BreadthFirstSearch::shortestPath(graph, start, end, algo, &stats, &counters);
+        if (printCounters) printStats(cout, stats, counters);
+        if (result.first == "OK")
+            cout << "Shortest path (" << start << " -> " << end << ") = " << result.second << " [" << algo << "]\n";
+        else
+            cout << "BFS: " << result.first << endl;
+    }
+    else if (algo == "arcflags") {
+        ArcFlags flags;
+        auto buildStart = chrono::high_resolution_clock::now();
+        if (!flags.build(graph, cellCount, serverOptions.threads)) {
+            cerr << "Error: Arc flags need non-negative edge weights.\n";
+            return 1;
+        }
+        auto buildEnd = chrono::high_resolution_clock::now();
+        cerr << "Arc flags for " << flags.getCellCount() << " cells (" << flags.getBoundaryVertices()
+             << " boundary vertices) built in " << chrono::duration_cast<chrono::milliseconds>(buildEnd - buildStart).count()
+             << " ms, " << flags.averageFlags() << " cells per edge\n";
+        SearchWorkspace workspace;
+        perf.start();
+        QueryResult result = Dijkstra::query(graph, flags, start, end, workspace, &stats);
+        HardwareCounters counters = perf.stop();
+        auto endTime = chrono::high_resolution_clock::now();
+        if (printCounters) printStats(cout, stats, counters);
+        if (result.status != "OK") {
+            cerr << "Arc flags: " << result.status << "\n";
+            return 1;
+        }
+        cout << "Path:";
+        for (int v : result.path) cout << " " << v;
+        cout << "\nShortest path (" << start << " -> " << end << ") = " << result.distance << " [arc flags, "
+             << chrono::duration_cast<chrono::microseconds>(endTime - buildEnd).count() << " microseconds]\n";
+    }
+    else if (algo == "mld") {
+        MultiLevelOverlay overlay;
+        auto buildStart = chrono::high_resolution_clock::now();
+        overlay.partition(graph, MultiLevelOverlay::defaultCellSizes(graph.getSize()));
+        auto partitionEnd = chrono::high_resolution_clock::now();
+        CustomizationStats customization;
+        if (!overlay.customize(graph, serverOptions.threads, nullptr, &customization)) {
+            cerr << "Error: Multi-level overlay needs non-negative edge weights.\n";
+            return 1;
+        }
+        auto buildEnd = chrono::high_resolution_clock::now();
+        cerr << "Overlay of " << overlay.getLevelCount() << " levels partitioned in "
+             << chrono::duration_cast<chrono::milliseconds>(partitionEnd - buildStart).count() << " ms, customized in "
+             << chrono::duration_cast<chrono::milliseconds>(buildEnd - partitionEnd).count() << " ms\n";
+        SearchWorkspace workspace;
+        perf.start();
+        int distance = overlay.distance(graph, start, end, workspace, &stats);
+        HardwareCounters counters = perf.stop();
+        auto endTime = chrono::high_resolution_clock::now();
+        if (printCounters) printStats(cout, stats, counters);
+        if (distance == INT_MAX) {
+            cerr << "Multi-level overlay: No path found\n";
+            return 1;
+        }
+        cout << "Shortest path (" << start << " -> " << end << ") = " << distance << " [overlay, "
+             << chrono::duration_cast<chrono::microseconds>(endTime - buildEnd).count() << " microseconds]\n";
+    }
+    else if (algo == "yen") {
+        const Graph reverse = graph.reversed();
+        SearchWorkspace workspace;
+        auto startTime = chrono::high_resolution_clock::now();
+        perf.start();
+        vector<QueryResult> paths = KShortestPaths::query(graph, reverse, start, end, pathCount, workspace, &stats);
+        HardwareCounters counters = perf.stop();
+        auto endTime = chrono::high_resolution_clock::now();
+        if (printCounters) printStats(cout, stats, counters);
+        if (paths[0].status != "OK") {
+            cerr << "Yen: " << paths[0].status << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < paths.size(); i++) {
+            cout << i + 1 << ". distance " << paths[i].distance << ", path:";
+            for (int v : paths[i].path) cout << " " << v;
+            cout << "\n";
+        }
+        cout << paths.size() << " shortest paths (" << start << " -> " << end << ") found in "
+             << chrono::duration_cast<chrono::microseconds>(endTime - startTime).count() << " microseconds [Yen]\n";
+    }
     else {
-        cerr << "Error: Unknown algorithm '" << algo << "'. Use 'dijkstra' or 'bellman'.\n";
+        cerr << "Error: Unknown algorithm '" << algo << "'. Use 'dijkstra', 'bellman', 'dag', 'bfs', 'bfs-01', 'bfs-do', 'auto', 'arcflags', 'mld', 'yen' or 'cycle'.\n";
         return 1;
     }
 
@@ -9,11 +9,40 @@
 #include "../BellmanFord.h"
 #include "catch.h"
 #include "MainHelpers.h"
+#include "../GraphGenerator.h"
+#include "../PerfCounters.h"
+#include "../QueryServer.h"
+#include "../SearchWorkspace.h"
+#include "../DistanceTable.h"
+#include "../BatchedBellmanFord.h"
+#include "../KShortestPaths.h"
+#include "../DagShortestPath.h"
+#include "../BreadthFirstSearch.h"
+#include "../DynamicShortestPaths.h"
+#include "../GraphStore.h"
+#include "../GraphLoader.h"
+#include "../CompressedInput.h"
+#include "../CompressedGraph.h"
+#include "../ExternalShortestPath.h"
+#include "../MemoryPlacement.h"
+#include "../HubLabels.h"
+#include "../ArcFlags.h"
+#include "../MultiLevelOverlay.h"
+#include "../Isochrone.h"
+#include "../PointsOfInterest.h"
+#include "../ReachabilityIndex.h"
+#include <thread>
 #include <climits>
 # include <sstream>
 #include <fstream>
 #include <algorithm>
 #include <iostream>
+#include <random>
+#include <cmath>
+#include <functional>
+#ifdef PCC_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace std;
 
@@ -35,6 +64,23 @@ bool verifyPath(const Graph& g, const vector<int>& path, int expectedDistance) {
     return total == expectedDistance;
 }
 
+// generated graph of every listed type for the "same result as the plain engine" tests,
+// grids get about the same number of vertices (sqrt(vertices) x sqrt(vertices))
+static void forEachGeneratedGraph(initializer_list<const char*> types, int vertices, long long edges, uint64_t seed,
+                                  const function<void(Graph& graph)>& check) {
+    for (const char* type : types) {
+        INFO("graph type " << type);
+        GeneratorOptions options;
+        options.type = type;
+        options.vertices = vertices;
+        options.edges = edges;
+        options.rows = options.cols = (int)sqrt(vertices);
+        options.seed = seed;
+        Graph graph = GraphGenerator::generateGraph(options);
+        check(graph);
+    }
+}
+
 // ----------------------- DIJKSTRA TESTS ------------------------------
 
 TEST_CASE("Dijkstra - simple graph with positive edges", "[dijkstra-basic]") {
@@ -143,6 +189,55 @@ TEST_CASE("Bellman-Ford - detects negative weight cycle", "[bf-cycle]") {
     REQUIRE(result.second == -1);
 }
 
+TEST_CASE("Bellman-Ford - extracts the negative cycle", "[bf-cycle-extract]") {
+    // 0 -> 1 -> 2 -> 3 -> 1 has weight -1, 4 is only reachable through the cycle
+    Graph g(6);
+    g.addEdge(0, 1, 5);
+    g.addEdge(1, 2, 2);
+    g.addEdge(2, 3, -4);
+    g.addEdge(3, 1, 1);
+    g.addEdge(3, 1, 3); // parallel edge, the cheaper one counts
+    g.addEdge(3, 4, 1);
+
+    vector<int> distances, parent;
+    NegativeCycle cycle;
+    REQUIRE_FALSE(BellmanFord::runWithCycle(g, 0, distances, parent, cycle));
+    REQUIRE(cycle.weight == -1);
+    vector<int> sorted = cycle.vertices;
+    sort(sorted.begin(), sorted.end());
+    REQUIRE(sorted == vector<int>{1, 2, 3});
+    // vertices are in edge order
+    for (size_t i = 0; i < cycle.vertices.size(); i++) {
+        int u = cycle.vertices[i], v = cycle.vertices[(i + 1) % cycle.vertices.size()];
+        bool edge = false;
+        for (const Edge& e : g.getAdjList()[u]) edge |= e.to == v;
+        REQUIRE(edge);
+    }
+
+    // cycle is not reachable from 5, but the whole graph search finds it
+    REQUIRE(BellmanFord::runWithCycle(g, 5, distances, parent, cycle));
+    REQUIRE(BellmanFord::runWithCycle(g, -1, distances, parent, cycle) == false);
+    REQUIRE(cycle.weight == -1);
+
+    // without a cycle the distances are the same as of run()
+    GeneratorOptions options;
+    options.type = "negative";
+    options.vertices = 200;
+    options.edges = 1000;
+    options.seed = 3;
+    Graph h = GraphGenerator::generateGraph(options);
+    for (int s : {0, 17, 150}) {
+        vector<int> expected, expectedParent;
+        REQUIRE(BellmanFord::run(h, s, expected, expectedParent));
+        REQUIRE(BellmanFord::runWithCycle(h, s, distances, parent, cycle));
+        REQUIRE(distances == expected);
+    }
+    // self loop is a cycle of one vertex
+    h.addEdge(42, 42, -1);
+    REQUIRE_FALSE(BellmanFord::runWithCycle(h, -1, distances, parent, cycle));
+    REQUIRE(cycle.vertices == vector<int>{42});
+}
+
 TEST_CASE("Bellman-Ford - unreachable vertex", "[bf-unreachable]") {
     Graph g(4);
     g.addEdge(0, 1, 2);
@@ -288,3 +383,1463 @@ TEST_CASE("Main - helper function output", "[main-help]") {
     cout.rdbuf(origCout);
 }
 
+
+// --------------------- Graph generator ---------------------
+TEST_CASE("Generator - grid graph has 4-neighbour edges", "[generator-grid]") {
+    GeneratorOptions options;
+    options.type = "grid";
+    options.rows = 3;
+    options.cols = 4;
+    Graph g = GraphGenerator::generateGraph(options);
+    REQUIRE(g.getSize() == 12);
+
+    long long edges = 0;
+    for (int u = 0; u < g.getSize(); u++) edges += g.getAdjList()[u].size();
+    REQUIRE(edges == 2 * (3 * 3 + 2 * 4)); // every road in both directions
+}
+
+TEST_CASE("Generator - grid with more than INT_MAX vertices is rejected", "[generator-grid]") {
+    GeneratorOptions options;
+    options.type = "grid";
+    options.rows = 50000;
+    options.cols = 50000;
+    long long edges = 0;
+    REQUIRE(GraphGenerator::generate(options, [&edges](int, int, int) { edges++; }) == -1);
+    GraphGenerator::grid(options.rows, options.cols, 1, 1, 1, [&edges](int, int, int) { edges++; });
+    REQUIRE(edges == 0);
+    REQUIRE(GraphGenerator::generateGraph(options).getSize() == 0);
+}
+
+TEST_CASE("Generator - DAG and negative graphs have no negative cycle", "[generator-negative]") {
+    GeneratorOptions options;
+    options.type = "negative";
+    options.vertices = 60;
+    options.edges = 400;
+    options.seed = 7;
+    Graph negative = GraphGenerator::generateGraph(options);
+
+    bool hasNegativeEdge = false;
+    for (int u = 0; u < negative.getSize(); u++)
+        for (auto e : negative.getAdjList()[u])
+            if (e.weight < 0) hasNegativeEdge = true;
+    REQUIRE(hasNegativeEdge);
+    REQUIRE(BellmanFord::shortestPath(negative, 0, 1).first != "Negative weight cycle detected");
+
+    options.type = "dag";
+    options.minWeight = -20;
+    Graph dag = GraphGenerator::generateGraph(options);
+    REQUIRE(BellmanFord::shortestPath(dag, 0, 1).first != "Negative weight cycle detected");
+}
+
+TEST_CASE("Generator - binary file round trip", "[generator-binary]") {
+    GeneratorOptions options;
+    options.type = "rmat";
+    options.scale = 6;
+    options.edges = 300;
+    {
+        EdgeFileWriter writer("test_generated.bin", true);
+        REQUIRE(writer.isOpen());
+        int vertices = GraphGenerator::generate(options, [&writer](int u, int v, int w) { writer.write(u, v, w); });
+        writer.close(vertices);
+    }
+    Graph fromFile = loadGraphFromFile("test_generated.bin");
+    Graph inMemory = GraphGenerator::generateGraph(options);
+    REQUIRE(fromFile.getSize() == 64);
+    for (int u = 0; u < inMemory.getSize(); u++)
+        REQUIRE(fromFile.getNeighbors(u) == inMemory.getNeighbors(u));
+}
+
+// --------------------- Parallel loading ---------------------
+TEST_CASE("Loader - parallel text parsing matches the sequential parser", "[loader]") {
+    GeneratorOptions options;
+    options.vertices = 300;
+    options.edges = 4000;
+    options.minWeight = -50;
+    options.seed = 13;
+    {
+        EdgeFileWriter writer("test_loader.txt", false);
+        int vertices = GraphGenerator::generate(options, [&writer](int u, int v, int w) { writer.write(u, v, w); });
+        writer.close(vertices);
+    }
+    Graph expected = GraphGenerator::generateGraph(options);
+    for (int threads : {1, 3, 8}) {
+        LoadStats stats;
+        Graph g = GraphLoader::loadText("test_loader.txt", threads, &stats);
+        REQUIRE(stats.edges == 4000);
+        REQUIRE(g.getSize() == expected.getSize());
+        REQUIRE(g.getMinWeight() == expected.getMinWeight());
+        // adjacency lists in file order, same as addEdge one by one
+        for (int u = 0; u < g.getSize(); u++) REQUIRE(g.getNeighbors(u) == expected.getNeighbors(u));
+    }
+
+    // reading stops at the first bad token, triples may span lines
+    {
+        ofstream out("test_loader.txt");
+        out << "0 1 5\n1 2 +3\r\n\n2 3 4x\n3 4 1\n";
+    }
+    Graph stopped = GraphLoader::loadText("test_loader.txt", 4);
+    REQUIRE(stopped.getSize() == 4);
+    REQUIRE(stopped.getEdgeCount() == 3);
+    REQUIRE(stopped.edgeWeight(1, 2) == 3);
+    REQUIRE(stopped.edgeWeight(2, 3) == 4);
+    {
+        ofstream out("test_loader.txt");
+        out << "0 1\n5 1\n2 7\n2 3 1\n";
+    }
+    Graph spanning = GraphLoader::loadText("test_loader.txt", 4);
+    REQUIRE(spanning.getEdgeCount() == 3);
+    REQUIRE(spanning.edgeWeight(2, 3) == 1);
+    remove("test_loader.txt");
+}
+
+// --------------------- File formats ---------------------
+TEST_CASE("Formats - DIMACS, METIS and Matrix Market readers", "[formats]") {
+    {
+        ofstream out("test_formats.gr");
+        out << "c 9th DIMACS challenge\np sp 4 4\nc arcs\na 1 2 7\na 2 3 -2\na 1 3 9\r\na 3 4 1\n";
+    }
+    REQUIRE(GraphLoader::detectFormat("test_formats.gr") == "dimacs");
+    LoadStats stats;
+    Graph dimacs = loadGraphFromFile("test_formats.gr", 0, &stats);
+    REQUIRE(dimacs.getSize() == 4);
+    REQUIRE(stats.edges == 4);
+    REQUIRE(dimacs.getNeighbors(0) == vector<pair<int,int>>{{1, 7}, {2, 9}});
+    REQUIRE(dimacs.edgeWeight(1, 2) == -2);
+    REQUIRE(BellmanFord::shortestPath(dimacs, 0, 3).second == 6);
+
+    // METIS, undirected, fmt 011 = vertex weights and edge weights, vertex 4 has no neighbours
+    {
+        ofstream out("test_formats.graph");
+        out << "% comment\n4 2 011\n5 2 3\n1 1 3 3 4\n2 2 4\n\n";
+    }
+    REQUIRE(GraphLoader::detectFormat("test_formats.graph") == "metis");
+    Graph metis = loadGraphFromFile("test_formats.graph");
+    REQUIRE(metis.getSize() == 4);
+    REQUIRE(metis.getEdgeCount() == 4);
+    REQUIRE(metis.edgeWeight(0, 1) == 3);
+    REQUIRE(metis.edgeWeight(1, 0) == 3);
+    REQUIRE(metis.edgeWeight(2, 1) == 4);
+    REQUIRE(metis.getNeighbors(3).empty());
+
+    // Matrix Market, symmetric real, entries are only in the lower triangle
+    {
+        ofstream out("test_formats.mtx");
+        out << "%%MatrixMarket matrix coordinate real symmetric\n% comment\n3 3 3\n2 1 1.6\n3 2 4.0\n3 3 2\n";
+    }
+    Graph mtx = loadGraphFromFile("test_formats.mtx");
+    REQUIRE(mtx.getSize() == 3);
+    REQUIRE(mtx.getEdgeCount() == 5);
+    REQUIRE(mtx.edgeWeight(0, 1) == 2);
+    REQUIRE(mtx.edgeWeight(1, 0) == 2);
+    REQUIRE(mtx.edgeWeight(2, 2) == 2);
+
+    // no known extension, the header decides
+    {
+        ofstream out("test_formats.txt");
+        out << "%%MatrixMarket matrix coordinate pattern general\n2 2 1\n1 2\n";
+    }
+    REQUIRE(GraphLoader::detectFormat("test_formats.txt") == "mtx");
+    REQUIRE(loadGraphFromFile("test_formats.txt").edgeWeight(0, 1) == 1);
+    {
+        ofstream out("test_formats.txt");
+        out << "p sp 2 1\na 2 1 3\n";
+    }
+    REQUIRE(GraphLoader::detectFormat("test_formats.txt") == "dimacs");
+    {
+        ofstream out("test_formats.txt");
+        out << "0 1 5\n";
+    }
+    REQUIRE(GraphLoader::detectFormat("test_formats.txt") == "text");
+    for (const char* file : {"test_formats.gr", "test_formats.graph", "test_formats.mtx", "test_formats.txt"}) remove(file);
+}
+
+#ifdef PCC_HAVE_ZLIB
+TEST_CASE("Formats - gzip input is decompressed while parsing", "[compressed]") {
+    GeneratorOptions options;
+    options.vertices = 2000;
+    options.edges = 200000; // several decompressed blocks
+    options.seed = 5;
+    string text;
+    GraphGenerator::generate(options, [&text](int u, int v, int w) {
+        text += to_string(u) + " " + to_string(v) + " " + to_string(w) + "\n";
+    });
+    {
+        ofstream out("test_compressed.txt");
+        out << text;
+    }
+    // two gzip members in one file, like cat a.gz b.gz
+    size_t half = text.find('\n', text.size() / 2) + 1;
+    gzFile first = gzopen("test_compressed.txt.gz", "wb");
+    gzwrite(first, text.data(), (unsigned)half);
+    gzclose(first);
+    gzFile second = gzopen("test_compressed.txt.gz", "ab");
+    gzwrite(second, text.data() + half, (unsigned)(text.size() - half));
+    gzclose(second);
+
+    REQUIRE(CompressedInput::compression("test_compressed.txt.gz") == "gzip");
+    REQUIRE(CompressedInput::compression("test_compressed.txt").empty());
+    REQUIRE(GraphLoader::detectFormat("test_compressed.txt.gz") == "text");
+    LoadStats stats;
+    Graph compressed = loadGraphFromFile("test_compressed.txt.gz", 2, &stats);
+    Graph plain = loadGraphFromFile("test_compressed.txt");
+    REQUIRE(stats.edges == 200000);
+    REQUIRE(stats.bytes == (long long)text.size());
+    REQUIRE(stats.compressedBytes > 0);
+    REQUIRE(compressed.getSize() == plain.getSize());
+    for (int u = 0; u < plain.getSize(); u++) REQUIRE(compressed.getNeighbors(u) == plain.getNeighbors(u));
+
+    // header formats go through the same stream
+    gzFile dimacs = gzopen("test_compressed.gr.gz", "wb");
+    gzputs(dimacs, "p sp 3 2\na 1 2 4\na 2 3 5\n");
+    gzclose(dimacs);
+    REQUIRE(GraphLoader::detectFormat("test_compressed.gr.gz") == "dimacs");
+    REQUIRE(BellmanFord::shortestPath(loadGraphFromFile("test_compressed.gr.gz"), 0, 2).second == 9);
+    for (const char* file : {"test_compressed.txt", "test_compressed.txt.gz", "test_compressed.gr.gz"}) remove(file);
+}
+#endif
+
+// --------------------- Compressed adjacency ---------------------
+TEST_CASE("Compressed graph - varint lists give the same distances", "[compressed-graph]") {
+    forEachGeneratedGraph({"er", "grid", "negative"}, 400, 3000, 21, [](Graph& graph) {
+        graph.addEdge(5, 6, 1);
+        graph.addEdge(5, 6, 1); // parallel edges give a zero gap
+        CompressedGraph compressed(graph);
+        REQUIRE(compressed.getSize() == graph.getSize());
+        REQUIRE(compressed.getEdgeCount() == graph.getEdgeCount());
+        REQUIRE(compressed.memoryBytes() < graph.memoryBytes());
+
+        // same multiset of edges per vertex, sorted by neighbour
+        for (int u = 0; u < graph.getSize(); u++) {
+            vector<pair<int,int>> expected = graph.getNeighbors(u), actual;
+            for (const Edge& edge : compressed.neighbors(u)) actual.push_back({edge.to, edge.weight});
+            sort(expected.begin(), expected.end());
+            REQUIRE(actual == expected);
+        }
+
+        SearchWorkspace plainWorkspace, compressedWorkspace;
+        for (int start : {0, 7, 123}) {
+            int end = graph.getSize() - 1 - start;
+            if (graph.hasNegativeEdges()) {
+                vector<int> plainDistances, plainParent, distances, parent;
+                REQUIRE(BellmanFord::run(graph, start, plainDistances, plainParent) ==
+                        BellmanFord::run(compressed, start, distances, parent));
+                REQUIRE(distances == plainDistances);
+                QueryResult result = BellmanFord::query(compressed, start, end, compressedWorkspace);
+                REQUIRE(result.distance == BellmanFord::query(graph, start, end, plainWorkspace).distance);
+            } else {
+                QueryResult result = Dijkstra::query(compressed, start, end, compressedWorkspace);
+                QueryResult expected = Dijkstra::query(graph, start, end, plainWorkspace);
+                REQUIRE(result.status == expected.status);
+                REQUIRE(result.distance == expected.distance);
+            }
+        }
+    });
+
+    // weights wider than a byte, far neighbours (multi byte varints), vertex without edges
+    Graph wide(300);
+    wide.addEdge(299, 0, -70000);
+    wide.addEdge(0, 299, 70000);
+    wide.addEdge(0, 1, INT_MAX / 4);
+    wide.addEdge(150, 20, INT_MIN / 4);
+    CompressedGraph compressed(wide);
+    REQUIRE(compressed.getWeightBytes() == 4);
+    Graph back = compressed.decompress();
+    REQUIRE(back.edgeWeight(299, 0) == -70000);
+    REQUIRE(back.edgeWeight(0, 299) == 70000);
+    REQUIRE(back.edgeWeight(0, 1) == INT_MAX / 4);
+    REQUIRE(back.edgeWeight(150, 20) == INT_MIN / 4);
+    REQUIRE(compressed.neighbors(42).empty());
+}
+
+// --------------------- External memory ---------------------
+TEST_CASE("External - on-disk engines match the in-memory ones", "[external]") {
+    forEachGeneratedGraph({"er", "grid", "negative"}, 500, 3000, 8, [](Graph& graph) {
+        for (int partitionVertices : {1, 37, 4096}) {
+            REQUIRE(ExternalGraph::write(graph, "test_external.pccx", partitionVertices));
+            // cache smaller than one partition - only the last partition stays in memory
+            ExternalGraph external("test_external.pccx", 1);
+            REQUIRE(external.isOpen());
+            REQUIRE(external.getSize() == graph.getSize());
+            REQUIRE(external.getEdgeCount() == graph.getEdgeCount());
+            for (int start : {0, 13, graph.getSize() - 1}) {
+                vector<int> expected, expectedParent, distances, parent;
+                bool fits = BellmanFord::run(graph, start, expected, expectedParent);
+                REQUIRE(ExternalShortestPath::bellmanFord(external, start, distances, parent) == fits);
+                REQUIRE(distances == expected);
+                if (graph.hasNegativeEdges()) {
+                    REQUIRE_FALSE(ExternalShortestPath::dijkstra(external, start, distances, parent));
+                    continue;
+                }
+                for (int delta : {0, 1, 1000}) {
+                    REQUIRE(ExternalShortestPath::dijkstra(external, start, distances, parent, delta));
+                    REQUIRE(distances == expected);
+                    for (int v = 0; v < graph.getSize(); v++) // parent edges are on shortest paths
+                        if (parent[v] != -1) REQUIRE(distances[parent[v]] + graph.edgeWeight(parent[v], v) == distances[v]);
+                }
+            }
+            REQUIRE(external.ioStats().bytesRead >= external.dataBytes());
+        }
+    });
+
+    // reachable negative cycle, zero weight edges inside a bucket
+    Graph cycle(4);
+    cycle.addEdge(0, 1, 1);
+    cycle.addEdge(1, 2, -3);
+    cycle.addEdge(2, 1, 1);
+    cycle.addEdge(2, 3, 0);
+    REQUIRE(ExternalGraph::write(cycle, "test_external.pccx", 2));
+    ExternalGraph external("test_external.pccx");
+    vector<int> distances, parent;
+    REQUIRE_FALSE(ExternalShortestPath::bellmanFord(external, 0, distances, parent));
+    REQUIRE(ExternalShortestPath::bellmanFord(external, 3, distances, parent));
+    REQUIRE(distances[3] == 0);
+    REQUIRE(distances[0] == INT_MAX);
+    // whole graph fits the default cache, the second search reads nothing
+    long long bytes = external.ioStats().bytesRead;
+    ExternalShortestPath::bellmanFord(external, 3, distances, parent);
+    REQUIRE(external.ioStats().bytesRead == bytes);
+
+    // 4 * max weight does not fit an int, the default bucket width is clamped
+    Graph heavy(3);
+    heavy.addEdge(0, 1, 1000000000);
+    heavy.addEdge(0, 2, 3);
+    REQUIRE(ExternalGraph::write(heavy, "test_external.pccx", 2));
+    ExternalGraph heavyExternal("test_external.pccx");
+    REQUIRE(ExternalShortestPath::dijkstra(heavyExternal, 0, distances, parent));
+    REQUIRE(distances == vector<int>{0, 1000000000, 3});
+
+    {
+        ofstream out("test_external.pccx");
+        out << "0 1 5\n";
+    }
+    REQUIRE_FALSE(ExternalGraph("test_external.pccx").isOpen());
+
+    // valid header and index, but the last edge of the file points past the last vertex
+    Graph chain(6);
+    for (int v = 0; v < 5; v++) chain.addEdge(v, v + 1, 1);
+    chain.addEdge(5, 0, 1);
+    REQUIRE(ExternalGraph::write(chain, "test_external.pccx", 2));
+    {
+        fstream file("test_external.pccx", ios::in | ios::out | ios::binary);
+        file.seekp(-(streamoff)sizeof(Edge), ios::end);
+        int to = 1000000;
+        file.write(reinterpret_cast<const char*>(&to), sizeof(to));
+    }
+    for (const char* engine : {"dijkstra", "bellman"}) {
+        ExternalGraph corrupt("test_external.pccx");
+        REQUIRE(corrupt.isOpen());
+        if (string(engine) == "dijkstra") REQUIRE_FALSE(ExternalShortestPath::dijkstra(corrupt, 0, distances, parent));
+        else REQUIRE_FALSE(ExternalShortestPath::bellmanFord(corrupt, 0, distances, parent));
+        REQUIRE_FALSE(corrupt.isOpen());
+        REQUIRE(distances[3] == 3); // partitions before the broken one were fine
+    }
+    ExternalGraph corrupt("test_external.pccx");
+    REQUIRE(ExternalShortestPath::shortestPath(corrupt, 0, 3, "dijkstra").first == "Invalid external graph file");
+    remove("test_external.pccx");
+}
+
+// --------------------- Memory placement ---------------------
+TEST_CASE("Placement - placed graphs and replicas answer like the original", "[placement]") {
+    GeneratorOptions options;
+    options.vertices = 2000;
+    options.edges = 20000;
+    options.seed = 9;
+    Graph graph = GraphGenerator::generateGraph(options);
+    SearchWorkspace workspace;
+
+    PlacementOptions placement;
+    placement.hugePages = true;
+    placement.numa = "interleave";
+    Graph placed = graph.placed(placement);
+    REQUIRE(placed.isPlaced());
+    REQUIRE_FALSE(graph.isPlaced());
+    REQUIRE(placed.getEdgeCount() == graph.getEdgeCount());
+    REQUIRE(placed.getMaxWeight() == graph.getMaxWeight());
+    for (int start : {0, 7, 1999}) {
+        REQUIRE(Dijkstra::query(placed, start, 1000, workspace).distance ==
+                Dijkstra::query(graph, start, 1000, workspace).distance);
+    }
+    // huge pages round the block up to 2 MB, all touched pages are on some node
+    PlacementReport report = placed.placementReport();
+    REQUIRE(report.bytes >= (2 << 20));
+    long long resident = 0;
+    for (long long bytes : report.bytesPerNode) resident += bytes;
+    REQUIRE(resident <= report.bytes);
+    // a copy of a placed graph is a normal graph again
+    REQUIRE_FALSE(Graph(placed).isPlaced());
+
+    // replicas are published again with every version
+    placement.numa = "replicate";
+    GraphStore store(graph, placement);
+    REQUIRE(store.snapshot()->graph.isPlaced());
+    REQUIRE((int)store.snapshot()->replicas.size() == Numa::nodeCount() - 1);
+    store.applyWeightUpdates({{0, graph.getNeighbors(0)[0].first, 1}});
+    for (int node = 0; node < Numa::nodeCount(); node++) {
+        const Graph& local = store.snapshot()->local(node);
+        REQUIRE(local.isPlaced());
+        REQUIRE(local.edgeWeight(0, graph.getNeighbors(0)[0].first) == 1);
+    }
+    REQUIRE(&store.snapshot()->local(-1) == &store.snapshot()->graph);
+}
+
+TEST_CASE("Placement - server with pinned workers and huge page buffers", "[placement]") {
+    Graph graph(4);
+    graph.addEdge(0, 1, 2);
+    graph.addEdge(1, 2, 3);
+    graph.addEdge(0, 2, 10);
+    ServerOptions options;
+    options.threads = 3;
+    options.placement.hugePages = true;
+    options.placement.numa = "replicate";
+    options.placement.pinThreads = true;
+    QueryServer server(move(graph), options);
+    istringstream in("0 2\n2 0\n");
+    ostringstream out;
+    server.serveStream(in, out);
+    REQUIRE(out.str().find("OK 0 2 5") != string::npos);
+    REQUIRE(out.str().find("UNREACHABLE 2 0") != string::npos);
+    REQUIRE(server.placementReport().bytes > 0);
+
+    int cpu = Numa::workerCpu(5);
+    bool known = false;
+    for (int node = 0; node < Numa::nodeCount(); node++)
+        for (int c : Numa::cpusOfNode(node)) known = known || c == cpu;
+    REQUIRE(known);
+}
+
+// --------------------- Hub labels ---------------------
+TEST_CASE("Hub labels - distances match Dijkstra", "[hub]") {
+    forEachGeneratedGraph({"er", "grid", "dag"}, 300, 1200, 5, [](Graph& graph) {
+        graph.addEdge(0, 1, 0); // zero weights are allowed
+        HubLabels labels;
+        REQUIRE(labels.build(graph));
+        REQUIRE(labels.getSize() == graph.getSize());
+        REQUIRE(labels.averageLabelSize() >= 1);
+
+        REQUIRE(labels.save("test_labels.pcch"));
+        HubLabels loaded;
+        REQUIRE(loaded.load("test_labels.pcch"));
+        REQUIRE(loaded.getLabelEntries() == labels.getLabelEntries());
+
+        vector<int> distances, parent;
+        for (int start = 0; start < graph.getSize(); start += 7) {
+            Dijkstra::run(graph, start, distances, parent);
+            for (int end = 0; end < graph.getSize(); end++) {
+                REQUIRE(labels.distance(start, end) == distances[end]);
+                REQUIRE(loaded.distance(start, end) == distances[end]);
+            }
+        }
+    });
+    remove("test_labels.pcch");
+}
+
+TEST_CASE("Hub labels - edge cases", "[hub]") {
+    Graph graph(3);
+    graph.addEdge(0, 1, 4);
+    HubLabels labels;
+    REQUIRE(labels.build(graph));
+    REQUIRE(labels.distance(0, 1) == 4);
+    REQUIRE(labels.distance(1, 0) == INT_MAX);
+    REQUIRE(labels.distance(2, 2) == 0);
+    REQUIRE(labels.distance(-1, 2) == INT_MAX);
+    REQUIRE(labels.distance(0, 3) == INT_MAX);
+
+    graph.addEdge(1, 2, -1);
+    REQUIRE_FALSE(labels.build(graph));
+    REQUIRE(labels.getSize() == 0);
+    REQUIRE_FALSE(labels.load("missing_labels.pcch"));
+}
+
+// --------------------- Arc flags ---------------------
+TEST_CASE("Arc flags - pruned queries give exact distances", "[arcflags]") {
+    forEachGeneratedGraph({"er", "grid", "dag"}, 400, 1600, 12, [](Graph& graph) {
+        graph.addEdge(3, 4, 0);
+        for (int cells : {1, 7, 64}) {
+            ArcFlags flags;
+            REQUIRE(flags.build(graph, cells, 2));
+            REQUIRE(flags.matches(graph));
+            REQUIRE(flags.getCellCount() == cells);
+            SearchWorkspace workspace;
+            SearchStats plainStats, flagStats;
+            for (int start = 0; start < graph.getSize(); start += 37) {
+                for (int end = 0; end < graph.getSize(); end += 11) {
+                    QueryResult plain = Dijkstra::query(graph, start, end, workspace, &plainStats);
+                    QueryResult pruned = Dijkstra::query(graph, flags, start, end, workspace, &flagStats);
+                    REQUIRE(pruned.status == plain.status);
+                    REQUIRE(pruned.distance == plain.distance);
+                    if (pruned.status == "OK") {
+                        REQUIRE(pruned.path.front() == start);
+                        REQUIRE(pruned.path.back() == end);
+                    }
+                }
+            }
+            REQUIRE(flagStats.edgesRelaxed <= plainStats.edgesRelaxed);
+        }
+    });
+}
+
+TEST_CASE("Arc flags - negative edges and stale flags", "[arcflags]") {
+    Graph graph(3);
+    graph.addEdge(0, 1, 2);
+    graph.addEdge(1, 2, 2);
+    ArcFlags flags;
+    REQUIRE(flags.build(graph, 2));
+    SearchWorkspace workspace;
+    REQUIRE(Dijkstra::query(graph, flags, 0, 2, workspace).distance == 4);
+
+    // flags of another graph are not used
+    graph.addEdge(0, 2, 1);
+    REQUIRE_FALSE(flags.matches(graph));
+    REQUIRE(Dijkstra::query(graph, flags, 0, 2, workspace).distance == 1);
+
+    graph.addEdge(2, 0, -1);
+    REQUIRE_FALSE(flags.build(graph));
+    REQUIRE_FALSE(flags.matches(graph));
+}
+
+TEST_CASE("Arc flags - changed weights make the flags stale", "[arcflags]") {
+    Graph graph(4);
+    graph.addEdge(0, 1, 1);
+    graph.addEdge(1, 3, 9);
+    graph.addEdge(0, 2, 10); // not on a shortest path into the cell of 3
+    graph.addEdge(2, 3, 10);
+    ArcFlags flags;
+    REQUIRE(flags.build(graph, 4));
+    SearchWorkspace workspace;
+    REQUIRE(Dijkstra::query(graph, flags, 0, 3, workspace).distance == 10);
+    REQUIRE(flags.matches(Graph(graph))); // a copy is the same graph
+
+    // same counts, but the pruned search would miss 0 -> 2 -> 3
+    REQUIRE(graph.setEdgeWeight(1, 3, 100));
+    REQUIRE_FALSE(flags.matches(graph));
+    REQUIRE(Dijkstra::query(graph, flags, 0, 3, workspace).distance == 20);
+
+    // removed and added again, counts and weights are back, the adjacency order is not
+    REQUIRE(flags.build(graph, 4));
+    REQUIRE(graph.removeEdge(0, 1));
+    graph.addEdge(0, 1, 1);
+    REQUIRE_FALSE(flags.matches(graph));
+    REQUIRE(Dijkstra::query(graph, flags, 0, 3, workspace).distance == 20);
+}
+
+// --------------------- Multi-level overlay ---------------------
+TEST_CASE("Multi-level overlay - distances match Dijkstra before and after re-customization", "[mld]") {
+    forEachGeneratedGraph({"er", "grid", "dag"}, 400, 1600, 13, [](Graph& graph) {
+        graph.addEdge(3, 4, 0);
+        MultiLevelOverlay overlay;
+        REQUIRE(overlay.partition(graph, {10, 40, 150}));
+        REQUIRE(overlay.getLevelCount() == 3);
+        REQUIRE(overlay.getCellCount(1) >= overlay.getCellCount(2));
+        REQUIRE(overlay.getCellCount(2) >= overlay.getCellCount(3));
+        REQUIRE(overlay.customize(graph, 2));
+
+        auto compare = [&]() {
+            SearchWorkspace workspace;
+            for (int start = 0; start < graph.getSize(); start += 37) {
+                for (int end = 0; end < graph.getSize(); end += 11) {
+                    QueryResult plain = Dijkstra::query(graph, start, end, workspace);
+                    int distance = overlay.distance(graph, start, end, workspace);
+                    REQUIRE(distance == (plain.status == "OK" ? plain.distance : INT_MAX));
+                }
+            }
+        };
+        compare();
+
+        // new metric, only the cells of the changed edges are customized again
+        vector<pair<int,int>> changed;
+        for (int u = 0; u < graph.getSize(); u += 17) {
+            if (graph.neighbors(u).empty()) continue;
+            int to = graph.neighbors(u)[0].to;
+            REQUIRE(graph.setEdgeWeight(u, to, (u * 7) % 50));
+            changed.push_back({u, to});
+        }
+        CustomizationStats stats;
+        REQUIRE(overlay.customize(graph, 2, &changed, &stats));
+        REQUIRE(stats.levelSeconds.size() == 3);
+        compare();
+    });
+}
+
+TEST_CASE("Multi-level overlay - invalid input", "[mld]") {
+    Graph graph(4);
+    graph.addEdge(0, 1, 2);
+    graph.addEdge(1, 2, 2);
+    MultiLevelOverlay overlay;
+    REQUIRE_FALSE(overlay.partition(graph, {2, 2}));
+    REQUIRE(overlay.partition(graph, MultiLevelOverlay::defaultCellSizes(graph.getSize())));
+    SearchWorkspace workspace;
+    REQUIRE(overlay.distance(graph, 0, 2, workspace) == INT_MAX); // not customized yet
+    REQUIRE(overlay.customize(graph));
+    REQUIRE(overlay.distance(graph, 0, 2, workspace) == 4);
+    REQUIRE(overlay.distance(graph, 0, 3, workspace) == INT_MAX);
+
+    // another topology or a negative edge
+    graph.addEdge(2, 3, 1);
+    REQUIRE_FALSE(overlay.customize(graph));
+    REQUIRE(overlay.partition(graph, {2}));
+    // new weights are fine, an edge removed and added again is another topology with the same counts
+    REQUIRE(graph.setEdgeWeight(2, 3, 5));
+    REQUIRE(overlay.customize(graph));
+    REQUIRE(graph.removeEdge(0, 1));
+    graph.addEdge(0, 1, 2);
+    REQUIRE_FALSE(overlay.customize(graph));
+    REQUIRE(overlay.partition(graph, {2}));
+    graph.setEdgeWeight(2, 3, -1);
+    REQUIRE_FALSE(overlay.customize(graph));
+}
+
+// --------------------- Isochrones ---------------------
+TEST_CASE("Isochrone - single and batched range queries match Dijkstra", "[isochrone]") {
+    forEachGeneratedGraph({"er", "grid"}, 300, 1200, 14, [](Graph& graph) {
+        graph.addEdge(5, 6, 0);
+
+        // 19 sources = two full groups of 8 lanes and one partial, repeated source in one group
+        vector<int> sources, budgets;
+        for (int i = 0; i < 19; i++) {
+            sources.push_back(i == 3 ? sources[0] : (i * 13) % graph.getSize());
+            budgets.push_back(i == 5 ? 0 : 20 + i * 15);
+        }
+        SearchStats batchStats;
+        vector<IsochroneResult> batched = Isochrone::batch(graph, sources, budgets, 2, &batchStats);
+        REQUIRE(batched.size() == sources.size());
+
+        SearchWorkspace workspace;
+        IsochroneResult single;
+        for (size_t i = 0; i < sources.size(); i++) {
+            REQUIRE(Dijkstra::query(graph, sources[i], -1, workspace).status == "OK");
+            vector<int> expected, expectedDistances;
+            vector<pair<int,int>> reached;
+            for (int v = 0; v < graph.getSize(); v++) {
+                if (workspace.distance(v) <= budgets[i]) reached.push_back({workspace.distance(v), v});
+            }
+            sort(reached.begin(), reached.end());
+            for (const auto& [distance, v] : reached) {
+                expected.push_back(v);
+                expectedDistances.push_back(distance);
+            }
+
+            Isochrone::query(graph, sources[i], budgets[i], workspace, single);
+            REQUIRE(single.status == "OK");
+            REQUIRE(single.vertices == expected);
+            REQUIRE(single.distances == expectedDistances);
+            // batches list the same vertices in vertex order
+            vector<pair<int,int>> byVertex;
+            for (const auto& [distance, v] : reached) byVertex.push_back({v, distance});
+            sort(byVertex.begin(), byVertex.end());
+            REQUIRE(batched[i].status == "OK");
+            REQUIRE(batched[i].vertices.size() == byVertex.size());
+            for (size_t k = 0; k < byVertex.size(); k++) {
+                REQUIRE(batched[i].vertices[k] == byVertex[k].first);
+                REQUIRE(batched[i].distances[k] == byVertex[k].second);
+            }
+        }
+        REQUIRE(batchStats.verticesSettled > 0);
+    });
+}
+
+TEST_CASE("Isochrone - invalid input", "[isochrone]") {
+    Graph graph(3);
+    graph.addEdge(0, 1, 5);
+    graph.addEdge(1, 2, INT_MAX - 1);
+    SearchWorkspace workspace;
+    IsochroneResult result;
+    Isochrone::query(graph, 0, INT_MAX, workspace, result); // no overflow past INT_MAX
+    REQUIRE(result.vertices == vector<int>{0, 1});
+    Isochrone::query(graph, 3, 10, workspace, result);
+    REQUIRE(result.status == "Invalid vertex");
+    Isochrone::query(graph, 0, -1, workspace, result);
+    REQUIRE(result.status == "Invalid budget");
+    REQUIRE(result.vertices.empty());
+
+    vector<IsochroneResult> batched = Isochrone::batch(graph, {0, 7, 1}, {INT_MAX, 1, -5});
+    REQUIRE(batched[0].vertices == vector<int>{0, 1});
+    REQUIRE(batched[1].status == "Invalid vertex");
+    REQUIRE(batched[2].status == "Invalid budget");
+
+    graph.addEdge(2, 0, -1);
+    Isochrone::query(graph, 0, 10, workspace, result);
+    REQUIRE(result.status == "Negative edge weight");
+    REQUIRE(Isochrone::batch(graph, {0}, {10})[0].status == "Negative edge weight");
+}
+
+// --------------------- Points of interest ---------------------
+TEST_CASE("Points of interest - early stop and buckets give the k nearest", "[poi]") {
+    forEachGeneratedGraph({"er", "grid"}, 300, 1200, 15, [](Graph& graph) {
+        // category 0 on every 23rd vertex, category 1 on every 40th
+        for (int v = 0; v < graph.getSize(); v += 23) graph.setCategories(v, 1);
+        for (int v = 0; v < graph.getSize(); v += 40) graph.setCategories(v, graph.getCategories(v) | 2);
+        REQUIRE(graph.reversed().getCategories(23) == 1);
+        REQUIRE(Graph(graph).getCategories(0) == 3);
+
+        const int K = 5;
+        PoiBuckets buckets;
+        REQUIRE(buckets.build(graph, 2, K));
+        SearchWorkspace workspace;
+        NearestResult early, bucketed;
+        for (int source = 0; source < graph.getSize(); source += 7) {
+            REQUIRE(Dijkstra::query(graph, source, -1, workspace).status == "OK");
+            for (uint64_t mask : {1ULL, 2ULL, 3ULL}) {
+                vector<pair<int,int>> tagged;
+                for (int v = 0; v < graph.getSize(); v++) {
+                    if ((graph.getCategories(v) & mask) && workspace.distance(v) != INT_MAX)
+                        tagged.push_back({workspace.distance(v), v});
+                }
+                sort(tagged.begin(), tagged.end());
+                tagged.resize(min<size_t>(K, tagged.size()));
+                vector<int> expected;
+                for (const auto& [distance, v] : tagged) expected.push_back(distance);
+
+                SearchStats stats;
+                SearchWorkspace own;
+                PointsOfInterest::nearest(graph, source, mask, K, own, early, &stats);
+                REQUIRE(early.status == "OK");
+                REQUIRE(early.distances == expected);
+                for (size_t i = 0; i < tagged.size(); i++) REQUIRE(early.vertices[i] == tagged[i].second);
+                REQUIRE(stats.verticesSettled <= graph.getSize());
+                if (mask == 2) {
+                    buckets.nearest(source, K, bucketed);
+                    REQUIRE(bucketed.distances == expected);
+                    for (size_t i = 0; i < tagged.size(); i++)
+                        REQUIRE(graph.getCategories(bucketed.vertices[i]) & 2);
+                }
+            }
+        }
+    });
+}
+
+TEST_CASE("Points of interest - invalid input and no facilities", "[poi]") {
+    Graph graph(4);
+    graph.addEdge(0, 1, 3);
+    graph.addEdge(1, 2, 3);
+    SearchWorkspace workspace;
+    NearestResult result;
+    PointsOfInterest::nearest(graph, 0, 1, 2, workspace, result);
+    REQUIRE(result.status == "OK");
+    REQUIRE(result.vertices.empty()); // no categories at all
+
+    graph.setCategories(2, 1);
+    graph.setCategories(3, 1);
+    PointsOfInterest::nearest(graph, 0, 1, 2, workspace, result);
+    REQUIRE(result.vertices == vector<int>{2}); // 3 is not reachable
+    REQUIRE(result.distances == vector<int>{6});
+    PointsOfInterest::nearest(graph, 4, 1, 2, workspace, result);
+    REQUIRE(result.status == "Invalid vertex");
+    PointsOfInterest::nearest(graph, 0, 1, 0, workspace, result);
+    REQUIRE(result.status == "Invalid k");
+
+    PoiBuckets buckets;
+    REQUIRE_FALSE(buckets.build(graph, 1, 0));
+    REQUIRE(buckets.build(graph, 1, 2));
+    buckets.nearest(0, 2, result);
+    REQUIRE(result.vertices == vector<int>{2});
+    buckets.nearest(3, 1, result);
+    REQUIRE(result.vertices == vector<int>{3});
+    buckets.nearest(0, 3, result);
+    REQUIRE(result.status == "Invalid k");
+
+    graph.addEdge(2, 3, -1);
+    PointsOfInterest::nearest(graph, 0, 1, 2, workspace, result);
+    REQUIRE(result.status == "Negative edge weight");
+    REQUIRE_FALSE(buckets.build(graph, 1, 2));
+}
+
+// --------------------- Reachability index ---------------------
+TEST_CASE("Reachability index - answers match a search", "[reachability]") {
+    // sparse, many small components
+    forEachGeneratedGraph({"er", "dag", "negative"}, 300, 450, 16, [](Graph& graph) {
+        ReachabilityIndex index;
+        index.build(graph);
+        REQUIRE(index.matches(graph));
+        REQUIRE(index.hasClosure());
+        SearchWorkspace workspace;
+        for (int start = 0; start < graph.getSize(); start += 7) {
+            // BFS of everything reachable from start
+            vector<char> seen(graph.getSize(), 0);
+            vector<int> queue = {start};
+            seen[start] = 1;
+            for (size_t head = 0; head < queue.size(); head++) {
+                for (const Edge& edge : graph.neighbors(queue[head])) {
+                    if (!seen[edge.to]) {
+                        seen[edge.to] = 1;
+                        queue.push_back(edge.to);
+                    }
+                }
+            }
+            for (int end = 0; end < graph.getSize(); end++) REQUIRE(index.reachable(start, end) == (bool)seen[end]);
+
+            // components of the list in topological order: no edge goes back to an earlier component
+            vector<int> reached = index.reachableFrom(start);
+            REQUIRE(reached.size() == queue.size());
+            for (size_t i = 1; i < reached.size(); i++)
+                REQUIRE(index.componentOf(reached[i - 1]) >= index.componentOf(reached[i]));
+
+            for (int end = 0; end < graph.getSize(); end += 13) {
+                QueryResult plain = BellmanFord::query(graph, start, end, workspace);
+                QueryResult restricted = BellmanFord::query(graph, index, start, end, workspace);
+                REQUIRE(restricted.status == (plain.status != "OK" && !seen[end] ? "Unreachable" : plain.status));
+                REQUIRE(restricted.distance == (restricted.status == "OK" ? plain.distance : -1));
+            }
+        }
+    });
+}
+
+TEST_CASE("Reachability index - deep graphs and condensations without closure", "[reachability]") {
+    // a chain deeper than any call stack: one component per vertex, too many for the closure
+    const int N = 200000;
+    Graph chain(N);
+    for (int v = 0; v + 1 < N; v++) chain.addEdge(v, v + 1, 1);
+    ReachabilityIndex index;
+    index.build(chain);
+    REQUIRE(index.getComponentCount() == N);
+    REQUIRE(index.getDagEdges() == N - 1);
+    REQUIRE_FALSE(index.hasClosure());
+    REQUIRE(index.reachable(0, N - 1));
+    REQUIRE(index.reachable(5, 5));
+    REQUIRE_FALSE(index.reachable(N - 1, 0));
+    REQUIRE_FALSE(index.reachable(0, N));
+    REQUIRE(index.reachableFrom(N - 3) == vector<int>{N - 3, N - 2, N - 1});
+
+    // closing the chain makes one component
+    chain.addEdge(N - 1, 0, 1);
+    REQUIRE_FALSE(index.matches(chain));
+    index.build(chain);
+    REQUIRE(index.getComponentCount() == 1);
+    REQUIRE(index.reachable(N - 1, 0));
+    // a new weight keeps the index, an edge moved elsewhere (same counts) does not
+    REQUIRE(chain.setEdgeWeight(N - 1, 0, 7));
+    REQUIRE(index.matches(chain));
+    REQUIRE(chain.removeEdge(N - 1, 0));
+    chain.addEdge(N - 2, 0, 1);
+    REQUIRE_FALSE(index.matches(chain));
+
+    // branches that never meet, the DAG search has to reject them
+    Graph tree(2 * N + 1);
+    for (int v = 0; v < N; v++) {
+        tree.addEdge(v == 0 ? 2 * N : v - 1, v, 1);
+        tree.addEdge(v == 0 ? 2 * N : N + v - 1, N + v, 1);
+    }
+    index.build(tree);
+    REQUIRE(index.reachable(2 * N, N - 1));
+    REQUIRE(index.reachable(2 * N, 2 * N - 1));
+    REQUIRE_FALSE(index.reachable(10, N + 20));
+    REQUIRE_FALSE(index.reachable(N + 10, 20));
+
+    // unreachable end is answered without a pass, a negative cycle elsewhere does not matter
+    Graph graph(4);
+    graph.addEdge(0, 1, 2);
+    graph.addEdge(2, 3, -1);
+    graph.addEdge(3, 2, -1);
+    index.build(graph);
+    SearchWorkspace workspace;
+    SearchStats stats;
+    REQUIRE(BellmanFord::query(graph, index, 0, 3, workspace, &stats).status == "Unreachable");
+    REQUIRE(stats.edgesRelaxed == 0);
+    REQUIRE(BellmanFord::query(graph, index, 0, 1, workspace).distance == 2);
+    REQUIRE(BellmanFord::query(graph, index, 2, 3, workspace).status == "Negative weight cycle detected");
+}
+
+// --------------------- Performance counters ---------------------
+TEST_CASE("Stats - algorithm counters of Dijkstra and Bellman-Ford", "[stats]") {
+    Graph g(4);
+    g.addEdge(0, 1, 1);
+    g.addEdge(1, 2, 2);
+    g.addEdge(0, 2, 5);
+    // vertex 3 is unreachable
+
+    SearchStats dijkstraStats;
+    vector<int> distances, parent;
+    REQUIRE(Dijkstra::run(g, 0, distances, parent, &dijkstraStats));
+    REQUIRE(distances[2] == 3);
+    REQUIRE(dijkstraStats.verticesSettled == 3);
+    REQUIRE(dijkstraStats.edgesRelaxed == 3);
+    REQUIRE(dijkstraStats.heapPops == 3);
+
+    SearchStats bfStats;
+    REQUIRE(BellmanFord::run(g, 0, distances, parent, &bfStats));
+    REQUIRE(distances[2] == 3);
+    REQUIRE(bfStats.edgesRelaxed == 3 * 3); // V-1 passes over 3 edges
+    REQUIRE(bfStats.successfulRelaxations == 3);
+
+    // hardware counters are optional, unavailable values are reported as -1
+    PerfCounters perf;
+    perf.start();
+    HardwareCounters counters = perf.stop();
+    if (!perf.isAvailable()) REQUIRE(counters.cycles == -1);
+}
+
+// --------------------- Query server ---------------------
+TEST_CASE("Server - line protocol answers queries", "[server]") {
+    Graph g(4);
+    g.addEdge(0, 1, 4);
+    g.addEdge(1, 2, -1);
+    g.addEdge(0, 2, 5);
+
+    ServerOptions options;
+    options.threads = 2;
+    QueryServer server(g, options);
+
+    istringstream input("0 2 bellman\n0 3\n0 9\nhello\nquit\n0 1\n");
+    ostringstream output;
+    server.serveStream(input, output);
+
+    // answers from workers may come in any order
+    istringstream lines(output.str());
+    string line;
+    vector<string> responses;
+    while (getline(lines, line)) responses.push_back(line);
+    sort(responses.begin(), responses.end());
+
+    REQUIRE(responses.size() == 5); // nothing after quit
+    REQUIRE(responses[0] == "BYE");
+    REQUIRE(responses[1].rfind("ERROR expected", 0) == 0);
+    REQUIRE(responses[2].rfind("ERROR vertices", 0) == 0);
+    REQUIRE(responses[3].rfind("NEGATIVE_EDGE 0 3 ", 0) == 0); // default algorithm is Dijkstra
+    REQUIRE(responses[4].rfind("OK 0 2 3 ", 0) == 0);
+    REQUIRE(server.statsLine().rfind("STATS answered=2 rejected=0", 0) == 0);
+}
+
+TEST_CASE("Server - range queries", "[server]") {
+    Graph g(4);
+    g.addEdge(0, 1, 4);
+    g.addEdge(1, 2, 3);
+    g.addEdge(0, 3, 9);
+    ServerOptions options;
+    options.threads = 1;
+    QueryServer server(g, options);
+
+    istringstream input("range 0 7\nrange 0 -1\nrange 4 1\n");
+    ostringstream output;
+    server.serveStream(input, output);
+    istringstream lines(output.str());
+    string line;
+    vector<string> responses;
+    while (getline(lines, line)) responses.push_back(line);
+    sort(responses.begin(), responses.end());
+    REQUIRE(responses.size() == 3);
+    REQUIRE(responses[0].rfind("ERROR expected: range", 0) == 0);
+    REQUIRE(responses[1].rfind("ERROR vertices", 0) == 0);
+    REQUIRE(responses[2].rfind("RANGE 0 7 3 ", 0) == 0);
+    REQUIRE(responses[2].substr(responses[2].size() - 11) == "0:0 1:4 2:7");
+}
+
+TEST_CASE("Server - unreachable pairs need no search", "[server]") {
+    Graph g(3);
+    g.addEdge(0, 1, 4);
+    g.addEdge(2, 1, 1);
+    ServerOptions options;
+    options.threads = 1;
+    QueryServer server(g, options);
+    istringstream input("0 2\n0 2 bellman\n2 1\n");
+    ostringstream output;
+    server.serveStream(input, output);
+    istringstream lines(output.str());
+    string line;
+    vector<string> responses;
+    while (getline(lines, line)) responses.push_back(line);
+    sort(responses.begin(), responses.end());
+    REQUIRE(responses.size() == 3);
+    REQUIRE(responses[0].rfind("OK 2 1 1 ", 0) == 0);
+    REQUIRE(responses[1].rfind("UNREACHABLE 0 2 ", 0) == 0);
+    REQUIRE(responses[2].rfind("UNREACHABLE 0 2 ", 0) == 0);
+}
+
+TEST_CASE("Server - weight updates publish new graph versions", "[server-update]") {
+    Graph g(3);
+    g.addEdge(0, 1, 4);
+    g.addEdge(1, 2, 4);
+    ServerOptions options;
+    options.threads = 1;
+    QueryServer server(g, options);
+
+    // updates and errors are answered before the next line is read, only the query goes to the pool,
+    // serveStream waits for it
+    istringstream input("update 0 1 1 1 2 2 2 0 7\nupdate 0 1\n0 2\n"); // last edge does not exist
+    ostringstream output;
+    server.serveStream(input, output);
+    istringstream lines(output.str());
+    string line;
+    vector<string> responses;
+    while (getline(lines, line)) responses.push_back(line);
+    REQUIRE(responses.size() == 3);
+    REQUIRE(responses[0] == "UPDATED applied=2 version=2");
+    REQUIRE(responses[1].rfind("ERROR expected: update", 0) == 0);
+    REQUIRE(responses[2].rfind("OK 0 2 3 ", 0) == 0);
+    REQUIRE(server.statsLine().find("version=2") != string::npos);
+}
+
+TEST_CASE("Graph store - readers never see a half applied update", "[graph-store]") {
+    Graph g(3);
+    g.addEdge(0, 1, 0);
+    g.addEdge(1, 2, 0);
+    GraphStore store(g);
+    shared_ptr<const GraphVersion> pinned = store.snapshot();
+
+    atomic<bool> done(false);
+    atomic<int> torn(0);
+    vector<thread> readers;
+    for (int t = 0; t < 3; t++) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                auto snapshot = store.snapshot();
+                // both edges change in the same batch
+                if (snapshot->graph.edgeWeight(0, 1) != snapshot->graph.edgeWeight(1, 2)) torn++;
+                if (snapshot->graph.edgeWeight(0, 1) != (int)snapshot->version - 1) torn++;
+            }
+        });
+    }
+    for (int w = 1; w <= 200; w++) {
+        REQUIRE(store.applyWeightUpdates({{0, 1, w}, {1, 2, w}}) == 2);
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    REQUIRE(torn == 0);
+    REQUIRE(store.snapshot()->version == 201);
+    // an old pinned version stays unchanged
+    REQUIRE(pinned->version == 1);
+    REQUIRE(pinned->graph.edgeWeight(0, 1) == 0);
+}
+
+// --------------------- Concurrent queries ---------------------
+TEST_CASE("Concurrent - workspace queries match single threaded engines", "[concurrent]") {
+    GeneratorOptions options;
+    options.type = "grid";
+    options.rows = 20;
+    options.cols = 20;
+    const Graph g = GraphGenerator::generateGraph(options);
+
+    // reference distances from the classic engine
+    const int sources[] = {0, 57, 123, 399};
+    vector<vector<int>> expected;
+    for (int s : sources) {
+        vector<int> distances, parent;
+        REQUIRE(Dijkstra::run(g, s, distances, parent));
+        expected.push_back(distances);
+    }
+
+    // every thread has its own workspace and reuses it for all queries
+    const int THREADS = 4;
+    vector<int> mismatches(THREADS, 0);
+    vector<thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            SearchWorkspace workspace;
+            for (int i = 0; i < 4; i++) {
+                for (int target = t; target < g.getSize(); target += THREADS) {
+                    QueryResult result = Dijkstra::query(g, sources[i], target, workspace);
+                    QueryResult bf = BellmanFord::query(g, sources[i], target, workspace);
+                    if (result.distance != expected[i][target] || bf.distance != expected[i][target]) mismatches[t]++;
+                    if (!verifyPath(g, result.path, result.distance)) mismatches[t]++;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int m : mismatches) REQUIRE(m == 0);
+}
+
+TEST_CASE("Concurrent - query statuses", "[concurrent-status]") {
+    Graph g(3);
+    g.addEdge(0, 1, 2);
+    g.addEdge(1, 0, -3); // negative cycle 0 -> 1 -> 0
+    SearchWorkspace workspace;
+
+    REQUIRE(Dijkstra::query(g, 0, 1, workspace).status == "Negative edge weight");
+    REQUIRE(BellmanFord::query(g, 0, 1, workspace).status == "Negative weight cycle detected");
+
+    Graph h(3);
+    h.addEdge(0, 1, 2);
+    QueryResult result = Dijkstra::query(h, 0, 2, workspace);
+    REQUIRE(result.status == "Unreachable");
+    REQUIRE(result.distance == -1);
+    REQUIRE(BellmanFord::query(h, 0, 1, workspace).distance == 2);
+}
+
+// --------------------- Many-to-many ---------------------
+TEST_CASE("Distance table - matches point-to-point queries", "[distance-table]") {
+    GeneratorOptions options;
+    options.type = "er";
+    options.vertices = 150;
+    options.edges = 600;
+    options.seed = 3;
+    Graph g = GraphGenerator::generateGraph(options);
+
+    vector<int> few = {0, 17, 42};
+    vector<int> many = {1, 5, 17, 99, 120, 149, 5};
+    SearchWorkspace workspace;
+
+    // forward (3 x 7) and backward (7 x 3) variant
+    for (int round = 0; round < 2; round++) {
+        const vector<int>& sources = round == 0 ? few : many;
+        const vector<int>& targets = round == 0 ? many : few;
+        DistanceMatrix matrix;
+        REQUIRE(DistanceTable::compute(g, sources, targets, matrix, 3));
+        REQUIRE(matrix.rows == (int)sources.size());
+        REQUIRE(matrix.cols == (int)targets.size());
+        for (size_t i = 0; i < sources.size(); i++) {
+            for (size_t j = 0; j < targets.size(); j++) {
+                QueryResult result = Dijkstra::query(g, sources[i], targets[j], workspace);
+                int expected = result.status == "OK" ? result.distance : INT_MAX;
+                REQUIRE(matrix.at(i, j) == expected);
+            }
+        }
+    }
+
+    // negative edges go through Bellman-Ford, negative cycle fails
+    Graph negative(3);
+    negative.addEdge(0, 1, -1);
+    negative.addEdge(1, 2, 4);
+    DistanceMatrix matrix;
+    REQUIRE(DistanceTable::compute(negative, {0, 1}, {2}, matrix));
+    REQUIRE(matrix.at(0, 0) == 3);
+    REQUIRE(matrix.at(1, 0) == 4);
+    negative.addEdge(2, 0, -5);
+    REQUIRE_FALSE(DistanceTable::compute(negative, {0}, {1}, matrix));
+}
+
+// --------------------- Batched Bellman-Ford ---------------------
+TEST_CASE("Batched Bellman-Ford - same results as scalar engine", "[batched-bf]") {
+    GeneratorOptions options;
+    options.type = "negative";
+    options.vertices = 80;
+    options.edges = 300;
+    options.seed = 11;
+    Graph g = GraphGenerator::generateGraph(options);
+
+    // 11 sources = one full batch of 8 and one partial batch
+    vector<int> sources = {0, 3, 7, 15, 22, 31, 40, 41, 55, 68, 79};
+    for (int lanes : {8, 16}) {
+        vector<vector<int>> distances;
+        vector<string> statuses = BatchedBellmanFord::run(g, sources, distances, lanes);
+        for (size_t i = 0; i < sources.size(); i++) {
+            vector<int> expected, parent;
+            REQUIRE(BellmanFord::run(g, sources[i], expected, parent));
+            REQUIRE(statuses[i] == "OK");
+            REQUIRE(distances[i] == expected);
+        }
+    }
+
+    // cycle 1 -> 2 -> 1 is reachable only from some sources
+    Graph c(4);
+    c.addEdge(0, 1, 1);
+    c.addEdge(1, 2, -2);
+    c.addEdge(2, 1, 1);
+    c.addEdge(3, 0, 2);
+    vector<vector<int>> distances;
+    vector<string> statuses = BatchedBellmanFord::run(c, {0, 3, 2}, distances);
+    REQUIRE(statuses[0] == "Negative weight cycle detected");
+    REQUIRE(statuses[1] == "Negative weight cycle detected");
+    REQUIRE(statuses[2] == "Negative weight cycle detected");
+
+    Graph d(3);
+    d.addEdge(0, 1, 1);
+    d.addEdge(2, 2, -1); // negative self loop reachable only from 2
+    statuses = BatchedBellmanFord::run(d, {0, 2}, distances);
+    REQUIRE(statuses[0] == "OK");
+    REQUIRE(statuses[1] == "Negative weight cycle detected");
+    REQUIRE(distances[0][1] == 1);
+    REQUIRE(distances[0][2] == INT_MAX);
+}
+
+// --------------------- K shortest paths ---------------------
+// all simple paths start -> end by DFS, (distance, path) sorted
+static void allSimplePaths(const Graph& g, int u, int end, vector<int>& path, vector<char>& onPath, int distance,
+                           vector<pair<int, vector<int>>>& out) {
+    if (u == end) {
+        out.push_back({distance, path});
+        return;
+    }
+    for (int v = 0; v < g.getSize(); v++) {
+        if (onPath[v]) continue;
+        int best = INT_MAX; // parallel edges count once with the smallest weight
+        for (const Edge& e : g.getAdjList()[u]) if (e.to == v) best = min(best, e.weight);
+        if (best == INT_MAX) continue;
+        onPath[v] = 1;
+        path.push_back(v);
+        allSimplePaths(g, v, end, path, onPath, distance + best, out);
+        path.pop_back();
+        onPath[v] = 0;
+    }
+}
+
+TEST_CASE("K shortest paths - Yen matches enumeration of simple paths", "[yen]") {
+    GeneratorOptions options;
+    options.vertices = 9;
+    options.edges = 30;
+    options.minWeight = 1;
+    options.maxWeight = 5; // many ties
+    options.seed = 5;
+    Graph g = GraphGenerator::generateGraph(options);
+    g.addEdge(0, 1, 2); // parallel edge
+
+    SearchWorkspace workspace;
+    const Graph reverse = g.reversed(); // one reversed graph for all queries
+    for (int end = 1; end < g.getSize(); end++) {
+        vector<pair<int, vector<int>>> expected;
+        vector<int> path = {0};
+        vector<char> onPath(g.getSize(), 0);
+        onPath[0] = 1;
+        allSimplePaths(g, 0, end, path, onPath, 0, expected);
+        sort(expected.begin(), expected.end());
+
+        vector<QueryResult> paths = KShortestPaths::query(g, reverse, 0, end, 12, workspace);
+        if (expected.empty()) {
+            REQUIRE(paths.size() == 1);
+            REQUIRE(paths[0].status == "Unreachable");
+            continue;
+        }
+        REQUIRE(paths.size() == min<size_t>(12, expected.size()));
+        for (size_t i = 0; i < paths.size(); i++) {
+            REQUIRE(paths[i].status == "OK");
+            REQUIRE(paths[i].distance == expected[i].first); // ties may come in any order
+            int distance = 0;
+            for (size_t j = 0; j + 1 < paths[i].path.size(); j++) {
+                int best = INT_MAX;
+                for (const Edge& e : g.getAdjList()[paths[i].path[j]]) if (e.to == paths[i].path[j + 1]) best = min(best, e.weight);
+                REQUIRE(best != INT_MAX);
+                distance += best;
+            }
+            REQUIRE(distance == paths[i].distance);
+            vector<int> sorted = paths[i].path;
+            sort(sorted.begin(), sorted.end());
+            REQUIRE(adjacent_find(sorted.begin(), sorted.end()) == sorted.end()); // loopless
+        }
+    }
+
+    // masks are dropped after the query, plain query sees the whole graph again
+    QueryResult plain = Dijkstra::query(g, 0, g.getSize() - 1, workspace);
+    REQUIRE(KShortestPaths::query(g, 0, g.getSize() - 1, 1, workspace)[0].distance == plain.distance);
+    REQUIRE_FALSE(workspace.hasMask());
+}
+
+// --------------------- DAG shortest paths ---------------------
+TEST_CASE("DAG - topological order and same distances as Bellman-Ford", "[dag]") {
+    GeneratorOptions options;
+    options.type = "dag";
+    options.vertices = 300;
+    options.edges = 2000;
+    options.minWeight = -20;
+    options.maxWeight = 50;
+    options.seed = 8;
+    Graph g = GraphGenerator::generateGraph(options);
+
+    vector<int> order;
+    REQUIRE(DagShortestPath::topologicalOrder(g, order));
+    REQUIRE((int)order.size() == g.getSize());
+    vector<int> position(g.getSize());
+    for (int i = 0; i < (int)order.size(); i++) position[order[i]] = i;
+    for (int u = 0; u < g.getSize(); u++)
+        for (const Edge& e : g.getAdjList()[u]) REQUIRE(position[u] < position[e.to]);
+
+    for (int s : {0, 99, 250}) {
+        vector<int> expected, distances, parent;
+        REQUIRE(BellmanFord::run(g, s, expected, parent));
+        REQUIRE(DagShortestPath::run(g, s, order, distances, parent));
+        REQUIRE(distances == expected);
+    }
+
+    // one back edge makes a cycle
+    g.addEdge(order.back(), order.front(), 1);
+    REQUIRE_FALSE(DagShortestPath::topologicalOrder(g, order));
+    vector<int> distances, parent;
+    REQUIRE_FALSE(DagShortestPath::run(g, 0, order, distances, parent));
+    REQUIRE(DagShortestPath::shortestPath(g, 0, 1, order).first == "Graph has a cycle");
+}
+
+// --------------------- BFS engines ---------------------
+TEST_CASE("BFS - weight profile and engine choice", "[bfs-profile]") {
+    Graph g(3);
+    REQUIRE(g.hasUniformWeights());
+    g.addEdge(0, 1, 4);
+    g.addEdge(1, 2, 4);
+    REQUIRE(g.hasUniformWeights());
+    REQUIRE_FALSE(g.hasZeroOneWeights());
+    REQUIRE(BreadthFirstSearch::chooseEngine(g, false) == "bfs");
+    g.addEdge(2, 0, 1);
+    REQUIRE_FALSE(g.hasUniformWeights());
+    REQUIRE(g.getMinWeight() == 1);
+    REQUIRE(g.getMaxWeight() == 4);
+    REQUIRE(BreadthFirstSearch::chooseEngine(g, false) == "dijkstra");
+
+    Graph z(2);
+    z.addEdge(0, 1, 0);
+    z.addEdge(1, 0, 1);
+    REQUIRE(z.hasZeroOneWeights());
+    REQUIRE(BreadthFirstSearch::chooseEngine(z, false) == "bfs-01");
+    z.addEdge(1, 1, -1);
+    REQUIRE(BreadthFirstSearch::chooseEngine(z, false) == "bellman");
+
+    vector<int> distances, parent;
+    REQUIRE_FALSE(BreadthFirstSearch::run(z, 0, distances, parent));
+    REQUIRE_FALSE(BreadthFirstSearch::runZeroOne(z, 0, distances, parent));
+}
+
+TEST_CASE("BFS - engines match Dijkstra", "[bfs]") {
+    GeneratorOptions options;
+    options.vertices = 400;
+    options.edges = 4000;
+    options.minWeight = 3;
+    options.maxWeight = 3;
+    options.seed = 21;
+    Graph uniform = GraphGenerator::generateGraph(options);
+    Graph reverse = uniform.reversed();
+    options.minWeight = 0;
+    options.maxWeight = 1;
+    Graph zeroOne = GraphGenerator::generateGraph(options);
+
+    for (int s : {0, 123, 399}) {
+        vector<int> expected, distances, parent;
+        REQUIRE(Dijkstra::run(uniform, s, expected, parent));
+        REQUIRE(BreadthFirstSearch::run(uniform, s, distances, parent));
+        REQUIRE(distances == expected);
+        REQUIRE(BreadthFirstSearch::runDirectionOptimizing(uniform, reverse, s, distances, parent));
+        REQUIRE(distances == expected);
+        // parents form shortest path trees
+        for (int v = 0; v < uniform.getSize(); v++)
+            if (parent[v] != -1) REQUIRE(distances[v] == distances[parent[v]] + 3);
+
+        REQUIRE(Dijkstra::run(zeroOne, s, expected, parent));
+        REQUIRE(BreadthFirstSearch::runZeroOne(zeroOne, s, distances, parent));
+        REQUIRE(distances == expected);
+    }
+}
+
+// --------------------- Dynamic shortest paths ---------------------
+TEST_CASE("Graph - mutation API keeps the weight profile", "[graph-mutation]") {
+    Graph g(3);
+    g.addEdge(0, 1, 5);
+    g.addEdge(0, 1, 2); // parallel, cheaper
+    g.addEdge(1, 2, -1);
+    REQUIRE(g.edgeWeight(0, 1) == 2);
+    REQUIRE(g.hasNegativeEdges());
+    REQUIRE(g.setEdgeWeight(1, 2, 1));
+    REQUIRE_FALSE(g.hasNegativeEdges());
+    REQUIRE(g.getMinWeight() == 1);
+    REQUIRE(g.removeEdge(0, 1)); // removes the cheaper one
+    REQUIRE(g.edgeWeight(0, 1) == 5);
+    REQUIRE(g.getEdgeCount() == 2);
+    REQUIRE(g.getMinWeight() == 1);
+    REQUIRE(g.getMaxWeight() == 5);
+    REQUIRE_FALSE(g.removeEdge(2, 0));
+    REQUIRE_FALSE(g.setEdgeWeight(2, 0, 1));
+    REQUIRE(g.edgeWeight(2, 0) == INT_MAX);
+}
+
+TEST_CASE("Graph - removing the extreme weights keeps min and max exact", "[graph-mutation]") {
+    Graph g(50);
+    for (int v = 0; v < 49; v++) g.addEdge(v, v + 1, (v * 7) % 23 - 3);
+    // every removal takes the current min or max edge, the profile must match a full scan
+    for (int round = 0; round < 49; round++) {
+        int from = -1;
+        for (int v = 0; v < 49; v++) {
+            int weight = g.edgeWeight(v, v + 1);
+            if (weight == INT_MAX) continue;
+            if (weight == (round % 2 ? g.getMaxWeight() : g.getMinWeight())) from = v;
+        }
+        REQUIRE(from != -1);
+        REQUIRE(g.removeEdge(from, from + 1));
+        if (round == 10) g.addEdge(49, 0, 5); // additions after the histogram exists
+        if (round == 20) REQUIRE(g.removeEdge(49, 0));
+        int minWeight = INT_MAX, maxWeight = INT_MIN;
+        for (int v = 0; v < 50; v++) {
+            for (const Edge& edge : g.neighbors(v)) {
+                minWeight = min(minWeight, edge.weight);
+                maxWeight = max(maxWeight, edge.weight);
+            }
+        }
+        REQUIRE(g.getMinWeight() == minWeight);
+        REQUIRE(g.getMaxWeight() == maxWeight);
+    }
+    REQUIRE(g.getEdgeCount() == 0);
+}
+
+TEST_CASE("Graph - arena construction, copy and move", "[graph-arena]") {
+    Graph g(4, {2, 1, 0, 1});
+    g.addEdge(0, 1, 3);
+    g.addEdge(0, 2, -1);
+    g.addEdge(1, 2, 4);
+    g.addEdge(3, 0, 1);
+    const Edge* firstList = g.getAdjList()[0].data();
+    REQUIRE(g.degrees() == vector<int>{2, 1, 0, 1});
+    REQUIRE(g.getAdjList()[0].capacity() == 2); // reserved, no reallocation
+
+    Graph copy = g;
+    copy.setEdgeWeight(0, 1, 10);
+    REQUIRE(g.edgeWeight(0, 1) == 3);
+    REQUIRE(copy.edgeWeight(0, 1) == 10);
+    REQUIRE(copy.hasNegativeEdges());
+    REQUIRE(copy.getEdgeCount() == 4);
+
+    // moving keeps the lists (and their arena) in place
+    Graph moved = std::move(g);
+    REQUIRE(moved.getAdjList()[0].data() == firstList);
+    Graph assigned(0);
+    assigned = std::move(moved);
+    REQUIRE(assigned.getAdjList()[0].data() == firstList);
+    REQUIRE(assigned.edgeWeight(3, 0) == 1);
+    // moved-from graphs are empty, not dangling
+    REQUIRE(g.getSize() == 0);
+    REQUIRE(moved.getSize() == 0);
+    REQUIRE(moved.getEdgeCount() == 0);
+    REQUIRE(moved.getAdjList().empty());
+    REQUIRE(moved.degrees().empty());
+    REQUIRE(moved.edgeWeight(0, 1) == INT_MAX);
+    REQUIRE_FALSE(moved.removeEdge(0, 1));
+    REQUIRE(Graph(moved).getSize() == 0);
+    moved = copy;
+    REQUIRE(moved.edgeWeight(0, 1) == 10);
+    assigned = copy;
+    REQUIRE(assigned.edgeWeight(0, 1) == 10);
+    assigned.addEdge(2, 3, 7); // beyond the reserved degrees the list just grows
+    REQUIRE(assigned.edgeWeight(2, 3) == 7);
+    REQUIRE(assigned.edgeWeight(0, 2) == -1);
+    REQUIRE(assigned.getEdgeCount() == 5);
+}
+
+TEST_CASE("Graph - growing past the reserved degrees keeps every edge", "[graph-arena]") {
+    Graph g(4, {1, 1, 1, 1});
+    for (int v = 0; v < 4; v++) g.addEdge(v, (v + 1) % 4, v);
+    // the first full list moves all lists out of the arena, later ones grow in place
+    for (int i = 0; i < 100; i++) g.addEdge(i % 4, (i + 2) % 4, 10 + i);
+    REQUIRE(g.degrees() == vector<int>{26, 26, 26, 26});
+    for (int v = 0; v < 4; v++) REQUIRE(g.edgeWeight(v, (v + 1) % 4) == v);
+    REQUIRE(g.edgeWeight(1, 3) == 11);
+    for (int i = 0; i < 100; i++) REQUIRE(g.removeEdge(i % 4, (i + 2) % 4));
+    REQUIRE(g.getEdgeCount() == 4);
+    REQUIRE(g.getMaxWeight() == 3);
+}
+
+TEST_CASE("Dynamic - repairs match full recomputation", "[dynamic]") {
+    GeneratorOptions options;
+    options.type = "grid";
+    options.rows = 12;
+    options.cols = 12;
+    options.minWeight = 0; // zero weights included
+    options.maxWeight = 9;
+    options.seed = 4;
+    Graph g = GraphGenerator::generateGraph(options);
+    DynamicShortestPaths dynamic(g, 5);
+    REQUIRE(dynamic.isValid());
+
+    mt19937_64 rng(99);
+    SearchWorkspace workspace;
+    for (int step = 0; step < 300; step++) {
+        int u = rng() % g.getSize();
+        int kind = rng() % 3;
+        if (kind == 0) {
+            REQUIRE(dynamic.insertEdge(u, rng() % g.getSize(), rng() % 10));
+        } else if (!g.getAdjList()[u].empty()) {
+            int v = g.getAdjList()[u][rng() % g.getAdjList()[u].size()].to;
+            if (kind == 1) REQUIRE(dynamic.deleteEdge(u, v));
+            else REQUIRE(dynamic.changeWeight(u, v, rng() % 10));
+        }
+        Dijkstra::query(g, 5, -1, workspace);
+        for (int v = 0; v < g.getSize(); v++) {
+            REQUIRE(dynamic.distance(v) == workspace.distance(v));
+            // tree edges exist and are tight
+            if (dynamic.parent(v) != -1)
+                REQUIRE(dynamic.distance(dynamic.parent(v)) + g.edgeWeight(dynamic.parent(v), v) == dynamic.distance(v));
+        }
+    }
+    REQUIRE_FALSE(dynamic.changeWeight(0, 1, -1));
+    REQUIRE(dynamic.pathTo(5) == vector<int>{5});
+}